@@ -1,6 +1,11 @@
+#include <unordered_set>
+#include <vector>
+
 #include "CryCommon/CrySystem/ISystem.h"
 #include "CryCommon/CrySystem/IConsole.h"
 #include "CryCommon/CryScriptSystem/IScriptSystem.h"
+#include "CryScriptSystem/ScriptSystem.h"
+#include "CryScriptSystem/LuaLibs/bufferlib.h"
 #include "Library/Util.h"
 #include "Library/WinAPI.h"
 
@@ -10,6 +15,139 @@
 #include "ScriptCommands.h"
 #include "ScriptCallbacks.h"
 
+namespace
+{
+	// hook names are table keys, usually strings or numbers
+	void AppendHookName(std::string & name, IFunctionHandler *pH, int index)
+	{
+		switch (pH->GetParamType(index))
+		{
+			case svtString:
+			{
+				const char *value = "";
+				pH->GetParam(index, value);
+				name += value;
+				break;
+			}
+			case svtNumber:
+			{
+				float value = 0;
+				pH->GetParam(index, value);
+
+				char buffer[32];
+				sprintf(buffer, "%g", value);
+				name += buffer;
+				break;
+			}
+			default:
+			{
+				name += '?';
+				break;
+			}
+		}
+	}
+
+	const char *ReadRequestParams(IScriptTable *params, HTTPClientRequest & request)
+	{
+		const char *url;
+		if (params->GetValue("url", url))
+			request.url = url;
+		else
+			return "url not provided";
+
+		const char *method;
+		if (params->GetValue("method", method))
+			request.method = method;
+
+		const char *body;
+		if (params->GetValue("body", body))
+			request.data = body;
+
+		int timeout;
+		if (params->GetValue("timeout", timeout))
+			request.timeout = timeout;
+
+		SmartScriptTable headersTable;
+		if (params->GetValue("headers", headersTable))
+		{
+			auto it = headersTable->BeginIteration();
+			while (headersTable->MoveNext(it))
+			{
+				if (it.value.GetVarType() == ScriptVarType::svtString)
+				{
+					request.headers[it.sKey] = it.value.str;
+				}
+			}
+			headersTable->EndIteration(it);
+		}
+
+		return nullptr;
+	}
+
+	// "buffer = true" passes the response as a buffer instead of copying it into a Lua string
+	bool IsBufferRequested(IScriptTable *params)
+	{
+		bool isBuffer = false;
+		params->GetValue("buffer", isBuffer);
+
+		return isBuffer;
+	}
+
+	std::shared_ptr<const std::string> MakeResponseBuffer(HTTPClientResult & result)
+	{
+		return std::make_shared<const std::string>(std::move(result.response));
+	}
+
+	ScriptScheduler *GetScriptScheduler()
+	{
+		return static_cast<CScriptSystem*>(gEnv->pScriptSystem)->GetScriptScheduler();
+	}
+
+	// resumes the waiting coroutine with the same values as the callback of CPPAPI.Request
+	void CompleteRequest(ScriptWaitID waitID, int index, HTTPClientResult & result, bool isBuffer)
+	{
+		GetScriptScheduler()->Complete(waitID, index, [&result, isBuffer](lua_State *L) -> int
+		{
+			if (result.error)
+				lua_pushstring(L, result.error.what());
+			else
+				lua_pushboolean(L, false);
+
+			if (isBuffer)
+				lua_pushbuffer(L, MakeResponseBuffer(result));
+			else
+				lua_pushlstring(L, result.response.data(), result.response.length());
+
+			lua_pushnumber(L, result.code);
+
+			return 3;
+		});
+	}
+
+	// a request that fails before it is sent has the same shape as a completed one: error, response, code
+	SmartScriptTable MakeFailedResult(IScriptSystem *pSS, const char *error)
+	{
+		SmartScriptTable result(pSS);
+		result->SetAt(1, error);
+		result->SetAt(2, "");
+		result->SetAt(3, 0);
+
+		return result;
+	}
+
+	SmartScriptTable MakeFailedResults(IScriptSystem *pSS, int count, const char *error)
+	{
+		SmartScriptTable results(pSS);
+
+		for (int i = 0; i < count; i++)
+		{
+			results->SetAt(i + 1, MakeFailedResult(pSS, error));
+		}
+
+		return results;
+	}
+}
+
 ScriptBind_CPPAPI::ScriptBind_CPPAPI()
 {
 	Init(gEnv->pScriptSystem, gEnv->pSystem);
@@ -22,10 +160,15 @@ ScriptBind_CPPAPI::ScriptBind_CPPAPI()
 	SCRIPT_REG_GLOBAL(SCRIPT_CALLBACK_ON_UPDATE);
 	SCRIPT_REG_GLOBAL(SCRIPT_CALLBACK_ON_DISCONNECT);
 	SCRIPT_REG_GLOBAL(SCRIPT_CALLBACK_ON_SPAWN);
+	SCRIPT_REG_GLOBAL(SCRIPT_CALLBACK_ON_SPAWN_BATCH);
 
 	SCRIPT_REG_TEMPLFUNC(AddCCommand, "name, handler");
 	SCRIPT_REG_TEMPLFUNC(ApplyMaskAll, "mask, apply");
 	SCRIPT_REG_TEMPLFUNC(ApplyMaskOne, "entity, mask, apply");
+	SCRIPT_REG_TEMPLFUNC(AwaitRequest, "params");
+	SCRIPT_REG_TEMPLFUNC(AwaitRequests, "paramsList");
+	SCRIPT_REG_FUNC(BeginHook);
+	SCRIPT_REG_TEMPLFUNC(EndHook, "");
 	SCRIPT_REG_TEMPLFUNC(FSetCVar, "cvar, value");
 	SCRIPT_REG_TEMPLFUNC(GetLocaleInformation, "");
 	SCRIPT_REG_TEMPLFUNC(GetMapName, "");
@@ -33,6 +176,7 @@ ScriptBind_CPPAPI::ScriptBind_CPPAPI()
 	SCRIPT_REG_TEMPLFUNC(Random, "");
 	SCRIPT_REG_TEMPLFUNC(Request, "params, callback");
 	SCRIPT_REG_TEMPLFUNC(SetCallback, "callback, handler");
+	SCRIPT_REG_FUNC(SetSpawnFilter);
 	SCRIPT_REG_TEMPLFUNC(SHA256, "text");
 	SCRIPT_REG_TEMPLFUNC(URLEncode, "text");
 }
@@ -62,6 +206,110 @@ int ScriptBind_CPPAPI::ApplyMaskOne(IFunctionHandler *pH, ScriptHandle entity, i
 	return pH->EndFunction();
 }
 
+int ScriptBind_CPPAPI::AwaitRequest(IFunctionHandler *pH, SmartScriptTable params)
+{
+	HTTPClientRequest request;
+
+	if (const char *error = ReadRequestParams(params, request))
+		return pH->EndFunction(error, "", 0);
+
+	const bool isBuffer = IsBufferRequested(params);
+
+	ScriptScheduler *pScheduler = GetScriptScheduler();
+
+	const ScriptWaitID waitID = pScheduler->Suspend(pH);
+	if (!waitID)
+		return pH->EndFunction("not called from a coroutine", "", 0);
+
+	request.callback = [waitID, isBuffer](HTTPClientResult & result)
+	{
+		CompleteRequest(waitID, 0, result, isBuffer);
+	};
+
+	gClient->GetHTTPClient()->Request(std::move(request));
+
+	return pScheduler->YieldCoroutine(pH);
+}
+
+int ScriptBind_CPPAPI::AwaitRequests(IFunctionHandler *pH, SmartScriptTable paramsList)
+{
+	const int count = paramsList->Count();
+
+	std::vector<HTTPClientRequest> requests(count);
+	std::vector<bool> isBuffer(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		SmartScriptTable params;
+		if (!paramsList->GetAt(i + 1, params))
+			return pH->EndFunction(MakeFailedResults(m_pSS, count, "invalid request params"));
+
+		if (const char *error = ReadRequestParams(params, requests[i]))
+			return pH->EndFunction(MakeFailedResults(m_pSS, count, error));
+
+		isBuffer[i] = IsBufferRequested(params);
+	}
+
+	if (count == 0)
+		return pH->EndFunction(SmartScriptTable(m_pSS));
+
+	ScriptScheduler *pScheduler = GetScriptScheduler();
+
+	const ScriptWaitID waitID = pScheduler->SuspendAll(pH, count);
+	if (!waitID)
+		return pH->EndFunction(MakeFailedResults(m_pSS, count, "not called from a coroutine"));
+
+	// all requests run in parallel and the coroutine is resumed once the last one completes
+	for (int i = 0; i < count; i++)
+	{
+		requests[i].callback = [waitID, i, isBuffer = isBuffer[i]](HTTPClientResult & result)
+		{
+			CompleteRequest(waitID, i, result, isBuffer);
+		};
+
+		gClient->GetHTTPClient()->Request(std::move(requests[i]));
+	}
+
+	return pScheduler->YieldCoroutine(pH);
+}
+
+// CPPAPI.BeginHook(type, name, [subName])
+int ScriptBind_CPPAPI::BeginHook(IFunctionHandler *pH)
+{
+	ScriptCallbacks *pCallbacks = gClient->GetScriptCallbacks();
+
+	// nothing is formatted unless hooks are measured
+	if (!pCallbacks->IsMeasuringHooks())
+	{
+		pCallbacks->BeginUnmeasuredHook();
+
+		return pH->EndFunction();
+	}
+
+	std::string name;
+
+	const int paramCount = pH->GetParamCount();
+
+	for (int i = 1; i <= paramCount; i++)
+	{
+		if (i > 1)
+			name += (i == 2) ? ':' : '.';
+
+		AppendHookName(name, pH, i);
+	}
+
+	pCallbacks->BeginHook(std::move(name));
+
+	return pH->EndFunction();
+}
+
+int ScriptBind_CPPAPI::EndHook(IFunctionHandler *pH)
+{
+	gClient->GetScriptCallbacks()->EndHook();
+
+	return pH->EndFunction();
+}
+
 int ScriptBind_CPPAPI::FSetCVar(IFunctionHandler *pH, const char *cvar, const char *value)
 {
 	bool success = false;
@@ -99,39 +347,12 @@ int ScriptBind_CPPAPI::Request(IFunctionHandler *pH, SmartScriptTable params, HS
 {
 	HTTPClientRequest request;
 
-	const char *url;
-	if (params->GetValue("url", url))
-		request.url = url;
-	else
-		return pH->EndFunction(false, "url not provided");
-
-	const char *method;
-	if (params->GetValue("method", method))
-		request.method = method;
-
-	const char *body;
-	if (params->GetValue("body", body))
-		request.data = body;
+	if (const char *error = ReadRequestParams(params, request))
+		return pH->EndFunction(false, error);
 
-	int timeout;
-	if (params->GetValue("timeout", timeout))
-		request.timeout = timeout;
+	const bool isBuffer = IsBufferRequested(params);
 
-	SmartScriptTable headersTable;
-	if (params->GetValue("headers", headersTable))
-	{
-		auto it = headersTable->BeginIteration();
-		while (headersTable->MoveNext(it))
-		{
-			if (it.value.GetVarType() == ScriptVarType::svtString)
-			{
-				request.headers[it.sKey] = it.value.str;
-			}
-		}
-		headersTable->EndIteration(it);
-	}
-
-	request.callback = [callback, this](HTTPClientResult & result)
+	request.callback = [callback, isBuffer, this](HTTPClientResult & result)
 	{
 		if (m_pSS->BeginCall(callback))
 		{
@@ -140,7 +361,11 @@ int ScriptBind_CPPAPI::Request(IFunctionHandler *pH, SmartScriptTable params, HS
 			else
 				m_pSS->PushFuncParam(false);
 
-			m_pSS->PushFuncParam(result.response.c_str());
+			if (isBuffer)
+				static_cast<CScriptSystem*>(m_pSS)->PushFuncParamBuffer(MakeResponseBuffer(result));
+			else
+				m_pSS->PushFuncParam(result.response.c_str());
+
 			m_pSS->PushFuncParam(result.code);
 			m_pSS->EndCall();
 		}
@@ -158,6 +383,34 @@ int ScriptBind_CPPAPI::SetCallback(IFunctionHandler *pH, int callback, HSCRIPTFU
 	return pH->EndFunction(success);
 }
 
+// CPPAPI.SetSpawnFilter([classNames]), "*" means all classes, nil means none
+int ScriptBind_CPPAPI::SetSpawnFilter(IFunctionHandler *pH)
+{
+	SmartScriptTable classNames;
+
+	if (pH->GetParamType(1) != svtObject || !pH->GetParam(1, classNames))
+	{
+		gClient->GetScriptCallbacks()->ResetSpawnFilter();
+
+		return pH->EndFunction();
+	}
+
+	std::unordered_set<std::string> filter;
+
+	const int count = classNames->Count();
+
+	for (int i = 0; i < count; i++)
+	{
+		const char *className;
+		if (classNames->GetAt(i + 1, className))
+			filter.emplace(className);
+	}
+
+	gClient->GetScriptCallbacks()->SetSpawnFilter(std::move(filter));
+
+	return pH->EndFunction();
+}
+
 int ScriptBind_CPPAPI::SHA256(IFunctionHandler *pH, const char *text)
 {
 	return pH->EndFunction(Util::SHA256(text).c_str());
@@ -11,6 +11,10 @@ public:
 	int AddCCommand(IFunctionHandler *pH, const char *name, HSCRIPTFUNCTION handler);
 	int ApplyMaskAll(IFunctionHandler *pH, int mask, bool apply);
 	int ApplyMaskOne(IFunctionHandler *pH, ScriptHandle entity, int mask, bool apply);
+	int AwaitRequest(IFunctionHandler *pH, SmartScriptTable params);
+	int AwaitRequests(IFunctionHandler *pH, SmartScriptTable paramsList);
+	int BeginHook(IFunctionHandler *pH);
+	int EndHook(IFunctionHandler *pH);
 	int FSetCVar(IFunctionHandler *pH, const char *cvar, const char *value);
 	int GetLocaleInformation(IFunctionHandler *pH);
 	int GetMapName(IFunctionHandler *pH);
@@ -18,6 +22,7 @@ public:
 	int Random(IFunctionHandler *pH);
 	int Request(IFunctionHandler *pH, SmartScriptTable params, HSCRIPTFUNCTION callback);
 	int SetCallback(IFunctionHandler *pH, int callback, HSCRIPTFUNCTION handler);
+	int SetSpawnFilter(IFunctionHandler *pH);
 	int SHA256(IFunctionHandler *pH, const char *text);
 	int URLEncode(IFunctionHandler *pH, const char *text);
 };
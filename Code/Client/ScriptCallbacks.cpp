@@ -1,11 +1,265 @@
+#include <algorithm>
+
 #include "CryCommon/CrySystem/ISystem.h"
+#include "CryCommon/CrySystem/IConsole.h"
+#include "CryCommon/CrySystem/ITimer.h"
 #include "CryCommon/CryEntitySystem/IEntity.h"
+#include "CryCommon/CryEntitySystem/IEntitySystem.h"
+#include "CryCommon/CryRenderer/IRenderer.h"
+#include "CryScriptSystem/ScriptSystem.h"
 
 #include "ScriptCallbacks.h"
+#include "Client.h"
+
+namespace
+{
+	// upper bounds of histogram buckets in milliseconds, the last bucket is everything above
+	constexpr std::array<float, 7> HISTOGRAM_BOUNDS = { 0.01f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f, 5.0f };
+	constexpr size_t HISTOGRAM_SIZE = HISTOGRAM_BOUNDS.size() + 1;
+
+	// hook names come from Lua, including server RPC methods, so new names beyond this are not measured
+	constexpr size_t MAX_HOOK_COSTS = 256;
+
+	struct CostSummary
+	{
+		float avgMs = 0;
+		float p95Ms = 0;
+		float maxMs = 0;
+		float avgAllocBytes = 0;
+		std::array<unsigned int, HISTOGRAM_SIZE> histogram = {};
+	};
+
+	CostSummary Summarize(const ScriptCost & cost)
+	{
+		CostSummary summary;
+
+		if (cost.sampleCount == 0)
+			return summary;
+
+		std::array<float, ScriptCost::WINDOW_SIZE> sorted;
+		double totalMs = 0;
+		double totalAllocBytes = 0;
+
+		for (unsigned int i = 0; i < cost.sampleCount; i++)
+		{
+			const float ms = cost.timeMs[i];
+
+			sorted[i] = ms;
+			totalMs += ms;
+			totalAllocBytes += cost.allocBytes[i];
+
+			const auto it = std::lower_bound(HISTOGRAM_BOUNDS.begin(), HISTOGRAM_BOUNDS.end(), ms);
+			summary.histogram[it - HISTOGRAM_BOUNDS.begin()]++;
+		}
+
+		std::sort(sorted.begin(), sorted.begin() + cost.sampleCount);
+
+		summary.avgMs = static_cast<float>(totalMs / cost.sampleCount);
+		summary.p95Ms = sorted[(cost.sampleCount * 95) / 100];
+		summary.maxMs = sorted[cost.sampleCount - 1];
+		summary.avgAllocBytes = static_cast<float>(totalAllocBytes / cost.sampleCount);
+
+		return summary;
+	}
+
+	void LogCost(const char *name, const ScriptCost & cost)
+	{
+		const CostSummary summary = Summarize(cost);
+
+		CryLogAlways("%-32s %8llu %8.3f %8.3f %8.3f %10.0f %6llu  [%u %u %u %u %u %u %u %u]",
+		             name, cost.callCount, summary.avgMs, summary.p95Ms, summary.maxMs,
+		             summary.avgAllocBytes, cost.overBudgetCount,
+		             summary.histogram[0], summary.histogram[1], summary.histogram[2], summary.histogram[3],
+		             summary.histogram[4], summary.histogram[5], summary.histogram[6], summary.histogram[7]);
+	}
+
+	uint64_t GetLuaAllocatedBytes()
+	{
+		return static_cast<CScriptSystem*>(gEnv->pScriptSystem)->GetScriptProfiler()->GetAllocatedBytes();
+	}
+}
+
+ScriptCallbacks::Measurement ScriptCallbacks::BeginMeasure()
+{
+	Measurement measurement;
+	measurement.startTime = Clock::now();
+	measurement.startAllocBytes = GetLuaAllocatedBytes();
+
+	return measurement;
+}
+
+void ScriptCallbacks::EndMeasure(ScriptCost & cost, const Measurement & measurement, const char *name)
+{
+	const std::chrono::duration<float, std::milli> duration = Clock::now() - measurement.startTime;
+	const uint64_t allocBytes = GetLuaAllocatedBytes() - measurement.startAllocBytes;
+
+	cost.Add(duration.count(), static_cast<uint32_t>(std::min<uint64_t>(allocBytes, UINT32_MAX)));
+
+	const float budget = m_pBudgetCVar->GetFVal();
+
+	if (budget > 0 && duration.count() > budget)
+	{
+		cost.overBudgetCount++;
+
+		// at most one warning per second for each callback or hook
+		const float currentTime = gEnv->pTimer->GetAsyncCurTime();
+
+		if (currentTime - cost.lastWarningTime >= 1.0f)
+		{
+			cost.lastWarningTime = currentTime;
+
+			CryLogWarningAlways("[ScriptCallbacks] %s took %.3f ms and allocated %llu bytes, budget is %.3f ms",
+			                    name, duration.count(), allocBytes, budget);
+		}
+	}
+}
+
+bool ScriptCallbacks::IsSpawnClassAccepted(const IEntityClass *pClass)
+{
+	if (m_spawnFilter.empty())
+	{
+		return false;
+	}
+
+	const auto it = m_spawnFilterCache.find(pClass);
+	if (it != m_spawnFilterCache.end())
+	{
+		return it->second;
+	}
+
+	const bool isAccepted = m_spawnFilter.count("*") || (pClass && m_spawnFilter.count(pClass->GetName()));
+
+	m_spawnFilterCache[pClass] = isAccepted;
+
+	return isAccepted;
+}
+
+void ScriptCallbacks::FlushSpawns()
+{
+	if (m_pendingSpawns.empty())
+	{
+		return;
+	}
+
+	if (!m_handlers[SCRIPT_CALLBACK_ON_SPAWN_BATCH])
+	{
+		m_pendingSpawns.clear();
+		return;
+	}
+
+	IEntitySystem *pEntitySystem = gEnv->pEntitySystem;
+
+	SmartScriptTable entities(m_pSS);
+	int count = 0;
+
+	for (EntityId id : m_pendingSpawns)
+	{
+		// skip entities removed in the same frame, such as short-lived projectiles
+		if (pEntitySystem->GetEntity(id))
+		{
+			ScriptHandle entityId;
+			entityId.n = id;
+
+			entities->SetAt(++count, entityId);
+		}
+	}
+
+	m_pendingSpawns.clear();
+
+	if (count > 0)
+	{
+		Call(SCRIPT_CALLBACK_ON_SPAWN_BATCH, entities);
+	}
+}
+
+void ScriptCallbacks::LogCosts()
+{
+	CryLogAlways("Last %u calls, histogram of ms: <=0.01 <=0.05 <=0.1 <=0.25 <=0.5 <=1 <=5 >5", ScriptCost::WINDOW_SIZE);
+	CryLogAlways("%-32s %8s %8s %8s %8s %10s %6s  %s",
+	             "Name", "Calls", "Avg ms", "P95 ms", "Max ms", "Avg bytes", "Over", "Histogram");
+
+	for (int i = 0; i < SCRIPT_CALLBACK_COUNT; i++)
+	{
+		LogCost(GetCallbackName(static_cast<EScriptCallback>(i)), m_callbackCosts[i]);
+	}
+
+	for (const auto & [name, cost] : m_hookCosts)
+	{
+		LogCost(name.c_str(), cost);
+	}
+}
+
+void ScriptCallbacks::DrawCosts()
+{
+	IRenderer *pRenderer = gEnv->pRenderer;
+	if (!pRenderer)
+		return;
+
+	std::vector<std::pair<const char*, CostSummary>> lines;
+
+	for (int i = 0; i < SCRIPT_CALLBACK_COUNT; i++)
+	{
+		lines.emplace_back(GetCallbackName(static_cast<EScriptCallback>(i)), Summarize(m_callbackCosts[i]));
+	}
+
+	const size_t callbackCount = lines.size();
+
+	for (const auto & [name, cost] : m_hookCosts)
+	{
+		lines.emplace_back(name.c_str(), Summarize(cost));
+	}
+
+	// most expensive hooks first
+	std::sort(lines.begin() + callbackCount, lines.end(), [](const auto & a, const auto & b)
+	{
+		return a.second.avgMs > b.second.avgMs;
+	});
+
+	const size_t maxLines = callbackCount + 16;
+
+	if (lines.size() > maxLines)
+		lines.resize(maxLines);
+
+	float white[4] = { 1, 1, 1, 1 };
+	float red[4] = { 1, 0.3f, 0.3f, 1 };
+
+	const float budget = m_pBudgetCVar->GetFVal();
+
+	float y = 60;
+
+	pRenderer->Draw2dLabel(10, y, 1.3f, white, false, "Script callbacks: avg / p95 / max ms, avg bytes");
+
+	for (const auto & [name, summary] : lines)
+	{
+		y += 14;
+
+		const bool isOverBudget = budget > 0 && summary.maxMs > budget;
+
+		pRenderer->Draw2dLabel(10, y, 1.2f, isOverBudget ? red : white, false, "%-32s %7.3f %7.3f %7.3f %8.0f",
+		                       name, summary.avgMs, summary.p95Ms, summary.maxMs, summary.avgAllocBytes);
+	}
+}
+
+void ScriptCallbacks::OnCostsCmd(IConsoleCmdArgs *pArgs)
+{
+	gClient->GetScriptCallbacks()->LogCosts();
+}
 
 ScriptCallbacks::ScriptCallbacks()
 {
 	m_pSS = gEnv->pScriptSystem;
+
+	IConsole *pConsole = gEnv->pConsole;
+
+	m_pHooksCVar = pConsole->RegisterInt("cl_script_costs_hooks", 0, VF_NOT_NET_SYNCED,
+	                                     "Measures each Lua hook and RPC method separately, they are listed by cl_script_costs.");
+	m_pOverlayCVar = pConsole->RegisterInt("cl_script_costs_overlay", 0, VF_NOT_NET_SYNCED,
+	                                       "Shows cost of script callbacks and hooks on screen.");
+	m_pBudgetCVar = pConsole->RegisterFloat("cl_script_costs_budget", 0, VF_NOT_NET_SYNCED,
+	                                        "Logs script callbacks and hooks taking longer than this many milliseconds, 0 = disabled.");
+
+	pConsole->AddCommand("cl_script_costs", OnCostsCmd, VF_NOT_NET_SYNCED,
+	                     "Logs time and Lua allocations of recent script callbacks and hooks.");
 }
 
 ScriptCallbacks::~ScriptCallbacks()
@@ -33,18 +287,113 @@ bool ScriptCallbacks::SetHandler(EScriptCallback callback, HSCRIPTFUNCTION handl
 
 void ScriptCallbacks::OnUpdate(float deltaTime)
 {
+	FlushSpawns();
+
 	Call(SCRIPT_CALLBACK_ON_UPDATE, deltaTime);
+
+	if (m_pOverlayCVar->GetIVal())
+	{
+		DrawCosts();
+	}
 }
 
 void ScriptCallbacks::OnDisconnect(int reason, const char *message)
 {
+	m_pendingSpawns.clear();
+
+	// hooks of the server mod are gone
+	m_hookCosts.clear();
+
 	Call(SCRIPT_CALLBACK_ON_DISCONNECT, reason, message);
 }
 
 void ScriptCallbacks::OnSpawn(IEntity *pEntity)
 {
-	ScriptHandle entityId;
-	entityId.n = pEntity->GetId();
+	if (m_handlers[SCRIPT_CALLBACK_ON_SPAWN])
+	{
+		ScriptHandle entityId;
+		entityId.n = pEntity->GetId();
+
+		Call(SCRIPT_CALLBACK_ON_SPAWN, entityId);
+	}
+
+	if (m_handlers[SCRIPT_CALLBACK_ON_SPAWN_BATCH] && IsSpawnClassAccepted(pEntity->GetClass()))
+	{
+		m_pendingSpawns.push_back(pEntity->GetId());
+	}
+}
+
+void ScriptCallbacks::SetSpawnFilter(std::unordered_set<std::string> && classNames)
+{
+	m_spawnFilter = std::move(classNames);
+	m_spawnFilterCache.clear();
+}
+
+void ScriptCallbacks::ResetSpawnFilter()
+{
+	m_spawnFilter.clear();
+	m_spawnFilterCache.clear();
+}
+
+bool ScriptCallbacks::IsMeasuringHooks() const
+{
+	return m_pHooksCVar->GetIVal() != 0;
+}
+
+void ScriptCallbacks::BeginHook(std::string && name)
+{
+	HookMeasurement & hook = m_hookStack.emplace_back();
+
+	hook.name = std::move(name);
+	hook.isMeasured = true;
+
+	// start measuring after the name is built
+	hook.measurement = BeginMeasure();
+}
+
+void ScriptCallbacks::BeginUnmeasuredHook()
+{
+	// keeps the nesting intact when measuring is enabled inside a hook
+	m_hookStack.emplace_back();
+}
+
+void ScriptCallbacks::EndHook()
+{
+	if (m_hookStack.empty())
+	{
+		return;
+	}
+
+	const HookMeasurement & hook = m_hookStack.back();
+
+	if (hook.isMeasured)
+	{
+		auto it = m_hookCosts.find(hook.name);
+
+		if (it == m_hookCosts.end() && m_hookCosts.size() < MAX_HOOK_COSTS)
+		{
+			it = m_hookCosts.emplace(hook.name, ScriptCost()).first;
+		}
+
+		if (it != m_hookCosts.end())
+		{
+			EndMeasure(it->second, hook.measurement, hook.name.c_str());
+		}
+	}
+
+	m_hookStack.pop_back();
+}
+
+const char *ScriptCallbacks::GetCallbackName(EScriptCallback callback)
+{
+	switch (callback)
+	{
+		case SCRIPT_CALLBACK_ON_UPDATE:     return "OnUpdate";
+		case SCRIPT_CALLBACK_ON_DISCONNECT: return "OnDisconnect";
+		case SCRIPT_CALLBACK_ON_SPAWN:      return "OnSpawn";
+		case SCRIPT_CALLBACK_ON_SPAWN_BATCH: return "OnSpawnBatch";
+		case SCRIPT_CALLBACK_COUNT:         break;
+	}
 
-	Call(SCRIPT_CALLBACK_ON_SPAWN, entityId);
+	return "?";
 }
@@ -1,26 +1,103 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "CryCommon/CryScriptSystem/IScriptSystem.h"
+#include "CryCommon/CryEntitySystem/IEntity.h"
 
-struct IEntity;
+struct IEntityClass;
+struct ICVar;
+struct IConsoleCmdArgs;
 
 enum EScriptCallback
 {
 	SCRIPT_CALLBACK_ON_UPDATE,
 	SCRIPT_CALLBACK_ON_DISCONNECT,
 	SCRIPT_CALLBACK_ON_SPAWN,
+	SCRIPT_CALLBACK_ON_SPAWN_BATCH,
 
 	// must be last
 	SCRIPT_CALLBACK_COUNT
 };
 
+// rolling window of the last calls of a callback or a hook
+struct ScriptCost
+{
+	static constexpr unsigned int WINDOW_SIZE = 128;
+
+	std::array<float, WINDOW_SIZE> timeMs = {};
+	std::array<uint32_t, WINDOW_SIZE> allocBytes = {};
+	unsigned int sampleCount = 0;
+	unsigned int nextSample = 0;
+	uint64_t callCount = 0;
+	uint64_t overBudgetCount = 0;
+	float lastWarningTime = 0;
+
+	void Add(float ms, uint32_t bytes)
+	{
+		timeMs[nextSample] = ms;
+		allocBytes[nextSample] = bytes;
+
+		nextSample = (nextSample + 1) % WINDOW_SIZE;
+
+		if (sampleCount < WINDOW_SIZE)
+			sampleCount++;
+
+		callCount++;
+	}
+};
+
 class ScriptCallbacks
 {
+	using Clock = std::chrono::steady_clock;
+
+	struct Measurement
+	{
+		Clock::time_point startTime;
+		uint64_t startAllocBytes = 0;
+	};
+
+	struct HookMeasurement
+	{
+		Measurement measurement;
+		std::string name;
+		bool isMeasured = false;
+	};
+
 	IScriptSystem *m_pSS = nullptr;
 	std::array<HSCRIPTFUNCTION, SCRIPT_CALLBACK_COUNT> m_handlers = {};
 
+	std::array<ScriptCost, SCRIPT_CALLBACK_COUNT> m_callbackCosts;
+	std::map<std::string, ScriptCost> m_hookCosts;
+	std::vector<HookMeasurement> m_hookStack;
+
+	// entity classes delivered to the spawn batch callback, "*" means all classes
+	std::unordered_set<std::string> m_spawnFilter;
+	// filter verdict for each class, so the class name is looked up only once
+	std::unordered_map<const IEntityClass*, bool> m_spawnFilterCache;
+	std::vector<EntityId> m_pendingSpawns;
+
+	ICVar *m_pHooksCVar = nullptr;
+	ICVar *m_pOverlayCVar = nullptr;
+	ICVar *m_pBudgetCVar = nullptr;
+
+	Measurement BeginMeasure();
+	void EndMeasure(ScriptCost & cost, const Measurement & measurement, const char *name);
+
+	bool IsSpawnClassAccepted(const IEntityClass *pClass);
+	void FlushSpawns();
+
+	void LogCosts();
+	void DrawCosts();
+
+	static void OnCostsCmd(IConsoleCmdArgs *pArgs);
+
 	template<class... Params>
 	void Call(EScriptCallback callback, const Params &... params)
 	{
@@ -29,7 +106,10 @@ class ScriptCallbacks
 		if (handler && m_pSS->BeginCall(handler))
 		{
 			(m_pSS->PushFuncParam(params), ...);
+
+			const Measurement measurement = BeginMeasure();
 			m_pSS->EndCall();
+			EndMeasure(m_callbackCosts[callback], measurement, GetCallbackName(callback));
 		}
 	}
 
@@ -42,4 +122,19 @@ public:
 	void OnUpdate(float deltaTime);
 	void OnDisconnect(int reason, const char *message);
 	void OnSpawn(IEntity *pEntity);
+
+	// spawned entities matching the filter are passed to the spawn batch callback as one table per frame
+	// without a filter no entities are passed
+	// the spawn callback still gets every entity immediately
+	void SetSpawnFilter(std::unordered_set<std::string> && classNames);
+	void ResetSpawnFilter();
+
+	// hooks registered in Lua, can be nested
+	// every BeginHook or BeginUnmeasuredHook must be followed by EndHook
+	bool IsMeasuringHooks() const;
+	void BeginHook(std::string && name);
+	void BeginUnmeasuredHook();
+	void EndHook();
+
+	static const char *GetCallbackName(EScriptCallback callback);
 };
@@ -1,6 +1,35 @@
+#include <algorithm>
+
+#include "CryCommon/CryCore/PoolAllocator.h"
+
 #include "ClientSynchedStorage.h"
 #include "ServerSynchedStorage.h"
 
+namespace
+{
+	constexpr size_t SET_MSG_SIZE = std::max({
+		sizeof (CClientSynchedStorage::CSetGlobalMsg),
+		sizeof (CClientSynchedStorage::CSetChannelMsg),
+		sizeof (CClientSynchedStorage::CSetEntityMsg)
+	});
+
+	// set messages are created in the main thread and released in the network thread
+	stl::PoolAllocator<SET_MSG_SIZE, stl::PoolAllocatorSynchronizationMultithreaded> g_setMsgPool;
+
+	void *AllocateSetMsg(size_t size)
+	{
+		return (size <= SET_MSG_SIZE) ? g_setMsgPool.Allocate() : ::operator new(size);
+	}
+
+	void DeallocateSetMsg(void *pObject, size_t size)
+	{
+		if (size <= SET_MSG_SIZE)
+			g_setMsgPool.Deallocate(pObject);
+		else
+			::operator delete(pObject);
+	}
+}
+
 void CClientSynchedStorage::DefineProtocol(IProtocolBuilder *pBuilder)
 {
 	pBuilder->AddMessageSink(this, CServerSynchedStorage::GetProtocolDef(), CClientSynchedStorage::GetProtocolDef());
@@ -97,8 +126,13 @@ EMessageSendResult CClientSynchedStorage::CSetGlobalMsg::WritePayload(TSerialize
 	return eMSR_SentOk;
 }
 
-void CClientSynchedStorage::CSetGlobalMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+void CClientSynchedStorage::CSetGlobalMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate update)
 {
+	// requeued messages are sent again by the network
+	if (update != eNSSU_Requeue)
+	{
+		m_pStorage->OnSetGlobalMsgComplete(this, channelId, fromSeq, update == eNSSU_Ack);
+	}
 }
 
 size_t CClientSynchedStorage::CSetGlobalMsg::GetSize()
@@ -106,6 +140,16 @@ size_t CClientSynchedStorage::CSetGlobalMsg::GetSize()
 	return sizeof (*this);
 };
 
+void *CClientSynchedStorage::CSetGlobalMsg::operator new(size_t size)
+{
+	return AllocateSetMsg(size);
+}
+
+void CClientSynchedStorage::CSetGlobalMsg::operator delete(void *pObject, size_t size)
+{
+	DeallocateSetMsg(pObject, size);
+}
+
 DEFINE_GLOBAL_MESSAGE(CSetGlobalBoolMsg, bool, SetGlobalBoolMsg);
 DEFINE_GLOBAL_MESSAGE(CSetGlobalFloatMsg, float, SetGlobalFloatMsg);
 DEFINE_GLOBAL_MESSAGE(CSetGlobalIntMsg, int, SetGlobalIntMsg);
@@ -176,8 +220,13 @@ EMessageSendResult CClientSynchedStorage::CSetChannelMsg::WritePayload(TSerializ
 	return eMSR_SentOk;
 }
 
-void CClientSynchedStorage::CSetChannelMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+void CClientSynchedStorage::CSetChannelMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate update)
 {
+	// requeued messages are sent again by the network
+	if (update != eNSSU_Requeue)
+	{
+		m_pStorage->OnSetChannelMsgComplete(this, channelId, fromSeq, update == eNSSU_Ack);
+	}
 }
 
 size_t CClientSynchedStorage::CSetChannelMsg::GetSize()
@@ -185,6 +234,16 @@ size_t CClientSynchedStorage::CSetChannelMsg::GetSize()
 	return sizeof (*this);
 };
 
+void *CClientSynchedStorage::CSetChannelMsg::operator new(size_t size)
+{
+	return AllocateSetMsg(size);
+}
+
+void CClientSynchedStorage::CSetChannelMsg::operator delete(void *pObject, size_t size)
+{
+	DeallocateSetMsg(pObject, size);
+}
+
 DEFINE_CHANNEL_MESSAGE(CSetChannelBoolMsg, bool, SetChannelBoolMsg);
 DEFINE_CHANNEL_MESSAGE(CSetChannelFloatMsg, float, SetChannelFloatMsg);
 DEFINE_CHANNEL_MESSAGE(CSetChannelIntMsg, int, SetChannelIntMsg);
@@ -259,8 +318,13 @@ EMessageSendResult CClientSynchedStorage::CSetEntityMsg::WritePayload(TSerialize
 	return eMSR_SentOk;
 }
 
-void CClientSynchedStorage::CSetEntityMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate)
+void CClientSynchedStorage::CSetEntityMsg::UpdateState(uint32 fromSeq, ENetSendableStateUpdate update)
 {
+	// requeued messages are sent again by the network
+	if (update != eNSSU_Requeue)
+	{
+		m_pStorage->OnSetEntityMsgComplete(this, channelId, fromSeq, update == eNSSU_Ack);
+	}
 }
 
 size_t CClientSynchedStorage::CSetEntityMsg::GetSize()
@@ -268,6 +332,16 @@ size_t CClientSynchedStorage::CSetEntityMsg::GetSize()
 	return sizeof (*this);
 };
 
+void *CClientSynchedStorage::CSetEntityMsg::operator new(size_t size)
+{
+	return AllocateSetMsg(size);
+}
+
+void CClientSynchedStorage::CSetEntityMsg::operator delete(void *pObject, size_t size)
+{
+	DeallocateSetMsg(pObject, size);
+}
+
 DEFINE_ENTITY_MESSAGE(CSetEntityBoolMsg, bool, SetEntityBoolMsg);
 DEFINE_ENTITY_MESSAGE(CSetEntityFloatMsg, float, SetEntityFloatMsg);
 DEFINE_ENTITY_MESSAGE(CSetEntityIntMsg, int, SetEntityIntMsg);
@@ -71,6 +71,10 @@ public:
 		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
 		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
 		virtual size_t GetSize();
+
+		// allocated from a pool shared by all set messages
+		static void *operator new(size_t size);
+		static void operator delete(void *pObject, size_t size);
 	};
 
 	DECLARE_GLOBAL_MESSAGE(CSetGlobalBoolMsg);
@@ -93,6 +97,10 @@ public:
 		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
 		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
 		virtual size_t GetSize();
+
+		// allocated from a pool shared by all set messages
+		static void *operator new(size_t size);
+		static void operator delete(void *pObject, size_t size);
 	};
 
 	DECLARE_CHANNEL_MESSAGE(CSetChannelBoolMsg);
@@ -116,6 +124,10 @@ public:
 		virtual EMessageSendResult WritePayload(TSerialize ser, uint32 currentSeq, uint32 basisSeq);
 		virtual void UpdateState(uint32 fromSeq, ENetSendableStateUpdate update);
 		virtual size_t GetSize();
+
+		// allocated from a pool shared by all set messages
+		static void *operator new(size_t size);
+		static void operator delete(void *pObject, size_t size);
 	};
 
 	DECLARE_ENTITY_MESSAGE(CSetEntityBoolMsg);
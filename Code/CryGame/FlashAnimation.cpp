@@ -17,6 +17,82 @@ History:
 
 IFlashPlayer*	CFlashAnimation::s_pFlashPlayerNull = 0;
 
+namespace
+{
+	struct SFlashCallStats
+	{
+		int invokes;
+		int variables;
+		int suppressedInvokes;
+		int suppressedVariables;
+		int resolvedPaths;
+		int cachedPaths;
+	};
+
+	SFlashCallStats g_callStats[2];	// current and last frame
+	int g_callStatsFrameId = -1;
+
+	int GetFrameId()
+	{
+		return gEnv->pRenderer ? gEnv->pRenderer->GetFrameID(false) : 0;
+	}
+
+	SFlashCallStats &GetCallStats()
+	{
+		const int frameId = GetFrameId();
+		if (frameId != g_callStatsFrameId)
+		{
+			g_callStats[1] = (g_callStatsFrameId == frameId - 1) ? g_callStats[0] : SFlashCallStats();
+			g_callStats[0] = SFlashCallStats();
+			g_callStatsFrameId = frameId;
+		}
+
+		return g_callStats[0];
+	}
+
+	void AppendValue(string &key, const SFlashVarValue &value)
+	{
+		const SFlashVarValue::Type type = value.GetType();
+		key += static_cast<char>(type);
+
+		switch (type)
+		{
+		case SFlashVarValue::eBool:
+			key += value.GetBool() ? '1' : '0';
+			break;
+		case SFlashVarValue::eInt:
+		case SFlashVarValue::eUInt:
+			{
+				const int v = (type == SFlashVarValue::eInt) ? value.GetInt() : value.GetUInt();
+				key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+			}
+			break;
+		case SFlashVarValue::eDouble:
+			{
+				const double v = value.GetDouble();
+				key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+			}
+			break;
+		case SFlashVarValue::eFloat:
+			{
+				const float v = value.GetFloat();
+				key.append(reinterpret_cast<const char*>(&v), sizeof(v));
+			}
+			break;
+		case SFlashVarValue::eConstStrPtr:
+			if (const char* str = value.GetConstStrPtr())
+				key.append(str, strlen(str) + 1);
+			break;
+		case SFlashVarValue::eConstWstrPtr:
+			if (const wchar_t* str = value.GetConstWstrPtr())
+				key.append(reinterpret_cast<const char*>(str), (wcslen(str) + 1) * sizeof(wchar_t));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 CFlashAnimation::CFlashAnimation()
 {
 	m_pFlashPlayer = 0;
@@ -51,6 +127,7 @@ void CFlashAnimation::SetDock(uint32 eFDock)
 bool CFlashAnimation::LoadAnimation(const char* name)
 {
 	SAFE_RELEASE(m_pFlashPlayer);
+	ResetCache();
 
 	m_pFlashPlayer = GetISystem()->CreateFlashPlayerInstance();
 
@@ -64,6 +141,7 @@ bool CFlashAnimation::LoadAnimation(const char* name)
 void CFlashAnimation::Unload()
 {
 	SAFE_RELEASE(m_pFlashPlayer);
+	ResetCache();
 }
 
 bool CFlashAnimation::IsLoaded() const
@@ -128,15 +206,21 @@ bool CFlashAnimation::IsAvailable(const char* pPathToVar) const
 bool CFlashAnimation::SetVariable(const char* pPathToVar, const SFlashVarValue& value)
 {
 	if (m_pFlashPlayer)
+	{
+		++GetCallStats().variables;
 		return m_pFlashPlayer->SetVariable(pPathToVar, value);
+	}
 
 	return true;
 }
 
 bool CFlashAnimation::CheckedSetVariable(const char* pPathToVar, const SFlashVarValue& value)
 {
-	if (m_pFlashPlayer && m_pFlashPlayer->IsAvailable(pPathToVar))
-		return m_pFlashPlayer->SetVariable(pPathToVar, value);
+	if (m_pFlashPlayer && IsPathAvailable(pPathToVar))
+	{
+		++GetCallStats().variables;
+		return CheckPathResult(pPathToVar, m_pFlashPlayer->SetVariable(pPathToVar, value));
+	}
 
 	return true;
 }
@@ -144,15 +228,141 @@ bool CFlashAnimation::CheckedSetVariable(const char* pPathToVar, const SFlashVar
 bool CFlashAnimation::Invoke(const char* pMethodName, const SFlashVarValue* pArgs, unsigned int numArgs, SFlashVarValue* pResult)
 {
 	if (m_pFlashPlayer)
+	{
+		++GetCallStats().invokes;
 		return m_pFlashPlayer->Invoke(pMethodName, pArgs, numArgs, pResult);
+	}
 
 	return true;
 }
 
 bool CFlashAnimation::CheckedInvoke(const char* pMethodName, const SFlashVarValue* pArgs, unsigned int numArgs, SFlashVarValue* pResult)
 {
-	if (m_pFlashPlayer && m_pFlashPlayer->IsAvailable(pMethodName))
-		return m_pFlashPlayer->Invoke(pMethodName, pArgs, numArgs, pResult);
+	if (m_pFlashPlayer && IsPathAvailable(pMethodName))
+	{
+		++GetCallStats().invokes;
+		return CheckPathResult(pMethodName, m_pFlashPlayer->Invoke(pMethodName, pArgs, numArgs, pResult));
+	}
+
+	return true;
+}
+
+bool CFlashAnimation::CachedSetVariable(const char* pPathToVar, const SFlashVarValue& value)
+{
+	if (!m_pFlashPlayer || !IsPathAvailable(pPathToVar))
+		return true;
+
+	if (!UpdateLastCall(m_lastVariables, pPathToVar, &value, 1))
+	{
+		++GetCallStats().suppressedVariables;
+		return true;
+	}
+
+	++GetCallStats().variables;
+	return CheckPathResult(pPathToVar, m_pFlashPlayer->SetVariable(pPathToVar, value));
+}
+
+bool CFlashAnimation::CachedInvoke(const char* pMethodName, const SFlashVarValue* pArgs, unsigned int numArgs)
+{
+	if (!m_pFlashPlayer || !IsPathAvailable(pMethodName))
+		return true;
+
+	if (!UpdateLastCall(m_lastInvokes, pMethodName, pArgs, numArgs))
+	{
+		++GetCallStats().suppressedInvokes;
+		return true;
+	}
+
+	++GetCallStats().invokes;
+	return CheckPathResult(pMethodName, m_pFlashPlayer->Invoke(pMethodName, pArgs, numArgs));
+}
+
+bool CFlashAnimation::IsPathAvailable(const char* pPath)
+{
+	const int frameId = GetFrameId();
+
+	TPathMap::iterator it = m_paths.find(CONST_TEMP_STRING(pPath));
+	if (it != m_paths.end() && (it->second.available || it->second.frameId == frameId))
+	{
+		++GetCallStats().cachedPaths;
+		return it->second.available;
+	}
+
+	++GetCallStats().resolvedPaths;
+
+	SPathInfo info;
+	info.available = m_pFlashPlayer->IsAvailable(pPath);
+	info.frameId = frameId;
+
+	if (it != m_paths.end())
+		it->second = info;
+	else
+		m_paths.insert(TPathMap::value_type(pPath, info));
+
+	return info.available;
+}
+
+bool CFlashAnimation::CheckPathResult(const char* pPath, bool result)
+{
+	// the movie can replace its own clips, e.g. with gotoAndStop or loadMovie, so an available path is
+	// resolved again once a call on it fails, and the last values sent to it are forgotten
+	if (!result)
+	{
+		m_paths.erase(CONST_TEMP_STRING(pPath));
+		m_lastInvokes.erase(CONST_TEMP_STRING(pPath));
+		m_lastVariables.erase(CONST_TEMP_STRING(pPath));
+	}
+
+	return result;
+}
 
+bool CFlashAnimation::UpdateLastCall(TLastCallMap &calls, const char* pName, const SFlashVarValue* pArgs, unsigned int numArgs)
+{
+	static string key;
+	key.resize(0);
+
+	for (unsigned int i = 0; i < numArgs; i++)
+		AppendValue(key, pArgs[i]);
+
+	TLastCallMap::iterator it = calls.find(CONST_TEMP_STRING(pName));
+	if (it == calls.end())
+	{
+		calls.insert(TLastCallMap::value_type(pName, key));
+		return true;
+	}
+
+	if (it->second == key)
+		return false;
+
+	it->second = key;
 	return true;
 }
+
+void CFlashAnimation::ResetCachedCalls()
+{
+	m_lastInvokes.clear();
+	m_lastVariables.clear();
+}
+
+void CFlashAnimation::ResetPathCache()
+{
+	m_paths.clear();
+}
+
+void CFlashAnimation::ResetCache()
+{
+	m_paths.clear();
+	ResetCachedCalls();
+}
+
+void CFlashAnimation::LogCallStatistics()
+{
+	GetCallStats();
+
+	const SFlashCallStats &stats = g_callStats[1];
+
+	CryLogAlways("Flash calls of the last frame:");
+	CryLogAlways("  invokes: %d issued, %d suppressed", stats.invokes, stats.suppressedInvokes);
+	CryLogAlways("  variables: %d issued, %d suppressed", stats.variables, stats.suppressedVariables);
+	CryLogAlways("  paths: %d resolved, %d cached", stats.resolvedPaths, stats.cachedPaths);
+}
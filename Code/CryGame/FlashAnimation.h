@@ -68,11 +68,45 @@ public:
 		return CheckedInvoke(pMethodName, &arg, 1, pResult);
 	}
 
+	// checked calls which are skipped when the values equal the last call of the same method or variable
+	// only for state the movie itself never changes, e.g. values updated every frame by the HUD
+	bool CachedSetVariable(const char* pPathToVar, const SFlashVarValue& value);
+	bool CachedInvoke(const char* pMethodName, const SFlashVarValue* pArgs, unsigned int numArgs);
+	bool CachedInvoke(const char* pMethodName, const SFlashVarValue& arg)
+	{
+		return CachedInvoke(pMethodName, &arg, 1);
+	}
+	// forget the last values, call when the movie resets its state itself
+	void ResetCachedCalls();
+	// resolve all paths again, call when the movie replaces its clips itself
+	void ResetPathCache();
+
+	// logs calls of the last frame, issued and suppressed, for all animations
+	static void LogCallStatistics();
+
 private:
+	struct SPathInfo
+	{
+		bool	available;
+		int		frameId;	// unavailable paths are resolved again in the next frame
+	};
+
+	typedef std::map<string, SPathInfo>	TPathMap;
+	typedef std::map<string, string>		TLastCallMap;
+
+	bool IsPathAvailable(const char* pPath);
+	bool CheckPathResult(const char* pPath, bool result);
+	bool UpdateLastCall(TLastCallMap &calls, const char* pName, const SFlashVarValue* pArgs, unsigned int numArgs);
+	void ResetCache();
 
 	IFlashPlayer*	m_pFlashPlayer;
 	uint32	m_dock;
 
+	// per loaded movie
+	TPathMap			m_paths;
+	TLastCallMap	m_lastInvokes;
+	TLastCallMap	m_lastVariables;
+
 	// shared null player
 	static IFlashPlayer*	s_pFlashPlayerNull;
 };
@@ -43,6 +43,7 @@
 #include "GameFactory.h"
 
 #include "ItemSharedParams.h"
+#include "ItemScheduler.h"
 
 #include "Nodes/G2FlowBaseNode.h"
 
@@ -83,6 +84,7 @@ CGame::CGame()
 	: m_pFramework(0),
 	m_pConsole(0),
 	m_pWeaponSystem(0),
+	m_pItemTimerWheel(0),
 	m_pFlashMenuObject(0),
 	m_pOptionsManager(0),
 	m_pScriptBindActor(0),
@@ -127,6 +129,7 @@ CGame::~CGame()
 	m_pWeaponSystem->Release();
 	SAFE_DELETE(m_pItemStrings);
 	SAFE_DELETE(m_pItemSharedParamsList);
+	SAFE_DELETE(m_pItemTimerWheel);
 	SAFE_DELETE(m_pCVars);
 	g_pGame = 0;
 	g_pGameCVars = 0;
@@ -150,6 +153,7 @@ bool CGame::Init(IGameFramework* pFramework)
 	m_pItemStrings = new SItemStrings();
 
 	m_pItemSharedParamsList = new CItemSharedParamsList();
+	m_pItemTimerWheel = new CItemTimerWheel();
 
 	LoadActionMaps();
 
@@ -203,6 +207,10 @@ bool CGame::Init(IGameFramework* pFramework)
 	const bool bResetProfile = gEnv->pSystem->GetICmdLine()->FindArg(eCLAT_Pre, "ResetProfile") != 0;
 	if (m_pPlayerProfileManager)
 	{
+		// pending changes belong to the profile active until now
+		if (m_pOptionsManager)
+			m_pOptionsManager->FlushProfile();
+
 		const char* userName = gEnv->pSystem->GetUserName();
 
 		bool ok = m_pPlayerProfileManager->LoginUser(userName, bIsFirstTime);
@@ -356,9 +364,13 @@ int CGame::Update(bool haveFocus, unsigned int updateFlags)
 	bool bRun = m_pFramework->PreUpdate(true, updateFlags);
 	float frameTime = gEnv->pTimer->GetFrameTime();
 
+	if (m_pServerSynchedStorage)
+		m_pServerSynchedStorage->Update();
+
 	if (m_pFramework->IsGamePaused() == false)
 	{
 		m_pWeaponSystem->Update(frameTime);
+		m_pItemTimerWheel->Update(frameTime);
 
 		m_pBulletTime->Update();
 		m_pSoundMoods->Update();
@@ -366,6 +378,9 @@ int CGame::Update(bool haveFocus, unsigned int updateFlags)
 
 	m_pFramework->PostUpdate(true, updateFlags);
 
+	if (m_pOptionsManager)
+		m_pOptionsManager->Update();
+
 	CheckReloadLevel();
 
 	return bRun ? 1 : 0;
@@ -469,6 +484,9 @@ string CGame::InitMapReloading()
 
 void CGame::Shutdown()
 {
+	if (m_pOptionsManager)
+		m_pOptionsManager->FlushProfile();
+
 	if (m_pPlayerProfileManager)
 	{
 		m_pPlayerProfileManager->LogoutUser(m_pPlayerProfileManager->GetCurrentUser());
@@ -849,6 +867,7 @@ void CGame::GetMemoryStatistics(ICrySizer* s)
 	s->Add(*m_pGameActions);
 
 	m_pItemSharedParamsList->GetMemoryStatistics(s);
+	m_pItemTimerWheel->GetMemoryStatistics(s);
 
 	if (m_pPlayerProfileManager)
 		m_pPlayerProfileManager->GetMemoryStatistics(s);
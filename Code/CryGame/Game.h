@@ -44,6 +44,7 @@ class CScriptBind_GameRules;
 class CScriptBind_Game;
 class CScriptBind_HUD;
 class CWeaponSystem;
+class CItemTimerWheel;
 class CFlashMenuObject;
 class COptionsManager;
 
@@ -158,6 +159,7 @@ public:
 	virtual CScriptBind_HUD *GetHUDScriptBind() { return m_pScriptBindHUD; }
 	virtual CWeaponSystem *GetWeaponSystem() { return m_pWeaponSystem; };
 	virtual CItemSharedParamsList *GetItemSharedParamsList() { return m_pItemSharedParamsList; };
+	CItemTimerWheel *GetItemTimerWheel() { return m_pItemTimerWheel; };
 
 	CGameActions&	Actions() const {	return *m_pGameActions;	};
 
@@ -247,6 +249,13 @@ protected:
 	static void CmdRestartGame(IConsoleCmdArgs *pArgs);
 
 	static void CmdDumpSS(IConsoleCmdArgs *pArgs);
+#ifdef _DEBUG
+	static void CmdBenchSS(IConsoleCmdArgs *pArgs);
+	static void CmdBenchShots(IConsoleCmdArgs *pArgs);
+#endif
+	static void CmdDumpRays(IConsoleCmdArgs *pArgs);
+	static void CmdVerifyItemParams(IConsoleCmdArgs *pArgs);
+	static void CmdDumpFlashCalls(IConsoleCmdArgs *pArgs);
 
 	static void CmdLastInv(IConsoleCmdArgs *pArgs);
 	static void CmdName(IConsoleCmdArgs *pArgs);
@@ -307,6 +316,7 @@ protected:
 	SCVars*	m_pCVars;
 	SItemStrings					*m_pItemStrings;
 	CItemSharedParamsList *m_pItemSharedParamsList;
+	CItemTimerWheel				*m_pItemTimerWheel;
 	string                 m_lastSaveGame;
 	string								 m_newSaveGame;
 
@@ -393,6 +393,8 @@ void SCVars::InitCVars(IConsole* pConsole)
 	pConsole->Register("hud_subtitlesQueueCount", &hud_subtitlesQueueCount, 1, 0, "Maximum amount of subtitles in Update Queue");
 	pConsole->Register("hud_subtitlesVisibleCount", &hud_subtitlesVisibleCount, 1, 0, "Maximum amount of subtitles in Visible Queue");
 	pConsole->Register("hud_attachBoughEquipment", &hud_attachBoughtEquipment, 0, VF_CHEAT, "Attach equipment in PS equipment packs to the last bought/selected weapon.");
+	pConsole->Register("hud_chatMessagesPerSecond", &hud_chatMessagesPerSecond, 10, 0, "Maximum number of chat messages shown per second, the oldest waiting ones are dropped. 0=unlimited");
+	pConsole->Register("hud_killLogMessagesPerSecond", &hud_killLogMessagesPerSecond, 10, 0, "Maximum number of kill log messages shown per second, the oldest waiting ones are dropped. 0=unlimited");
 	pConsole->Register("hud_radarBackground", &hud_radarBackground, 1, 0, "Switches the miniMap-background for the radar.");
 	pConsole->Register("hud_radarJammingEffectScale", &hud_radarJammingEffectScale, 0.75f, 0, "Scales the intensity of the radar jamming effect.");
 	pConsole->Register("hud_radarJammingThreshold", &hud_radarJammingThreshold, 0.99f, 0, "Threshold to disable the radar (independent from effect).");
@@ -806,6 +808,8 @@ void SCVars::ReleaseCVars()
 	pConsole->UnregisterVariable("hud_alienInterferenceStrength", true);
 	pConsole->UnregisterVariable("hud_crosshair_enable", true);
 	pConsole->UnregisterVariable("hud_attachBoughEquipment", true);
+	pConsole->UnregisterVariable("hud_chatMessagesPerSecond", true);
+	pConsole->UnregisterVariable("hud_killLogMessagesPerSecond", true);
 	pConsole->UnregisterVariable("hud_subtitlesRenderMode", true);
 	pConsole->UnregisterVariable("hud_panoramicHeight", true);
 	pConsole->UnregisterVariable("hud_subtitles", true);
@@ -916,6 +920,39 @@ void CGame::CmdDumpSS(IConsoleCmdArgs* pArgs)
 		g_pGame->GetSynchedStorage()->Dump();
 }
 
+#ifdef _DEBUG
+//------------------------------------------------------------------------
+void CGame::CmdBenchSS(IConsoleCmdArgs* pArgs)
+{
+	CSynchedStorage::Benchmark();
+}
+
+//------------------------------------------------------------------------
+void CGame::CmdBenchShots(IConsoleCmdArgs* pArgs)
+{
+	CShotValidator::Benchmark();
+}
+#endif
+
+//------------------------------------------------------------------------
+void CGame::CmdDumpRays(IConsoleCmdArgs* pArgs)
+{
+	if (g_pGame->GetWeaponSystem())
+		g_pGame->GetWeaponSystem()->GetRayBroker().LogStatistics();
+}
+
+//------------------------------------------------------------------------
+void CGame::CmdVerifyItemParams(IConsoleCmdArgs* pArgs)
+{
+	CItem::VerifySharedParams();
+}
+
+//------------------------------------------------------------------------
+void CGame::CmdDumpFlashCalls(IConsoleCmdArgs* pArgs)
+{
+	CFlashAnimation::LogCallStatistics();
+}
+
 //------------------------------------------------------------------------
 void CGame::RegisterConsoleVars()
 {
@@ -959,6 +996,13 @@ void CGame::RegisterConsoleCommands()
 	m_pConsole->AddCommand("i_reload", CmdReloadItems, 0, "Reloads item scripts.");
 
 	m_pConsole->AddCommand("dumpss", CmdDumpSS, 0, "test synched storage.");
+#ifdef _DEBUG
+	m_pConsole->AddCommand("benchss", CmdBenchSS, 0, "Measures synched storage entity values against nested std::map.");
+	m_pConsole->AddCommand("benchshots", CmdBenchShots, 0, "Replays a generated shot and hit trace through the shot validator.");
+#endif
+	m_pConsole->AddCommand("dumprays", CmdDumpRays, 0, "Logs weapon ray casts since the last call.");
+	m_pConsole->AddCommand("dumpflashcalls", CmdDumpFlashCalls, 0, "Logs flash calls of the last frame, issued and suppressed.");
+	m_pConsole->AddCommand("verifyitemparams", CmdVerifyItemParams, 0, "Compares the compiled item params of every item class and instance against the item xml.");
 	m_pConsole->AddCommand("dumpnt", CmdDumpItemNameTable, 0, "Dump ItemString table.");
 
 	m_pConsole->AddCommand("g_reloadGameRules", CmdReloadGameRules, 0, "Reload GameRules script");
@@ -1000,6 +1044,13 @@ void CGame::UnregisterConsoleCommands()
 	m_pConsole->RemoveCommand("i_reload");
 
 	m_pConsole->RemoveCommand("dumpss");
+#ifdef _DEBUG
+	m_pConsole->RemoveCommand("benchss");
+	m_pConsole->RemoveCommand("benchshots");
+#endif
+	m_pConsole->RemoveCommand("dumprays");
+	m_pConsole->RemoveCommand("verifyitemparams");
+	m_pConsole->RemoveCommand("dumpflashcalls");
 
 	m_pConsole->RemoveCommand("g_reloadGameRules");
 	m_pConsole->RemoveCommand("g_quickGame");
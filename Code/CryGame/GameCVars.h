@@ -348,6 +348,8 @@ struct SCVars
 	int		hud_ctrlZoomMode;
 	int   hud_faderDebug;
 	int		hud_attachBoughtEquipment;
+	int		hud_chatMessagesPerSecond;
+	int		hud_killLogMessagesPerSecond;
 	int		hud_startPaused;
 	float hud_nightVisionRecharge;
 	float hud_nightVisionConsumption;
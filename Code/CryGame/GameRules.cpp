@@ -394,7 +394,8 @@ void CGameRules::ProcessEvent(SEntityEvent& event)
 
 	case ENTITY_EVENT_START_GAME:
 		m_timeOfDayInitialized = false;
-		g_pGame->GetWeaponSystem()->GetTracerManager().Reset();
+		// spawn all tracer entities now instead of in the middle of combat
+		g_pGame->GetWeaponSystem()->GetTracerManager().Prewarm();
 
 		if (gEnv->bServer && gEnv->bMultiplayer && pTOD && pTOD->GetIVal() && m_pGameFramework->IsImmersiveMPEnabled())
 		{
@@ -531,6 +532,7 @@ void CGameRules::OnResetMap()
 	{
 		m_objectives.clear();
 		m_entityteams.clear();
+		InvalidateSpawnCandidates();
 
 		for (TPlayerTeamIdMap::iterator tit = m_playerteams.begin(); tit != m_playerteams.end(); tit++)
 			tit->second.resize(0);
@@ -852,7 +854,11 @@ CActor* CGameRules::SpawnPlayer(int channelId, const char* name, const char* cla
 
 	CActor* pActor = GetActorByChannelId(channelId);
 	if (!pActor)
+	{
 		pActor = static_cast<CActor*>(m_pActorSystem->CreateActor(channelId, VerifyName(name).c_str(), className, pos, Quat(angles), Vec3(1, 1, 1)));
+		if (pActor)
+			ClaimSpawnPosition(pActor->GetEntityId(), pos);
+	}
 
 	return pActor;
 }
@@ -918,6 +924,8 @@ void CGameRules::RevivePlayer(CActor* pActor, const Vec3& pos, const Ang3& angle
 	pActor->GetEntity()->SetWorldTM(tm);
 	pActor->SetAngles(angles);
 
+	ClaimSpawnPosition(pActor->GetEntityId(), pos);
+
 	if (clearInventory)
 	{
 		pActor->GetGameObject()->InvokeRMI(CActor::ClClearInventory(), CActor::NoParams(),
@@ -1548,6 +1556,10 @@ void CGameRules::SetTeam(int teamId, EntityId id)
 		stl::find_and_erase(pit->second, id);
 	}
 
+	// spawn locations are sorted into the candidate lists by team
+	if (!isplayer)
+		InvalidateSpawnCandidates();
+
 	if (teamId)
 	{
 		m_entityteams.insert(TEntityTeamIdMap::value_type(id, teamId));
@@ -2128,6 +2140,8 @@ void CGameRules::AddSpawnLocation(EntityId location)
 	stl::push_back_unique(m_spawnLocations, location);
 
 	std::sort(m_spawnLocations.begin(), m_spawnLocations.end(), compare_spawns());
+
+	InvalidateSpawnCandidates();
 }
 
 //------------------------------------------------------------------------
@@ -2136,6 +2150,8 @@ void CGameRules::RemoveSpawnLocation(EntityId id)
 	stl::find_and_erase(m_spawnLocations, id);
 
 	std::sort(m_spawnLocations.begin(), m_spawnLocations.end(), compare_spawns());
+
+	InvalidateSpawnCandidates();
 }
 
 //------------------------------------------------------------------------
@@ -2171,26 +2187,24 @@ bool CGameRules::IsSpawnLocationSafe(EntityId playerId, EntityId spawnLocationId
 
 	int playerTeamId = GetTeam(playerId);
 
-	SEntityProximityQuery query;
 	Vec3	c(pSpawn->GetWorldPos());
 	float l(safeDistance * 1.5f);
 	float safeDistanceSq = safeDistance * safeDistance;
 
-	query.box = AABB(Vec3(c.x - l, c.y - l, c.z - 0.15f), Vec3(c.x + l, c.y + l, c.z + 2.0f));
-	query.nEntityFlags = -1;
-	query.pEntityClass = m_pEntitySystem->GetClassRegistry()->FindClass("Player");
-	m_pEntitySystem->QueryProximity(query);
-
 	bool result = true;
 
 	if (zoffset <= 0.0001f)
 	{
-		for (int i = 0; i < query.nCount; i++)
+		const TPlayers &occupants = GetSpawnOccupants(spawnLocationId, c, safeDistance);
+		for (TPlayers::const_iterator it = occupants.begin(); it != occupants.end(); ++it)
 		{
-			EntityId entityId = query.pEntities[i]->GetId();
+			EntityId entityId = *it;
 			if (playerId == entityId) // ignore self
 				continue;
 
+			if (GetSpawnClaim(entityId)) // moved away this frame, tested with the claims below
+				continue;
+
 			CActor* pActor = static_cast<CActor*>(m_pActorSystem->GetActor(entityId));
 			if (pActor && pActor->GetSpectatorMode() != 0) // ignore spectators
 				continue;
@@ -2209,6 +2223,25 @@ bool CGameRules::IsSpawnLocationSafe(EntityId playerId, EntityId spawnLocationId
 			result = false;
 			break;
 		}
+
+		// players given a spawn location this frame may not be in the cached queries
+		AABB box(Vec3(c.x - l, c.y - l, c.z - 0.15f), Vec3(c.x + l, c.y + l, c.z + 2.0f));
+
+		for (TSpawnClaimVector::const_iterator it = m_spawnClaims.begin(); result && it != m_spawnClaims.end(); ++it)
+		{
+			if (playerId == it->playerId || !box.IsContainPoint(it->pos))
+				continue;
+
+			if (playerTeamId && playerTeamId == GetTeam(it->playerId))
+			{
+				if ((it->pos - c).len2() <= safeDistanceSq)
+					result = false;
+
+				continue;
+			}
+
+			result = false;
+		}
 	}
 	else
 		result = TestSpawnLocationWithEnvironment(spawnLocationId, playerId, zoffset, 2.0f);
@@ -2272,6 +2305,8 @@ EntityId CGameRules::GetSpawnLocation(EntityId playerId, bool ignoreTeam, bool i
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
 
+	UpdateSpawnCacheFrame();
+
 	const TSpawnLocations* locations = 0;
 
 	if (groupId)
@@ -2288,17 +2323,7 @@ EntityId CGameRules::GetSpawnLocation(EntityId playerId, bool ignoreTeam, bool i
 	if (locations->empty())
 		return 0;
 
-	static TSpawnLocations candidates;
-	candidates.resize(0);
-
-	int playerTeamId = GetTeam(playerId);
-	for (TSpawnLocations::const_iterator it = locations->begin(); it != locations->end(); ++it)
-	{
-		int teamId = GetTeam(*it);
-
-		if ((ignoreTeam || playerTeamId == teamId) || (!teamId && includeNeutral))
-			candidates.push_back(*it);
-	}
+	const TSpawnLocations &candidates = *GetSpawnCandidates(*locations, groupId, GetTeam(playerId), ignoreTeam, includeNeutral);
 
 	int n = candidates.size();
 	if (!n)
@@ -2341,6 +2366,115 @@ EntityId CGameRules::GetSpawnLocation(EntityId playerId, bool ignoreTeam, bool i
 	return candidates[i];
 }
 
+//------------------------------------------------------------------------
+void CGameRules::InvalidateSpawnCandidates()
+{
+	m_spawnCandidates.clear();
+}
+
+//------------------------------------------------------------------------
+const CGameRules::TSpawnLocations *CGameRules::GetSpawnCandidates(const TSpawnLocations &locations, EntityId groupId, int playerTeamId, bool ignoreTeam, bool includeNeutral) const
+{
+	SSpawnCandidatesKey key;
+	key.groupId = groupId;
+	key.teamId = ignoreTeam ? 0 : playerTeamId;
+	key.ignoreTeam = ignoreTeam;
+	key.includeNeutral = ignoreTeam ? false : includeNeutral;
+
+	TSpawnCandidatesMap::iterator it = m_spawnCandidates.find(key);
+	if (it != m_spawnCandidates.end())
+		return &it->second;
+
+	TSpawnLocations &candidates = m_spawnCandidates[key];
+	for (TSpawnLocations::const_iterator lit = locations.begin(); lit != locations.end(); ++lit)
+	{
+		int teamId = GetTeam(*lit);
+
+		if ((ignoreTeam || playerTeamId == teamId) || (!teamId && includeNeutral))
+			candidates.push_back(*lit);
+	}
+
+	return &candidates;
+}
+
+//------------------------------------------------------------------------
+const CGameRules::TPlayers &CGameRules::GetSpawnOccupants(EntityId spawnLocationId, const Vec3 &pos, float safeDistance) const
+{
+	UpdateSpawnCacheFrame();
+
+	for (TSpawnOccupancyVector::const_iterator it = m_spawnOccupancy.begin(); it != m_spawnOccupancy.end(); ++it)
+	{
+		if (it->spawnLocationId == spawnLocationId && it->safeDistance == safeDistance)
+			return it->players;
+	}
+
+	SEntityProximityQuery query;
+	float l(safeDistance * 1.5f);
+
+	query.box = AABB(Vec3(pos.x - l, pos.y - l, pos.z - 0.15f), Vec3(pos.x + l, pos.y + l, pos.z + 2.0f));
+	query.nEntityFlags = -1;
+	query.pEntityClass = m_pEntitySystem->GetClassRegistry()->FindClass("Player");
+	m_pEntitySystem->QueryProximity(query);
+
+	m_spawnOccupancy.push_back(SSpawnOccupancy());
+
+	SSpawnOccupancy &occupancy = m_spawnOccupancy.back();
+	occupancy.spawnLocationId = spawnLocationId;
+	occupancy.safeDistance = safeDistance;
+	occupancy.players.reserve(query.nCount);
+
+	for (int i = 0; i < query.nCount; i++)
+		occupancy.players.push_back(query.pEntities[i]->GetId());
+
+	return occupancy.players;
+}
+
+//------------------------------------------------------------------------
+const Vec3 *CGameRules::GetSpawnClaim(EntityId playerId) const
+{
+	for (TSpawnClaimVector::const_iterator it = m_spawnClaims.begin(); it != m_spawnClaims.end(); ++it)
+	{
+		if (it->playerId == playerId)
+			return &it->pos;
+	}
+
+	return 0;
+}
+
+//------------------------------------------------------------------------
+void CGameRules::ClaimSpawnPosition(EntityId playerId, const Vec3 &pos)
+{
+	// the proximity queries cached this frame don't know about the move, later spawns in the frame have to avoid it
+	UpdateSpawnCacheFrame();
+
+	for (TSpawnClaimVector::iterator it = m_spawnClaims.begin(); it != m_spawnClaims.end(); ++it)
+	{
+		if (it->playerId == playerId)
+		{
+			it->pos = pos;
+			return;
+		}
+	}
+
+	SSpawnClaim claim;
+	claim.playerId = playerId;
+	claim.pos = pos;
+
+	m_spawnClaims.push_back(claim);
+}
+
+//------------------------------------------------------------------------
+void CGameRules::UpdateSpawnCacheFrame() const
+{
+	const CTimeValue frameTime = gEnv->pTimer->GetFrameStartTime();
+	if (frameTime == m_spawnCacheFrameTime)
+		return;
+
+	m_spawnCacheFrameTime = frameTime;
+	m_spawnOccupancy.clear();
+	m_spawnClaims.clear();
+}
+
 //------------------------------------------------------------------------
 EntityId CGameRules::GetFirstSpawnLocation(int teamId, EntityId groupId) const
 {
@@ -2375,6 +2509,8 @@ void CGameRules::AddSpawnLocationToSpawnGroup(EntityId groupId, EntityId locatio
 
 	stl::push_back_unique(it->second, location);
 	std::sort(m_spawnLocations.begin(), m_spawnLocations.end(), compare_spawns()); // need to resort spawn location
+
+	InvalidateSpawnCandidates();
 }
 
 //------------------------------------------------------------------------
@@ -2386,6 +2522,8 @@ void CGameRules::RemoveSpawnLocationFromSpawnGroup(EntityId groupId, EntityId lo
 
 	stl::find_and_erase(it->second, location);
 	std::sort(m_spawnLocations.begin(), m_spawnLocations.end(), compare_spawns()); // need to resort spawn location
+
+	InvalidateSpawnCandidates();
 }
 
 //------------------------------------------------------------------------
@@ -2397,6 +2535,8 @@ void CGameRules::RemoveSpawnGroup(EntityId groupId)
 
 	std::sort(m_spawnLocations.begin(), m_spawnLocations.end(), compare_spawns()); // need to resort spawn location
 
+	InvalidateSpawnCandidates();
+
 	if (gEnv->bServer)
 	{
 		GetGameObject()->InvokeRMI(ClRemoveSpawnGroup(), SpawnGroupParams(groupId), eRMI_ToAllClients | eRMI_NoLocalCalls, groupId);
@@ -3552,6 +3692,7 @@ void CGameRules::ResetEntities()
 
 	m_respawns.clear();
 	m_entityteams.clear();
+	InvalidateSpawnCandidates();
 	m_teamdefaultspawns.clear();
 
 	for (TPlayerTeamIdMap::iterator tit = m_playerteams.begin(); tit != m_playerteams.end(); tit++)
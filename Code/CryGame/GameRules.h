@@ -1019,6 +1019,14 @@ protected:
 	void CommitAffectedEntitiesSet(SmartScriptTable &scriptExplosionInfo, TExplosionAffectedEntities &affectedEnts);
 	void ChatLog(EChatMessageType type, EntityId sourceId, EntityId targetId, const char *msg);
 
+	// spawn candidates and occupancy are cached, so players spawning in the same frame share the work
+	void InvalidateSpawnCandidates();
+	const TSpawnLocations *GetSpawnCandidates(const TSpawnLocations &locations, EntityId groupId, int playerTeamId, bool ignoreTeam, bool includeNeutral) const;
+	const TPlayers &GetSpawnOccupants(EntityId spawnLocationId, const Vec3 &pos, float safeDistance) const;
+	const Vec3 *GetSpawnClaim(EntityId playerId) const;
+	void ClaimSpawnPosition(EntityId playerId, const Vec3 &pos);
+	void UpdateSpawnCacheFrame() const;
+
 	// Some explosion processing
 	void ProcessClientExplosionScreenFX(const ExplosionInfo &explosionInfo);
 	void ProcessExplosionMaterialFX(const ExplosionInfo &explosionInfo);
@@ -1145,6 +1153,49 @@ protected:
 
 	TSpawnLocations			m_spectatorLocations;
 
+	struct SSpawnCandidatesKey
+	{
+		EntityId	groupId;
+		int				teamId;
+		bool			ignoreTeam;
+		bool			includeNeutral;
+
+		bool operator<(const SSpawnCandidatesKey &other) const
+		{
+			if (groupId != other.groupId)
+				return groupId < other.groupId;
+			if (teamId != other.teamId)
+				return teamId < other.teamId;
+			if (ignoreTeam != other.ignoreTeam)
+				return ignoreTeam < other.ignoreTeam;
+			return includeNeutral < other.includeNeutral;
+		}
+	};
+
+	struct SSpawnOccupancy
+	{
+		EntityId	spawnLocationId;
+		float			safeDistance;
+		TPlayers	players;		// players found around the spawn location
+	};
+
+	struct SSpawnClaim
+	{
+		EntityId	playerId;
+		Vec3			pos;				// position the player was spawned or revived at this frame
+	};
+
+	typedef std::map<SSpawnCandidatesKey, TSpawnLocations>	TSpawnCandidatesMap;
+	typedef std::vector<SSpawnOccupancy>										TSpawnOccupancyVector;
+	typedef std::vector<SSpawnClaim>												TSpawnClaimVector;
+
+	// candidates by group and team, rebuilt after spawn locations or their teams change
+	mutable TSpawnCandidatesMap		m_spawnCandidates;
+	// proximity queries and spawned or revived players of the current frame
+	mutable TSpawnOccupancyVector	m_spawnOccupancy;
+	mutable TSpawnClaimVector			m_spawnClaims;
+	mutable CTimeValue						m_spawnCacheFrameTime;
+
 	int									m_currentStateId;
 
 	THitListenerVec     m_hitListeners;
@@ -885,6 +885,10 @@ IMPLEMENT_RMI(CGameRules, ClSetTeam)
 		stl::find_and_erase(pit->second, params.entityId);
 	}
 
+	// spawn locations are sorted into the candidate lists by team
+	if (!isplayer)
+		InvalidateSpawnCandidates();
+
 	if (params.teamId)
 	{
 		m_entityteams.insert(TEntityTeamIdMap::value_type(params.entityId, params.teamId));
@@ -58,6 +58,10 @@ bool CGameFlashAnimation::Reload(bool forceUnload)
 	if (forceUnload)
 		Unload();
 
+	// a loaded movie is kept, but whoever reloads it may also replace its clips
+	if (IsLoaded())
+		ResetPathCache();
+
 	if (!m_fileName.empty() && !IsLoaded())
 	{
 		if (LoadAnimation(m_fileName.c_str()))
@@ -436,7 +436,7 @@ bool CHUD::Init(IActor* pActor)
 
 	m_pHUDScopes = new CHUDScopes(this);
 	m_pHUDRadar = new CHUDRadar(this);
-	m_pHUDObituary = new CHUDObituary;
+	m_pHUDObituary = new CHUDObituary(&m_animKillLog);
 	m_pHUDTextArea = new CHUDTextArea;
 	m_pHUDTextArea->SetFadeTime(2.0f);
 	m_pHUDTextArea->SetPos(Vec2(200.0f, 450.0f));
@@ -2145,6 +2145,7 @@ bool CHUD::OnAction(const ActionId& action, int activationMode, float value)
 				/*				if(!m_animQuickMenu.IsLoaded())
 									m_animQuickMenu.Reload();*/
 				m_animQuickMenu.Invoke("showQuickMenu");
+				m_animQuickMenu.ResetCachedCalls();
 				m_animQuickMenu.SetVariable("_alpha", 100);
 
 				if (pPlayer)
@@ -2996,6 +2997,12 @@ void CHUD::OnPostUpdate(float frameTime)
 		UpdateRatio();
 	}
 
+	// messages of this frame are sent to flash together, before the feeds are rendered
+	if (m_pHUDTextChat)
+		m_pHUDTextChat->FlushChatMessages();
+	if (m_pHUDObituary)
+		m_pHUDObituary->FlushKillLog();
+
 	if (gEnv->bMultiplayer)
 	{
 		//UpdateTeamActionHUD(); //No TeamAction supported.. yet? :D
@@ -111,7 +111,7 @@ void CHUD::AutoSnap()
 		m_pRenderer->Set2DMode(false,0,0);
 */
 
-		m_animQuickMenu.CheckedSetVariable("Root.QuickMenu.Circle.Indicator._rotation",szAngle);
+		m_animQuickMenu.CachedSetVariable("Root.QuickMenu.Circle.Indicator._rotation",szAngle);
 
 		if(fAngle >= 342 || fAngle < 52)
 		{
@@ -135,7 +135,7 @@ void CHUD::AutoSnap()
 		}
 	}
 
-	m_animQuickMenu.CheckedInvoke("Root.QuickMenu.setAutosnapItem", autosnapItem);
+	m_animQuickMenu.CachedInvoke("Root.QuickMenu.setAutosnapItem", autosnapItem);
 }
 
 void CHUD::UpdateMissionObjectiveIcon(EntityId objective, int friendly, FlashOnScreenIcon iconType, bool forceNoOffset, Vec3 rotationTarget)
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+
+// Bounded ring buffer of messages waiting to be sent to a Flash feed.
+// Slots are preallocated and reused, so their strings keep their capacity.
+// When the queue is full, the oldest message is dropped.
+template<class TMessage, int SIZE>
+class CHUDMessageQueue
+{
+	TMessage m_messages[SIZE];
+	int m_head = 0;  // oldest message
+	int m_count = 0;
+	float m_budget = 0;
+	float m_lastFlushTime = 0;
+	bool m_hasFlushed = false;
+
+	void PopFront()
+	{
+		m_head = (m_head + 1) % SIZE;
+		m_count--;
+	}
+
+public:
+	// returns the slot of the new message, which the caller fills in
+	TMessage & Push()
+	{
+		if (m_count == SIZE)
+		{
+			PopFront();
+		}
+
+		TMessage & message = m_messages[(m_head + m_count) % SIZE];
+		m_count++;
+
+		return message;
+	}
+
+	// passes the messages allowed in this frame to show, oldest first
+	// visibleLines: messages which would scroll out of the feed in the same frame are dropped
+	// messagesPerSecond: display budget, 0 is unlimited
+	template<class TShowFunction>
+	void Flush(int visibleLines, int messagesPerSecond, TShowFunction show)
+	{
+		const float now = gEnv->pTimer->GetAsyncTime().GetSeconds();
+
+		if (messagesPerSecond > 0)
+		{
+			const float elapsed = m_hasFlushed ? (now - m_lastFlushTime) : 1.0f;
+			m_budget = std::min(m_budget + elapsed * messagesPerSecond, static_cast<float>(messagesPerSecond));
+		}
+
+		m_lastFlushTime = now;
+		m_hasFlushed = true;
+
+		while (m_count > visibleLines)
+		{
+			PopFront();
+		}
+
+		while (m_count > 0 && (messagesPerSecond <= 0 || m_budget >= 1.0f))
+		{
+			show(m_messages[m_head]);
+			PopFront();
+
+			if (messagesPerSecond > 0)
+			{
+				m_budget -= 1.0f;
+			}
+		}
+	}
+
+	void Clear()
+	{
+		m_head = 0;
+		m_count = 0;
+	}
+
+	int GetCount() const
+	{
+		return m_count;
+	}
+
+	template<class TSizer>
+	void GetMemoryStatistics(TSizer *s)
+	{
+		for (int i = 0; i < SIZE; i++)
+		{
+			m_messages[i].GetMemoryStatistics(s);
+		}
+	}
+};
@@ -6,9 +6,11 @@
 #include "HUDObituary.h"
 #include "CryCommon/CryAction/IUIDraw.h"
 #include "CryGame/Game.h"
+#include "CryGame/GameCVars.h"
+#include "GameFlashAnimation.h"
 
-CHUDObituary::CHUDObituary()
-:	m_deathHead(0), m_empty(true)
+CHUDObituary::CHUDObituary(CGameFlashAnimation *pKillLog)
+:	m_pKillLog(pKillLog), m_deathHead(0), m_empty(true)
 {
 	m_pDefaultFont = GetISystem()->GetICryFont()->GetFont("default");
 	CRY_ASSERT(m_pDefaultFont);
@@ -58,9 +60,39 @@ void CHUDObituary::AddMessage(const wchar_t *msg)
 	m_empty = false;
 }
 
+void CHUDObituary::AddKillLog(const wchar_t *shooter, const wchar_t *weapon, const wchar_t *target, bool headshot, int shooterFriendly, int targetFriendly)
+{
+	SKillLogLine &line = m_killLogQueue.Push();
+	line.shooter = shooter;
+	line.weapon = weapon;
+	line.target = target;
+	line.headshot = headshot;
+	line.shooterFriendly = shooterFriendly;
+	line.targetFriendly = targetFriendly;
+}
+
+void CHUDObituary::FlushKillLog()
+{
+	if(!m_killLogQueue.GetCount())
+		return;
+
+	if(!m_pKillLog || !m_pKillLog->IsLoaded())
+	{
+		m_killLogQueue.Clear();
+		return;
+	}
+
+	m_killLogQueue.Flush(KILL_LOG_QUEUE_SIZE, g_pGameCVars->hud_killLogMessagesPerSecond, [this](const SKillLogLine &line)
+	{
+		SFlashVarValue args[6] = {line.shooter.c_str(), line.weapon.c_str(), line.target.c_str(), line.headshot, line.shooterFriendly, line.targetFriendly};
+		m_pKillLog->Invoke("addLog", args, 6);
+	});
+}
+
 void CHUDObituary::GetMemoryStatistics(ICrySizer * s)
 {
 	s->Add(*this);
 	for (int i=0; i<OBITUARY_SIZE; i++)
 		s->Add(m_deaths[i]);
+	m_killLogQueue.GetMemoryStatistics(s);
 }
@@ -16,22 +16,50 @@ History:
 
 
 #include "HUDObject.h"
+#include "HUDMessageQueue.h"
 #include "CryCommon/CryInput/IInput.h"
 
+class CGameFlashAnimation;
 
 class CHUDObituary : public CHUDObject
 {
 	static const int OBITUARY_SIZE = 8;
+	static const int KILL_LOG_QUEUE_SIZE = 32;
 public:
-	CHUDObituary();
+	CHUDObituary(CGameFlashAnimation *pKillLog);
 	~CHUDObituary();
 
 	virtual void Update(float deltaTime);
 	virtual void AddMessage(const wchar_t *msg);
 
+	//queues a kill log line, they are sent to flash by FlushKillLog
+	void AddKillLog(const wchar_t *shooter, const wchar_t *weapon, const wchar_t *target, bool headshot, int shooterFriendly, int targetFriendly);
+	//sends the kill log lines of this frame to flash, called once per frame
+	void FlushKillLog();
+
 	void GetMemoryStatistics(ICrySizer * s);
 
 private:
+	struct SKillLogLine
+	{
+		wstring shooter;
+		wstring weapon;
+		wstring target;
+		bool headshot;
+		int shooterFriendly;
+		int targetFriendly;
+
+		void GetMemoryStatistics(ICrySizer *s)
+		{
+			s->Add(shooter);
+			s->Add(weapon);
+			s->Add(target);
+		}
+	};
+
+	CGameFlashAnimation	*m_pKillLog;
+	CHUDMessageQueue<SKillLogLine, KILL_LOG_QUEUE_SIZE> m_killLogQueue;
+
 	IFFont				*m_pDefaultFont;
 	wstring				m_deaths[OBITUARY_SIZE];
 	CTimeValue		m_deathTimes[OBITUARY_SIZE];
@@ -85,6 +85,15 @@ void CHUDPowerStruggle::Reset()
 	m_currentHexIconState = E_HEX_ICON_NONE;
 	m_currentBuyZones.clear();
 	m_currentServiceZones.clear();
+
+	m_catalogue.clear();
+	m_catalogueIndex.clear();
+	for (int i = 0; i <= E_LIST_LAST; ++i)
+	{
+		m_catalogueListStart[i] = 0;
+		m_catalogueTables[i] = NULL;
+		m_catalogueTableCounts[i] = -1;
+	}
 }
 
 void DrawBar(float x, float y, float width, float height, float border, float progress, const ColorF& color0, const ColorF& color1, const char* text, const ColorF& textColor, float bgalpha)
@@ -683,55 +692,180 @@ void CHUDPowerStruggle::InitEquipmentPacks()
 
 //-----------------------------------------------------------------------------------------------------
 bool CHUDPowerStruggle::GetItemFromName(const char* name, SItem& item)
+{
+	if (!name)
+		return false;
+
+	UpdateCatalogue();
+
+	std::unordered_map<std::string, int>::const_iterator it = m_catalogueIndex.find(name);
+	if (it == m_catalogueIndex.end())
+		return false;
+
+	const SCatalogueItem& catalogueItem = m_catalogue[it->second];
+
+	CreateItemFromCatalogue(catalogueItem, item);
+
+	item.bAmmoType = catalogueItem.bAmmoType;
+	item.bVehicleType = catalogueItem.bVehicleType;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+CHUDPowerStruggle::ECatalogueList CHUDPowerStruggle::GetCatalogueList(EBuyMenuPage itemType)
+{
+	switch (itemType)
+	{
+	case E_AMMO:
+		return E_LIST_AMMO;
+	case E_VEHICLES:
+		return E_LIST_VEHICLES;
+	case E_EQUIPMENT:
+		return E_LIST_EQUIPMENT;
+	case E_PROTOTYPES:
+		return E_LIST_PROTOTYPES;
+	default:
+		return E_LIST_WEAPONS;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+static const char* const s_catalogueTableNames[] =
+{
+	"weaponList",
+	"ammoList",
+	"vehicleList",
+	"equipList",
+	"protoList",
+	// rebuilt by the server when it changes the lists above
+	"buyList"
+};
+
+void CHUDPowerStruggle::UpdateCatalogue()
 {
 	IScriptTable* pGameRulesScriptTable = m_pGameRules->GetEntity()->GetScriptTable();
-	SmartScriptTable pItemListScriptTable;
 
-	float scale = g_pGameCVars->g_pp_scale_price;
+	bool changed = false;
+
+	for (int i = 0; i <= E_LIST_LAST; ++i)
+	{
+		SmartScriptTable pTable;
+		if (pGameRulesScriptTable)
+			pGameRulesScriptTable->GetValue(s_catalogueTableNames[i], pTable);
+
+		const int count = pTable ? pTable->Count() : -1;
+
+		if (pTable.GetPtr() != m_catalogueTables[i].GetPtr() || count != m_catalogueTableCounts[i])
+		{
+			m_catalogueTables[i] = pTable;
+			m_catalogueTableCounts[i] = count;
+			changed = true;
+		}
+	}
+
+	if (changed)
+		BuildCatalogue(pGameRulesScriptTable);
+}
 
-	std::vector<string> tableList;
-	tableList.push_back("weaponList");
-	tableList.push_back("ammoList");
-	tableList.push_back("vehicleList");
-	tableList.push_back("equipList");
-	tableList.push_back("protoList");
+//-----------------------------------------------------------------------------------------------------
+
+void CHUDPowerStruggle::BuildCatalogue(IScriptTable* pGameRulesScriptTable)
+{
+	m_catalogue.clear();
+	m_catalogueIndex.clear();
 
-	std::vector<string>::const_iterator it = tableList.begin();
-	for (; it != tableList.end(); ++it)
+	for (int list = 0; list < E_LIST_LAST; ++list)
 	{
-		if (pGameRulesScriptTable->GetValue(*it, pItemListScriptTable))
+		m_catalogueListStart[list] = m_catalogue.size();
+
+		SmartScriptTable pItemListScriptTable;
+		if (!pGameRulesScriptTable || !pGameRulesScriptTable->GetValue(s_catalogueTableNames[list], pItemListScriptTable))
+			continue;
+
+		IScriptTable::Iterator iter = pItemListScriptTable->BeginIteration();
+		while (pItemListScriptTable->MoveNext(iter))
 		{
-			IScriptTable::Iterator iter = pItemListScriptTable->BeginIteration();
-			while (pItemListScriptTable->MoveNext(iter))
-			{
-				if (ANY_TTABLE != iter.value.type)
-					continue;
+			if (ANY_TTABLE != iter.value.type)
+				continue;
 
-				IScriptTable* pEntry = iter.value.table;
+			IScriptTable* pItemScriptTable = iter.value.table;
 
-				bool invisible = false;
-				if (pEntry->GetValue("invisible", invisible) && invisible)
-					continue;
+			bool bInvisible = false;
+			if (pItemScriptTable->GetValue("invisible", bInvisible) && bInvisible)
+				continue;
 
-				const char* id = 0;
-				if (pEntry->GetValue("id", id) && !strcmp(id, name))
-				{
-					bool type = false;
+			m_catalogue.resize(m_catalogue.size() + 1);
 
-					CreateItemFromTableEntry(pEntry, item);
+			SCatalogueItem& item = m_catalogue.back();
+			ReadCatalogueItem(pItemScriptTable, item);
 
-					item.bAmmoType = pEntry->GetValue("ammo", type) && type;
-					item.bVehicleType = pEntry->GetValue("vehicle", type) && type;
-					pEntry->EndIteration(iter);
-					return true;
-				}
-			}
-			pItemListScriptTable->EndIteration(iter);
+			if (!item.strName.empty())
+				m_catalogueIndex.insert(std::make_pair(std::string(item.strName.c_str()), (int)m_catalogue.size() - 1));
 		}
+		pItemListScriptTable->EndIteration(iter);
 	}
-	return false;
+
+	m_catalogueListStart[E_LIST_LAST] = m_catalogue.size();
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void CHUDPowerStruggle::ReadCatalogueItem(IScriptTable* pItemScriptTable, SCatalogueItem& item)
+{
+	char* strId = NULL;
+	char* strName = NULL;
+	char* strClass = NULL;
+	char* strCategory = NULL;
+	char* ammoClass = NULL;
+
+	item.iPrice = 0;
+	item.level = 0.0f;
+	item.isUnique = 0;
+	item.uniqueLoadoutGroup = 0;
+	item.uniqueLoadoutCount = 0;
+	item.bAmmoType = false;
+	item.bVehicleType = false;
+	item.bVehicleAmmo = false;
+	item.loadout = false;
+	item.special = false;
+
+	pItemScriptTable->GetValue("id", strId);
+	pItemScriptTable->GetValue("level", item.level);
+	pItemScriptTable->GetValue("ammo", item.bAmmoType);
+	pItemScriptTable->GetValue("name", strName);
+	pItemScriptTable->GetValue("class", strClass);
+	pItemScriptTable->GetValue("uniqueId", item.isUnique);
+	pItemScriptTable->GetValue("uniqueloadoutgroup", item.uniqueLoadoutGroup);
+	pItemScriptTable->GetValue("uniqueloadoutcount", item.uniqueLoadoutCount);
+	pItemScriptTable->GetValue("price", item.iPrice);
+	pItemScriptTable->GetValue("vehicle", item.bVehicleType);
+	pItemScriptTable->GetValue("category", strCategory);
+	pItemScriptTable->GetValue("loadout", item.loadout);
+	pItemScriptTable->GetValue("special", item.special);
+	pItemScriptTable->GetValue("buyammo", ammoClass);
+	pItemScriptTable->GetValue("vehicleammo", item.bVehicleAmmo);
+
+	if (item.special)
+		item.loadout = false;
+
+	IEntityClassRegistry* pClassRegistry = gEnv->pEntitySystem->GetClassRegistry();
+
+	item.strName = strId;
+	item.strDesc = strName;
+	item.strClass = strClass;
+	item.strCategory = strCategory;
+	item.bHasClass = (strClass != NULL);
+	item.bHasAmmoClass = (ammoClass != NULL);
+	item.pClass = strClass ? pClassRegistry->FindClass(strClass) : NULL;
+	item.pIdClass = strId ? pClassRegistry->FindClass(strId) : NULL;
+	item.pAmmoClass = ammoClass ? pClassRegistry->FindClass(ammoClass) : NULL;
 }
 
+//-----------------------------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------
 
 void CHUDPowerStruggle::ShowCaptureProgress(bool show)
@@ -786,33 +920,19 @@ void CHUDPowerStruggle::SetCaptureContested(bool contested)
 
 //-----------------------------------------------------------------------------------------------------
 
-void CHUDPowerStruggle::CreateItemFromTableEntry(IScriptTable* pItemScriptTable, SItem& item)
+void CHUDPowerStruggle::CreateItemFromCatalogue(const SCatalogueItem& catalogueItem, SItem& item)
 {
-	char* strId = NULL;
-	char* strDesc = NULL;
-	char* strClass = NULL;
-	int	iPrice = 0;
-	float level = 0.0f;
-	int unique = 0;
-
-	pItemScriptTable->GetValue("id", strId);
-	pItemScriptTable->GetValue("name", strDesc);
-	pItemScriptTable->GetValue("class", strClass);
-	pItemScriptTable->GetValue("price", iPrice);
-	pItemScriptTable->GetValue("uniqueId", unique);
-	pItemScriptTable->GetValue("level", level);
-
 	float scale = g_pGameCVars->g_pp_scale_price;
 
-	item.strName = strId;
-	item.strDesc = strDesc;
-	item.iPrice = (int)(iPrice * scale);
-	item.level = level;
-	item.strClass = strClass;
-	item.isUnique = unique;
+	item.strName = catalogueItem.strName;
+	item.strDesc = catalogueItem.strDesc;
+	item.iPrice = (int)(catalogueItem.iPrice * scale);
+	item.level = catalogueItem.level;
+	item.strClass = catalogueItem.strClass;
+	item.isUnique = catalogueItem.isUnique;
 
 	EntityId inventoryItem = 0;
-	if (strClass)
+	if (catalogueItem.bHasClass)
 	{
 		IActor* pActor = gEnv->pGame->GetIGameFramework()->GetClientActor();
 		if (pActor)
@@ -820,7 +940,7 @@ void CHUDPowerStruggle::CreateItemFromTableEntry(IScriptTable* pItemScriptTable,
 			IInventory* pInventory = pActor->GetInventory();
 			if (pInventory)
 			{
-				IEntityClass* pClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(strClass);
+				IEntityClass* pClass = catalogueItem.pClass;
 				inventoryItem = pInventory->GetItemByClass(pClass);
 
 				if (IItem* pItem = gEnv->pGame->GetIGameFramework()->GetIItemSystem()->GetItem(inventoryItem))
@@ -841,7 +961,7 @@ void CHUDPowerStruggle::CreateItemFromTableEntry(IScriptTable* pItemScriptTable,
 		}
 	}
 	item.iInventoryID = (int)inventoryItem;
-};
+}
 
 
 bool CHUDPowerStruggle::WeaponUseAmmo(CWeapon* pWeapon, IEntityClass* pAmmoType)
@@ -918,28 +1038,6 @@ bool CHUDPowerStruggle::CanUseAmmo(IEntityClass* pAmmoType)
 
 void CHUDPowerStruggle::GetItemList(EBuyMenuPage itemType, std::vector<SItem>& itemList, bool bBuyMenu)
 {
-	const char* list = "weaponList";
-	if (itemType == E_AMMO)
-	{
-		list = "ammoList";
-	}
-	else if (itemType == E_VEHICLES)
-	{
-		list = "vehicleList";
-	}
-	else if (itemType == E_EQUIPMENT)
-	{
-		list = "equipList";
-	}
-	else if (itemType == E_PROTOTYPES)
-	{
-		list = "protoList";
-	}
-
-	SmartScriptTable pItemListScriptTable;
-
-	IScriptTable* pGameRulesScriptTable = m_pGameRules->GetEntity()->GetScriptTable();
-
 	IActor* pActor = gEnv->pGame->GetIGameFramework()->GetClientActor();
 	if (!pActor)
 		return;
@@ -947,148 +1045,100 @@ void CHUDPowerStruggle::GetItemList(EBuyMenuPage itemType, std::vector<SItem>& i
 	if (!pInventory)
 		return;
 
+	UpdateCatalogue();
+
+	const ECatalogueList list = GetCatalogueList(itemType);
+
 	float scale = g_pGameCVars->g_pp_scale_price;
 
-	if (pGameRulesScriptTable && pGameRulesScriptTable->GetValue(list, pItemListScriptTable))
+	for (int i = m_catalogueListStart[list]; i < m_catalogueListStart[list + 1]; ++i)
 	{
-		IScriptTable::Iterator iter = pItemListScriptTable->BeginIteration();
-		while (pItemListScriptTable->MoveNext(iter))
-		{
-			if (ANY_TTABLE != iter.value.type)
-				continue;
-
-			IScriptTable* pItemScriptTable = iter.value.table;
+		const SCatalogueItem& catalogueItem = m_catalogue[i];
 
-			char* strId = NULL;
-			char* strName = NULL;
-			char* strClass = NULL;
-			char* strCategory = NULL;
-			int iPrice = 0;
-			float level = 0.0f;
-			int iUnique = 0;
-			bool bInvisible = false;
-			bool bVehicle = false;
-			bool bAmmoType = false;
-			bool loadout = false;
-			bool special = false;
-			bool vehicleAmmo = false;
-			char* ammoClass = NULL;
-
-			int uniqueGroup = 0;
-			int uniqueCount = 0;
-
-			pItemScriptTable->GetValue("invisible", bInvisible);
-			if (bInvisible)
+		if (catalogueItem.bAmmoType)
+		{
+			if (bBuyMenu && (itemType == E_AMMO) && !CanUseAmmo(catalogueItem.pIdClass))
 				continue;
+		}
 
-			pItemScriptTable->GetValue("id", strId);
-			pItemScriptTable->GetValue("level", level);
-
-			if (pItemScriptTable->GetValue("ammo", bAmmoType) && bAmmoType)
+		SItem item;
+		item.strName = catalogueItem.strName;
+		item.strDesc = catalogueItem.strDesc;
+		item.strClass = catalogueItem.strClass;
+		item.iPrice = (int)(catalogueItem.iPrice * scale);
+		item.level = catalogueItem.level;
+		item.isUnique = catalogueItem.isUnique;
+		item.iCount = 0;
+		item.iMaxCount = 1;
+		item.uniqueLoadoutGroup = catalogueItem.uniqueLoadoutGroup;
+		item.uniqueLoadoutCount = catalogueItem.uniqueLoadoutCount;
+		item.bVehicleType = catalogueItem.bVehicleType;
+		item.strCategory = catalogueItem.strCategory;
+		item.bAmmoType = catalogueItem.bAmmoType;
+		item.loadout = catalogueItem.loadout;
+		item.special = catalogueItem.special;
+		item.isWeapon = false;
+
+		EntityId inventoryItem = 0;
+		bool pistols = false;
+		if (catalogueItem.bHasClass)
+		{
+			IEntityClass* pClass = catalogueItem.pClass;
+			inventoryItem = pInventory->GetItemByClass(pClass);
+			if (catalogueItem.bHasAmmoClass)
 			{
-				IEntityClass* pClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(strId);
-				if (bBuyMenu && (itemType == E_AMMO) && !CanUseAmmo(pClass))
-					continue;
+				item.iMaxCount = pInventory->GetAmmoCapacity(catalogueItem.pAmmoClass);
+				item.iCount = pInventory->GetAmmoCount(catalogueItem.pAmmoClass);
 			}
-
-
-			pItemScriptTable->GetValue("name", strName);
-			pItemScriptTable->GetValue("class", strClass);
-			pItemScriptTable->GetValue("uniqueId", iUnique);
-			pItemScriptTable->GetValue("uniqueloadoutgroup", uniqueGroup);
-			pItemScriptTable->GetValue("uniqueloadoutcount", uniqueCount);
-			pItemScriptTable->GetValue("price", iPrice);
-			pItemScriptTable->GetValue("vehicle", bVehicle);
-			pItemScriptTable->GetValue("category", strCategory);
-			pItemScriptTable->GetValue("loadout", loadout);
-			pItemScriptTable->GetValue("special", special);
-			pItemScriptTable->GetValue("buyammo", ammoClass);
-			pItemScriptTable->GetValue("vehicleammo", vehicleAmmo);
-
-			if (special)
-				loadout = false;
-
-			SItem item;
-			item.strName = strId;
-			item.strDesc = strName;
-			item.strClass = strClass;
-			item.iPrice = (int)(iPrice * scale);
-			item.level = level;
-			item.isUnique = iUnique;
-			item.iCount = 0;
-			item.iMaxCount = 1;
-			item.uniqueLoadoutGroup = uniqueGroup;
-			item.uniqueLoadoutCount = uniqueCount;
-			item.bVehicleType = bVehicle;
-			item.strCategory = strCategory;
-			item.bAmmoType = bAmmoType;
-			item.loadout = loadout;
-			item.special = special;
-			item.isWeapon = false;
-
-			EntityId inventoryItem = 0;
-			bool pistols = false;
-			if (strClass)
+			IItem* pItem = gEnv->pGame->GetIGameFramework()->GetIItemSystem()->GetItem(inventoryItem);
+			if (pItem)
 			{
-				IEntityClass* pClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(strClass);
-				inventoryItem = pInventory->GetItemByClass(pClass);
-				if (ammoClass)
-				{
-					IEntityClass* pAmmoClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(ammoClass);
-					item.iMaxCount = pInventory->GetAmmoCapacity(pAmmoClass);
-					item.iCount = pInventory->GetAmmoCount(pAmmoClass);
-				}
-				IItem* pItem = gEnv->pGame->GetIGameFramework()->GetIItemSystem()->GetItem(inventoryItem);
-				if (pItem)
-				{
-					item.isWeapon = pItem->CanDrop();
+				item.isWeapon = pItem->CanDrop();
 
-					if (pClass == CItem::sSOCOMClass)
-					{
-						pistols = true;
-						bool bSlave = pItem->IsDualWieldSlave();
-						bool bMaster = pItem->IsDualWieldMaster();
-						if (!bSlave && !bMaster)
-							//change to double pistols
-							inventoryItem = -1;
-					}
-					if (!pItem->CanSelect())
-						inventoryItem = -2;
-				}
-				else
+				if (pClass == CItem::sSOCOMClass)
 				{
-					inventoryItem = 0;
+					pistols = true;
+					bool bSlave = pItem->IsDualWieldSlave();
+					bool bMaster = pItem->IsDualWieldMaster();
+					if (!bSlave && !bMaster)
+						//change to double pistols
+						inventoryItem = -1;
 				}
+				if (!pItem->CanSelect())
+					inventoryItem = -2;
 			}
 			else
 			{
-				IEntityClass* pClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(strId);
-				if (pClass)
+				inventoryItem = 0;
+			}
+		}
+		else
+		{
+			IEntityClass* pClass = catalogueItem.pIdClass;
+			if (pClass)
+			{
+				if (catalogueItem.bVehicleAmmo)
 				{
-					if (vehicleAmmo)
-					{
-						IVehicle* pVehicle = pActor->GetLinkedVehicle();
-						if (pVehicle)
-						{
-							item.iMaxCount = pVehicle->GetAmmoCapacity(pClass);
-							item.iCount = pVehicle->GetAmmoCount(pClass);
-						}
-					}
-					else
+					IVehicle* pVehicle = pActor->GetLinkedVehicle();
+					if (pVehicle)
 					{
-						item.iMaxCount = pInventory->GetAmmoCapacity(pClass);
-						item.iCount = pInventory->GetAmmoCount(pClass);
+						item.iMaxCount = pVehicle->GetAmmoCapacity(pClass);
+						item.iCount = pVehicle->GetAmmoCount(pClass);
 					}
 				}
+				else
+				{
+					item.iMaxCount = pInventory->GetAmmoCapacity(pClass);
+					item.iCount = pInventory->GetAmmoCount(pClass);
+				}
 			}
-
-			if (iUnique != 0 || (int)inventoryItem < 0 || pistols)
-				item.iInventoryID = (int)inventoryItem;
-			else
-				item.iInventoryID = 0;
-			itemList.push_back(item);
 		}
-		pItemListScriptTable->EndIteration(iter);
+
+		if (catalogueItem.isUnique != 0 || (int)inventoryItem < 0 || pistols)
+			item.iInventoryID = (int)inventoryItem;
+		else
+			item.iInventoryID = 0;
+		itemList.push_back(item);
 	}
 }
 
@@ -17,6 +17,9 @@ History:
 
 # pragma once
 
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "HUDObject.h"
 #include "HUD.h"
@@ -138,7 +141,6 @@ private:
 	void SavePackage(const char *name, int index = -1);
 	void RequestNewLoadoutName(string &name, const char *bluePrint);
 	bool CheckDoubleLoadoutName(const char *name);
-	void CreateItemFromTableEntry(IScriptTable *pItemScriptTable, SItem &item);
 	bool GetItemFromName(const char *name, SItem &item);
 
 	bool WeaponUseAmmo(CWeapon *pWeapon, IEntityClass* pAmmoType);
@@ -154,8 +156,59 @@ private:
 	void OnSelectPackage(int index);
 	void UpdateModifyPackage(int index);
 
+	//buy lists of the gamerules script
+	enum ECatalogueList
+	{
+		E_LIST_WEAPONS,
+		E_LIST_AMMO,
+		E_LIST_VEHICLES,
+		E_LIST_EQUIPMENT,
+		E_LIST_PROTOTYPES,
+		E_LIST_LAST
+	};
+
+	//script data of a buyable item, the price is not scaled by g_pp_scale_price
+	struct SCatalogueItem
+	{
+		string strName;
+		string strDesc;
+		string strClass;
+		string strCategory;
+		IEntityClass *pClass;
+		IEntityClass *pIdClass;
+		IEntityClass *pAmmoClass;
+		int uniqueLoadoutGroup;
+		int uniqueLoadoutCount;
+		int iPrice;
+		int isUnique;
+		float level;
+		bool bHasClass;
+		bool bHasAmmoClass;
+		bool bAmmoType;
+		bool bVehicleType;
+		bool bVehicleAmmo;
+		bool loadout;
+		bool special;
+	};
+
+	void UpdateCatalogue();
+	void BuildCatalogue(IScriptTable *pGameRulesScriptTable);
+	void ReadCatalogueItem(IScriptTable *pItemScriptTable, SCatalogueItem &item);
+	void CreateItemFromCatalogue(const SCatalogueItem &catalogueItem, SItem &item);
+	static ECatalogueList GetCatalogueList(EBuyMenuPage itemType);
+
 	//****************************************** MEMBER VARIABLES ***********************************
 
+	//buyable items of all lists, in script order
+	std::vector<SCatalogueItem> m_catalogue;
+	//first catalogue item of each list
+	int m_catalogueListStart[E_LIST_LAST + 1];
+	//catalogue index of each item id, the first list wins
+	std::unordered_map<std::string, int> m_catalogueIndex;
+	//script tables the catalogue was built from, any change triggers a rebuild
+	SmartScriptTable m_catalogueTables[E_LIST_LAST + 1];
+	int m_catalogueTableCounts[E_LIST_LAST + 1];
+
 	//current active buy zones
 	std::vector<EntityId> m_currentBuyZones;
 	//current active buy zones
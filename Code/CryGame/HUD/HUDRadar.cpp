@@ -39,6 +39,11 @@ const static float fEntitySize = 4.0f;
 const static float fEntityMaxDistance = fRadarSizeOverTwo - fEntitySize;
 const static float fRadarDefaultRadius = 75.0f;
 
+static bool CompareMapText(const std::pair<EntityId, const char*>& a, const std::pair<EntityId, const char*>& b)
+{
+	return a.first < b.first;
+}
+
 //-----------------------------------------------------------------------------------------------------
 
 CHUDRadar::CHUDRadar(CHUD *pHUD)
@@ -69,7 +74,6 @@ CHUDRadar::CHUDRadar(CHUD *pHUD)
 	m_lookAtTimer = 0.0f;
 	m_scannerObjectID = 0;
 	m_scannerTimer = 0.0f;
-	m_scannerGatherTimer = 0.50f;
 	m_startBroadScanTime = .0f;
 	m_lastScan = 0.0f;
 	m_jammingValue = 0.0f;
@@ -95,6 +99,8 @@ CHUDRadar::CHUDRadar(CHUD *pHUD)
 	m_mapDimX = m_mapDimY = 1;
 
 	m_renderMiniMap = false;
+	m_mapOverlayShown = false;
+	m_shownObjectiveSector = m_shownDeploySpotSector = -1;
 
 	m_bsRadius = 0.0f;
 	m_bsUseParameter = m_bsKeepEntries = false;
@@ -163,7 +169,7 @@ void CHUDRadar::AddTaggedEntity(EntityId iEntityId)
 
 void CHUDRadar::AddEntityToRadar(EntityId id)
 {
-	if (!IsOnRadar(id, 0, m_entitiesOnRadar.size() - 1))
+	if (!IsOnRadar(id))
 	{
 		AddToRadar(id);
 		m_pHUD->OnEntityAddedToRadar(id);
@@ -249,6 +255,7 @@ void CHUDRadar::RemoveFromRadar(EntityId id)
 			if ((*it).m_id == id)
 			{
 				m_entitiesOnRadar.erase(it);
+				m_entitiesOnRadarSet.erase(id);
 				return;
 			}
 		}
@@ -695,7 +702,7 @@ void CHUDRadar::UpdateRadarEntities(CActor* pActor, float& fRadius, Matrix34& pl
 				isOnRadar = mate = true;
 
 			//has the object been scanned already?
-			if (!isOnRadar && IsOnRadar(id, 0, m_entitiesOnRadar.size() - 1))
+			if (!isOnRadar && IsOnRadar(id))
 				isOnRadar = true;
 
 			if (!isOnRadar)	//check whether it's an aggressive (non-vehicle) AI (in possible proximity),
@@ -1109,56 +1116,24 @@ float CHUDRadar::GetRadarSize(IEntity* entity, CActor* actor)
 	return returnValue;
 }
 
-bool CHUDRadar::IsOnRadar(EntityId id, int first, int last)
+bool CHUDRadar::IsOnRadar(EntityId id) const
 {
-	int size = last - first;
-	if (size > 1)
-	{
-		int mid = first + (size / 2);
-		EntityId midId = m_entitiesOnRadar[mid].m_id;
-		if (midId == id)
-			return true;
-		else if (midId > id)
-			return IsOnRadar(id, first, mid - 1);
-		else
-			return IsOnRadar(id, mid + 1, last);
-	}
-	else if (size == 1)
-		return (m_entitiesOnRadar[first].m_id == id || m_entitiesOnRadar[last].m_id == id);
-	else if (m_entitiesOnRadar.size() > 0)
-		return (m_entitiesOnRadar[first].m_id == id);
-	return false;
+	return m_entitiesOnRadarSet.find(id) != m_entitiesOnRadarSet.end();
+}
+
+static bool CompareRadarEntity(const CHUDRadar::RadarEntity& entity, EntityId id)
+{
+	return entity.m_id < id;
 }
 
 void CHUDRadar::AddToRadar(EntityId id)
 {
-	if (m_entitiesOnRadar.size() > 0)
-	{
-		if (m_entitiesOnRadar[0].m_id > id)
-			m_entitiesOnRadar.push_front(RadarEntity(id));
-		else if (m_entitiesOnRadar[m_entitiesOnRadar.size() - 1].m_id < id)
-			m_entitiesOnRadar.push_back(RadarEntity(id));
-		else
-		{
-			std::deque<RadarEntity>::iterator it, itTemp;
-			for (it = m_entitiesOnRadar.begin(); it != m_entitiesOnRadar.end(); ++it)
-			{
-				itTemp = it;
-				itTemp++;
-				if (itTemp != m_entitiesOnRadar.end())
-				{
-					if (it->m_id < id && itTemp->m_id > id)
-					{
-						m_entitiesOnRadar.insert(itTemp, 1, RadarEntity(id));
-						break;
-					}
-				}
-				else { assert(false); }
-			}
-		}
-	}
-	else
-		m_entitiesOnRadar.push_back(RadarEntity(id));
+	if (!m_entitiesOnRadarSet.insert(id).second)
+		return;
+
+	//the list stays sorted by id
+	std::deque<RadarEntity>::iterator it = std::lower_bound(m_entitiesOnRadar.begin(), m_entitiesOnRadar.end(), id, CompareRadarEntity);
+	m_entitiesOnRadar.insert(it, RadarEntity(id));
 }
 
 bool CHUDRadar::ScanObject(EntityId id)
@@ -1193,7 +1168,7 @@ bool CHUDRadar::ScanObject(EntityId id)
 	}
 
 	if (CheckObject(pEntity, id != m_lookAtObjectID, id != m_lookAtObjectID) &&
-		!IsOnRadar(id, 0, m_entitiesOnRadar.size() - 1))
+		!IsOnRadar(id))
 	{
 		m_pHUD->AutoAimNoText(id);
 
@@ -1253,18 +1228,6 @@ void CHUDRadar::UpdateScanner(float frameTime)
 
 		} while (!ScanObject(scanId) && !m_scannerQueue.empty());
 	}
-
-	if (m_scannerGatherTimer > 0.0f)
-	{
-		m_scannerGatherTimer -= frameTime;
-		if (m_scannerGatherTimer <= 0.0f)
-		{
-			m_scannerGatherTimer = 0.0f;
-			//GatherScannableObjects(); // design @GC 2007 : only scan lookat
-
-			m_scannerGatherTimer = 0.50f;
-		}
-	}
 }
 
 void CHUDRadar::Reset()
@@ -1273,9 +1236,11 @@ void CHUDRadar::Reset()
 
 	//remove scanned / tac'd entities
 	m_entitiesOnRadar.clear();
+	m_entitiesOnRadarSet.clear();
 	ResetTaggedEntities();
 	m_tempEntitiesOnRadar.clear();
 	m_storyEntitiesOnRadar.clear();
+	m_radarEntityInfo.clear();
 }
 
 void CHUDRadar::ResetScanner()
@@ -1289,13 +1254,6 @@ void CHUDRadar::ResetScanner()
 	}
 }
 
-bool CHUDRadar::IsObjectInQueue(EntityId id)
-{
-	if (std::find(m_scannerQueue.begin(), m_scannerQueue.end(), id) != m_scannerQueue.end())
-		return true;
-	return false;
-}
-
 bool CHUDRadar::IsNextObject(EntityId id)
 {
 	if (m_scannerQueue.empty())
@@ -1377,55 +1335,6 @@ Vec2i CHUDRadar::GetMapGridPosition(float x, float y)
 	return retVal;
 }
 
-void CHUDRadar::GatherScannableObjects()
-{
-	CActor* pActor = static_cast<CActor*>(m_pClientActor);
-	if (!pActor)
-		return;
-
-	/*IEntityItPtr pIt=gEnv->pEntitySystem->GetEntityIterator();
-
-	while (!pIt->IsEnd())
-	{
-		if (IEntity *pEntity=pIt->Next())
-		{
-			EntityId id=pEntity->GetId();
-			if (CheckObject(pEntity, true, false) && !IsOnRadar(id, 0, m_entitiesOnRadar.size()-1) && !IsObjectInQueue(id))
-				m_scannerQueue.push_back(id);
-		}
-	}*/
-
-	int count = m_pActorSystem->GetActorCount();
-	if (count > 0)
-	{
-		IActorIteratorPtr pIter = m_pActorSystem->CreateActorIterator();
-		while (IActor* pActor = pIter->Next())
-		{
-			if (IEntity* pEntity = pActor->GetEntity())
-			{
-				EntityId id = pEntity->GetId();
-				if (CheckObject(pEntity, true, false) && !IsOnRadar(id, 0, m_entitiesOnRadar.size() - 1) && !IsObjectInQueue(id))
-					m_scannerQueue.push_back(id);
-			}
-		}
-	}
-
-	count = m_pVehicleSystem->GetVehicleCount();
-	if (count > 0)
-	{
-		IVehicleIteratorPtr pIter = m_pVehicleSystem->CreateVehicleIterator();
-		while (IVehicle* pVehicle = pIter->Next())
-		{
-			if (IEntity* pEntity = pVehicle->GetEntity())
-			{
-				EntityId id = pEntity->GetId();
-				if (CheckObject(pEntity, true, false) && !IsOnRadar(id, 0, m_entitiesOnRadar.size() - 1) && !IsObjectInQueue(id))
-					m_scannerQueue.push_back(id);
-			}
-		}
-	}
-}
-
 //-----------------------------------------------------------------------------------------------------
 bool CHUDRadar::GetPosOnMap(float inX, float inY, float& outX, float& outY, bool flashCoordinates)
 {
@@ -1517,6 +1426,8 @@ void CHUDRadar::OnLoadingComplete(ILevel* pLevel)
 		m_pLevelData = pLevel;
 	}
 
+	m_capturableProperties.clear();
+	InvalidateMapOverlay();
 	RenderMapOverlay();
 	SetMiniMapTexture(m_mapId, true);
 }
@@ -1685,24 +1596,26 @@ void CHUDRadar::LoadMiniMap(const char* mapPath)
 void CHUDRadar::RenderMapOverlay()
 {
 	CGameFlashAnimation* m_flashMap = m_flashPDA;
-	if (!m_flashMap || !m_flashMap->IsAvailable("Root.PDAArea.Map_M.MapArea"))
-		return;
-	if (m_jammerDisconnectMap)
+	if (!m_flashMap || !m_flashMap->IsAvailable("Root.PDAArea.Map_M.MapArea") || m_jammerDisconnectMap)
+	{
+		InvalidateMapOverlay();
 		return;
+	}
 	//LoadMiniMap(m_currentLevel);
 
 	m_possibleOnScreenObjectives.resize(0);
 	//double array buffer for flash transfer optimization
-	std::vector<double> entityValues;
+	std::vector<double>& entityValues = m_mapValues;
+	entityValues.resize(0);
 	int numOfValues = 0;
 	//array of text strings
-	std::map<EntityId, string> textOnMap;
+	m_mapTexts.resize(0);
 
 	float fX = 0;
 	float fY = 0;
 
 	//draw vehicles only once
-	std::map<EntityId, bool> drawnVehicles;
+	m_mapDrawnVehicles.resize(0);
 
 	//the local player
 	CActor* pActor = static_cast<CActor*>(m_pClientActor);
@@ -1716,12 +1629,7 @@ void CHUDRadar::RenderMapOverlay()
 		if (pEntity)
 		{
 			GetPosOnMap(pEntity, fX, fY);
-			char strCoords[32];
-			float value = ceil(fX * 8.0f);
-
-			int index = min(int(fY / 0.125f), 7);
-			sprintf(strCoords, m_coordinateToString[index].c_str(), (int)value);
-			m_flashMap->CheckedSetVariable("Root.PDAArea.TextBottom.Colorset.ObjectiveText.text", strCoords);
+			SetMapSectorText("Root.PDAArea.TextBottom.Colorset.ObjectiveText.text", fX, fY, m_shownObjectiveSector);
 		}
 	}
 	EntityId iCurrentSpawnPoint = m_pGameRules->GetPlayerSpawnGroup(pActor);
@@ -1731,12 +1639,7 @@ void CHUDRadar::RenderMapOverlay()
 		if (pEntity)
 		{
 			GetPosOnMap(pEntity, fX, fY);
-			char strCoords[3];
-			float value = ceil(fX * 8.0f);
-
-			int index = min(int(fY / 0.125f), 7);
-			sprintf(strCoords, m_coordinateToString[index].c_str(), (int)value);
-			m_flashMap->CheckedSetVariable("Root.PDAArea.TextBottom.Colorset.DeploySpotText.text", strCoords);
+			SetMapSectorText("Root.PDAArea.TextBottom.Colorset.DeploySpotText.text", fX, fY, m_shownDeploySpotSector);
 		}
 	}
 
@@ -1755,18 +1658,15 @@ void CHUDRadar::RenderMapOverlay()
 			bool addBuilding = true;
 			if (friendly == 2)
 			{
-				SmartScriptTable props;
-				if (pEntity->GetScriptTable() && pEntity->GetScriptTable()->GetValue("Properties", props))
+				const CapturableProperty& capturable = GetCapturableProperty(pEntity);
+				if (capturable.m_isBool)
 				{
-					int capturable = 0;
-					if (props->GetValue("bCapturable", addBuilding))
+					addBuilding = capturable.m_value != 0;
+					if (!addBuilding)
 					{
-						if (!addBuilding)
+						if (m_pGameRules->IsSameTeam(pActor->GetEntityId(), pEntity->GetId()))
 						{
-							if (m_pGameRules->IsSameTeam(pActor->GetEntityId(), pEntity->GetId()))
-							{
-								addBuilding = true;
-							}
+							addBuilding = true;
 						}
 					}
 				}
@@ -1796,10 +1696,10 @@ void CHUDRadar::RenderMapOverlay()
 	if (isMultiplayer)
 	{
 		//special units
-		const std::vector<CGameRules::SMinimapEntity> synchEntities = m_pGameRules->GetMinimapEntities();
+		const std::vector<CGameRules::SMinimapEntity>& synchEntities = m_pGameRules->GetMinimapEntities();
 		for (int m = 0; m < synchEntities.size(); ++m)
 		{
-			CGameRules::SMinimapEntity mEntity = synchEntities[m];
+			const CGameRules::SMinimapEntity& mEntity = synchEntities[m];
 			FlashRadarType type = GetSynchedEntityType(mEntity.type);
 			IEntity* pEntity = NULL;
 			if (type == ENuclearWeapon || type == ETechCharger)	//might be a gun
@@ -1818,7 +1718,7 @@ void CHUDRadar::RenderMapOverlay()
 				int friendly = FriendOrFoe(isMultiplayer, team, pEntity, m_pGameRules);
 				if (friendly == EFriend || friendly == ENeutral)
 				{
-					if (type == EAmmoTruck && stl::find_in_map(drawnVehicles, mEntity.entityId, false))
+					if (type == EAmmoTruck && IsVehicleDrawn(mEntity.entityId))
 					{
 						numOfValues += FillUpDoubleArray(&entityValues, pEntity->GetId(), EBarracks, fX, fY, 270.0f - RAD2DEG(pEntity->GetWorldAngles().z), friendly, 100, 100, iOnScreenObjective == mEntity.entityId, iCurrentSpawnPoint == mEntity.entityId);
 					}
@@ -1842,11 +1742,11 @@ void CHUDRadar::RenderMapOverlay()
 				{
 					if (IVehicle* pVehicle = pTempActor->GetLinkedVehicle())
 					{
-						if (!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+						if (!IsVehicleDrawn(pVehicle->GetEntityId()))
 						{
 							GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 							numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ETaggedEntity, fX, fY, 270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), ENeutral, 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-							drawnVehicles[pVehicle->GetEntityId()] = true;
+							SetVehicleDrawn(pVehicle->GetEntityId());
 						}
 					}
 					else
@@ -1857,11 +1757,11 @@ void CHUDRadar::RenderMapOverlay()
 				}
 				else if (IVehicle* pVehicle = m_pVehicleSystem->GetVehicle(id))
 				{
-					if (!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+					if (!IsVehicleDrawn(pVehicle->GetEntityId()))
 					{
 						GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 						numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ETaggedEntity, fX, fY, 270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), ENeutral, 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-						drawnVehicles[pVehicle->GetEntityId()] = true;
+						SetVehicleDrawn(pVehicle->GetEntityId());
 					}
 				}
 			}
@@ -1877,12 +1777,12 @@ void CHUDRadar::RenderMapOverlay()
 			{
 				if (IVehicle* pVehicle = pTempActor->GetLinkedVehicle())
 				{
-					if (!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+					if (!IsVehicleDrawn(pVehicle->GetEntityId()))
 					{
 						GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 						numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ChooseType(pVehicle->GetEntity(), false), fX, fY,
 							270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), FriendOrFoe(isMultiplayer, team, pVehicle->GetEntity(), m_pGameRules), 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-						drawnVehicles[pVehicle->GetEntityId()] = true;
+						SetVehicleDrawn(pVehicle->GetEntityId());
 					}
 				}
 				else
@@ -1894,12 +1794,12 @@ void CHUDRadar::RenderMapOverlay()
 			}
 			else if (IVehicle* pVehicle = m_pVehicleSystem->GetVehicle(id))
 			{
-				if (!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+				if (!IsVehicleDrawn(pVehicle->GetEntityId()))
 				{
 					GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 					numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ChooseType(pVehicle->GetEntity(), false), fX, fY,
 						270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), FriendOrFoe(isMultiplayer, team, pVehicle->GetEntity(), m_pGameRules), 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-					drawnVehicles[pVehicle->GetEntityId()] = true;
+					SetVehicleDrawn(pVehicle->GetEntityId());
 				}
 			}
 		}
@@ -1916,7 +1816,7 @@ void CHUDRadar::RenderMapOverlay()
 				numOfValues += FillUpDoubleArray(&entityValues, id, m_storyEntitiesOnRadar[e].m_type, fX, fY,
 					270.0f - RAD2DEG(pEntity->GetWorldAngles().z), ENeutral, 100, 100, iOnScreenObjective == id, iCurrentSpawnPoint == id);
 				if (!m_storyEntitiesOnRadar[e].m_text.empty())
-					textOnMap[id] = m_storyEntitiesOnRadar[e].m_text;
+					m_mapTexts.push_back(std::make_pair(id, m_storyEntitiesOnRadar[e].m_text.c_str()));
 			}
 		}
 	}
@@ -1932,11 +1832,11 @@ void CHUDRadar::RenderMapOverlay()
 			{
 				if (IVehicle* pVehicle = pTempActor->GetLinkedVehicle())
 				{
-					if (!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+					if (!IsVehicleDrawn(pVehicle->GetEntityId()))
 					{
 						GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 						numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ChooseType(pVehicle->GetEntity()), fX, fY, 270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), EFriend, 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-						drawnVehicles[pVehicle->GetEntityId()] = true;
+						SetVehicleDrawn(pVehicle->GetEntityId());
 					}
 				}
 				else
@@ -1956,7 +1856,7 @@ void CHUDRadar::RenderMapOverlay()
 							{
 								if (m_selectedTeamMates[i] == id)
 								{
-									textOnMap[id] = pTempActor->GetEntity()->GetName();
+									m_mapTexts.push_back(std::make_pair(id, pTempActor->GetEntity()->GetName()));
 									break;
 								}
 							}
@@ -1985,12 +1885,12 @@ void CHUDRadar::RenderMapOverlay()
 			IVehicle* pVehicle = pTempActor->GetLinkedVehicle();
 			if (pVehicle && !pVehicle->IsDestroyed())
 			{
-				if (!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+				if (!IsVehicleDrawn(pVehicle->GetEntityId()))
 				{
 					GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 					int friendly = FriendOrFoe(isMultiplayer, team, pVehicle->GetEntity(), m_pGameRules);
 					numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ChooseType(pVehicle->GetEntity()), fX, fY, 270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), friendly, 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-					drawnVehicles[pVehicle->GetEntityId()] = true;
+					SetVehicleDrawn(pVehicle->GetEntityId());
 				}
 			}
 			else
@@ -2002,7 +1902,7 @@ void CHUDRadar::RenderMapOverlay()
 		}
 		else if (IVehicle* pVehicle = m_pVehicleSystem->GetVehicle(uiEntityId))
 		{
-			if (!stl::find_in_map(drawnVehicles, uiEntityId, false))
+			if (!IsVehicleDrawn(uiEntityId))
 			{
 				if (pVehicle->IsDestroyed())
 				{
@@ -2013,7 +1913,7 @@ void CHUDRadar::RenderMapOverlay()
 				int friendly = FriendOrFoe(isMultiplayer, team, pEntity, m_pGameRules);
 				GetPosOnMap(pEntity, fX, fY);
 				numOfValues += FillUpDoubleArray(&entityValues, uiEntityId, ChooseType(pEntity), fX, fY, 270.0f - RAD2DEG(pEntity->GetWorldAngles().z), friendly, 100, 100, iOnScreenObjective == uiEntityId, iCurrentSpawnPoint == uiEntityId);
-				drawnVehicles[uiEntityId] = true;
+				SetVehicleDrawn(uiEntityId);
 			}
 		}
 	}
@@ -2023,13 +1923,13 @@ void CHUDRadar::RenderMapOverlay()
 	{
 		if (IVehicle* pVehicle = pActor->GetLinkedVehicle())
 		{
-			//if(!stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false))
+			//if(!IsVehicleDrawn(pVehicle->GetEntityId()))
 			//{
 			GetPosOnMap(pVehicle->GetEntity(), fX, fY);
 			vPlayerPos.x = fX;
 			vPlayerPos.y = fY;
 			numOfValues += FillUpDoubleArray(&entityValues, pVehicle->GetEntity()->GetId(), ChooseType(pVehicle->GetEntity()), fX, fY, 270.0f - RAD2DEG(pVehicle->GetEntity()->GetWorldAngles().z), ESelf, 100, 100, iOnScreenObjective == pVehicle->GetEntity()->GetId(), iCurrentSpawnPoint == pVehicle->GetEntity()->GetId());
-			drawnVehicles[pVehicle->GetEntityId()] = true;
+			SetVehicleDrawn(pVehicle->GetEntityId());
 			//}
 		}
 	}
@@ -2037,7 +1937,7 @@ void CHUDRadar::RenderMapOverlay()
 	if (isMultiplayer)
 	{
 		//now spawn points
-		std::vector<EntityId> locations;
+		std::vector<EntityId>& locations = m_mapSpawnGroups;
 		m_pGameRules->GetSpawnGroups(locations);
 		for (int i = 0; i < locations.size(); ++i)
 		{
@@ -2051,12 +1951,12 @@ void CHUDRadar::RenderMapOverlay()
 				if (GetPosOnMap(pEntity, fX, fY))
 				{
 					int friendly = FriendOrFoe(isMultiplayer, team, pEntity, m_pGameRules);
-					if (isVehicle /*&& !stl::find_in_map(drawnVehicles, pVehicle->GetEntityId(), false)*/)
+					if (isVehicle /*&& !IsVehicleDrawn(pVehicle->GetEntityId())*/)
 					{
 						if (friendly == EFriend)
 						{
 							numOfValues += FillUpDoubleArray(&entityValues, pEntity->GetId(), ESpawnTruck, fX, fY, 270.0f - RAD2DEG(pEntity->GetWorldAngles().z), friendly, 100, 100, iOnScreenObjective == locations[i], iCurrentSpawnPoint == locations[i]);
-							drawnVehicles[pVehicle->GetEntityId()] = true;
+							SetVehicleDrawn(pVehicle->GetEntityId());
 						}
 					}
 					else
@@ -2069,15 +1969,11 @@ void CHUDRadar::RenderMapOverlay()
 						}
 						else
 						{
-							SmartScriptTable props;
-							if (pEntity->GetScriptTable() && pEntity->GetScriptTable()->GetValue("Properties", props))
+							const CapturableProperty& capturable = GetCapturableProperty(pEntity);
+							if (capturable.m_isNumber && capturable.m_value)
 							{
-								int capturable = 0;
-								if (props->GetValue("bCapturable", capturable) && capturable)
-								{
-									numOfValues += FillUpDoubleArray(&entityValues, pEntity->GetId(), ESpawnPoint, fX, fY, 270.0f - RAD2DEG(pEntity->GetWorldAngles().z), friendly, 100, 100, iOnScreenObjective == locations[i], iCurrentSpawnPoint == locations[i], underAttack);
-									m_possibleOnScreenObjectives.push_back(pEntity->GetId());
-								}
+								numOfValues += FillUpDoubleArray(&entityValues, pEntity->GetId(), ESpawnPoint, fX, fY, 270.0f - RAD2DEG(pEntity->GetWorldAngles().z), friendly, 100, 100, iOnScreenObjective == locations[i], iCurrentSpawnPoint == locations[i], underAttack);
+								m_possibleOnScreenObjectives.push_back(pEntity->GetId());
 							}
 						}
 					}
@@ -2094,8 +1990,8 @@ void CHUDRadar::RenderMapOverlay()
 			GetPosOnMap(pActor->GetEntity(), fX, fY);
 			vPlayerPos.x = fX;
 			vPlayerPos.y = fY;
-			string name(pActor->GetEntity()->GetName());
-			numOfValues += FillUpDoubleArray(&entityValues, pActor->GetEntity()->GetId(), (name.find("Quarantine", 0) != string::npos) ? ENuclearWeapon : EPlayer, fX, fY, 270.0f - RAD2DEG(pActor->GetEntity()->GetWorldAngles().z), ESelf, 100, 100, iOnScreenObjective == pActor->GetEntity()->GetId(), iCurrentSpawnPoint == pActor->GetEntity()->GetId());
+			const bool quarantine = strstr(pActor->GetEntity()->GetName(), "Quarantine") != NULL;
+			numOfValues += FillUpDoubleArray(&entityValues, pActor->GetEntity()->GetId(), quarantine ? ENuclearWeapon : EPlayer, fX, fY, 270.0f - RAD2DEG(pActor->GetEntity()->GetWorldAngles().z), ESelf, 100, 100, iOnScreenObjective == pActor->GetEntity()->GetId(), iCurrentSpawnPoint == pActor->GetEntity()->GetId());
 		}
 	}
 
@@ -2111,7 +2007,7 @@ void CHUDRadar::RenderMapOverlay()
 			if (GetPosOnMap(pEntity, fX, fY))
 			{
 				numOfValues += FillUpDoubleArray(&entityValues, pEntity->GetId(), (it->second.secondaryObjective) ? ESecondaryObjective : EWayPoint, fX, fY, 180.0f, ENeutral, 100, 100, iOnScreenObjective == it->first, iCurrentSpawnPoint == it->first);
-				textOnMap[pEntity->GetId()] = it->second.text;
+				m_mapTexts.push_back(std::make_pair(pEntity->GetId(), it->second.text.c_str()));
 			}
 		}
 	}
@@ -2119,18 +2015,106 @@ void CHUDRadar::RenderMapOverlay()
 
 	ComputePositioning(vPlayerPos, &entityValues);
 
+	//texts are sent ordered by entity, a later text of the same entity replaces the earlier one
+	std::stable_sort(m_mapTexts.begin(), m_mapTexts.end(), CompareMapText);
+	int numOfTexts = 0;
+	for (int i = 0; i < m_mapTexts.size(); ++i)
+	{
+		if (i + 1 < m_mapTexts.size() && m_mapTexts[i + 1].first == m_mapTexts[i].first)
+			continue;
+		m_mapTexts[numOfTexts++] = m_mapTexts[i];
+	}
+	m_mapTexts.resize(numOfTexts);
+
+	//nothing moved on the map, flash still shows the same overlay
+	bool changed = !m_mapOverlayShown || entityValues != m_shownMapValues || m_mapTexts.size() != m_shownMapTexts.size();
+	for (int i = 0; !changed && i < m_mapTexts.size(); ++i)
+		changed = m_mapTexts[i].first != m_shownMapTexts[i].first || m_shownMapTexts[i].second != m_mapTexts[i].second;
+	if (!changed)
+		return;
+
 	//tell flash file that we are done ...
 	//m_flashMap->Invoke("updateObjects", "");
 	if (entityValues.size())
 		m_flashMap->GetFlashPlayer()->SetVariableArray(FVAT_Double, "Root.PDAArea.Map_M.MapArea.m_allValues", 0, &entityValues[0], numOfValues);
 	m_flashMap->Invoke("Root.PDAArea.Map_M.MapArea.setObjectArray");
 	//render text strings
-	std::map<EntityId, string>::const_iterator itText = textOnMap.begin();
-	for (; itText != textOnMap.end(); ++itText)
+	m_shownMapTexts.resize(m_mapTexts.size());
+	for (int i = 0; i < m_mapTexts.size(); ++i)
 	{
-		SFlashVarValue args[2] = { itText->first, itText->second.c_str() };
+		SFlashVarValue args[2] = { m_mapTexts[i].first, m_mapTexts[i].second };
 		m_flashMap->Invoke("Root.PDAArea.Map_M.MapArea.setText", args, 2);
+		m_shownMapTexts[i].first = m_mapTexts[i].first;
+		m_shownMapTexts[i].second = m_mapTexts[i].second;
 	}
+	m_shownMapValues = entityValues;
+	m_mapOverlayShown = true;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void CHUDRadar::InvalidateMapOverlay()
+{
+	m_mapOverlayShown = false;
+	m_shownObjectiveSector = m_shownDeploySpotSector = -1;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void CHUDRadar::SetMapSectorText(const char* variable, float x, float y, int& shownSector)
+{
+	int index = min(int(y / 0.125f), 7);
+	int value = (int)ceil(x * 8.0f);
+	int sector = index * 256 + value;
+	if (sector == shownSector)
+		return;
+	shownSector = sector;
+
+	char strCoords[32];
+	sprintf(strCoords, m_coordinateToString[index].c_str(), value);
+	m_flashPDA->CheckedSetVariable(variable, strCoords);
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+bool CHUDRadar::IsVehicleDrawn(EntityId id) const
+{
+	return std::binary_search(m_mapDrawnVehicles.begin(), m_mapDrawnVehicles.end(), id);
+}
+
+void CHUDRadar::SetVehicleDrawn(EntityId id)
+{
+	std::vector<EntityId>::iterator it = std::lower_bound(m_mapDrawnVehicles.begin(), m_mapDrawnVehicles.end(), id);
+	if (it == m_mapDrawnVehicles.end() || *it != id)
+		m_mapDrawnVehicles.insert(it, id);
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+const CHUDRadar::CapturableProperty& CHUDRadar::GetCapturableProperty(IEntity* pEntity)
+{
+	const CapturableProperty key(pEntity->GetId());
+	std::vector<CapturableProperty>::iterator it = std::lower_bound(m_capturableProperties.begin(), m_capturableProperties.end(), key);
+	if (it != m_capturableProperties.end() && it->m_id == key.m_id)
+		return *it;
+
+	CapturableProperty property(key);
+	SmartScriptTable props;
+	if (pEntity->GetScriptTable() && pEntity->GetScriptTable()->GetValue("Properties", props))
+	{
+		bool isCapturable = false;
+		if (props->GetValue("bCapturable", isCapturable))
+		{
+			property.m_isBool = true;
+			property.m_value = isCapturable;
+		}
+		else if (props->GetValue("bCapturable", property.m_value))
+		{
+			property.m_isNumber = true;
+		}
+	}
+
+	return *m_capturableProperties.insert(it, property);
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -2263,6 +2247,7 @@ void CHUDRadar::ComputePositioning(Vec2 playerpos, std::vector<double>* doubleAr
 void CHUDRadar::InitMap()
 {
 	m_initMap = true;
+	InvalidateMapOverlay();
 	m_vPDATempMapTranslation = Vec2(0, 0);
 }
 
@@ -2318,6 +2303,12 @@ void CHUDRadar::Serialize(TSerialize ser)
 			ser.Value("id", m_entitiesOnRadar[h].m_id);
 			ser.EndGroup();
 		}
+		if (ser.IsReading())
+		{
+			m_entitiesOnRadarSet.clear();
+			for (int h = 0; h < amount; ++h)
+				m_entitiesOnRadarSet.insert(m_entitiesOnRadar[h].m_id);
+		}
 
 		amount = m_storyEntitiesOnRadar.size();
 		ser.Value("AmountOfStoryEntities", amount);
@@ -2453,6 +2444,61 @@ FlashRadarType CHUDRadar::ChooseType(IEntity* pEntity, bool radarOnly)
 {
 	if (!pEntity)
 		return EFirstType;
+
+	FlashRadarType returnType = GetRadarEntityInfo(pEntity).m_type;
+
+	if (radarOnly)
+	{
+		if (returnType == EPlayer)
+			returnType = ETank; //1
+		else if (returnType == EHeli)
+			returnType = EAPC; //2
+		else if (returnType == EINVALID1) //currently big aliens like hunter
+			returnType = ETank;
+		else
+			returnType = ECivilCar; //3
+	}
+
+	return returnType;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+const CHUDRadar::RadarEntityInfo& CHUDRadar::GetRadarEntityInfo(IEntity* pEntity)
+{
+	IEntityClass* pClass = pEntity->GetClass();
+	const int team = m_pGameRules ? m_pGameRules->GetTeam(pEntity->GetId()) : 0;
+
+	RadarEntityInfo& info = m_radarEntityInfo[pEntity->GetId()];
+	if (info.m_pClass != pClass || info.m_team != team)
+	{
+		bool isFinal = true;
+		info.m_type = ComputeType(pEntity, isFinal);
+		info.m_pClass = isFinal ? pClass : NULL;	//factories are resolved again once the PowerStruggle HUD exists
+		info.m_team = team;
+	}
+
+	return info;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void CHUDRadar::PruneRadarEntityInfo()
+{
+	std::map<EntityId, RadarEntityInfo>::iterator it = m_radarEntityInfo.begin();
+	while (it != m_radarEntityInfo.end())
+	{
+		if (gEnv->pEntitySystem->GetEntity(it->first))
+			++it;
+		else
+			it = m_radarEntityInfo.erase(it);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+FlashRadarType CHUDRadar::ComputeType(IEntity* pEntity, bool& isFinal)
+{
 	const IEntityClass* pCls = pEntity->GetClass();
 	const char* cls = pCls->GetName();
 	const char* name = pEntity->GetName();
@@ -2497,7 +2543,11 @@ FlashRadarType CHUDRadar::ChooseType(IEntity* pEntity, bool radarOnly)
 		else
 			returnType = EHeadquarter;
 	}
-	else if (!stricmp(cls, "Factory") && m_pHUD->GetPowerStruggleHUD())	//this should be much bigger and choose out of the different factory versions (not yet existing)
+	else if (!stricmp(cls, "Factory") && !m_pHUD->GetPowerStruggleHUD())
+	{
+		isFinal = false;
+	}
+	else if (!stricmp(cls, "Factory"))	//this should be much bigger and choose out of the different factory versions (not yet existing)
 	{
 		if (m_pHUD->GetPowerStruggleHUD()->CanBuild(pEntity, "ustank"))
 		{
@@ -2524,17 +2574,6 @@ FlashRadarType CHUDRadar::ChooseType(IEntity* pEntity, bool radarOnly)
 	{
 		returnType = EAlienEnergySource;
 	}
-	if (radarOnly)
-	{
-		if (returnType == EPlayer)
-			returnType = ETank; //1
-		else if (returnType == EHeli)
-			returnType = EAPC; //2
-		else if (returnType == EINVALID1) //currently big aliens like hunter
-			returnType = ETank;
-		else
-			returnType = ECivilCar; //3
-	}
 
 	return returnType;
 }
@@ -2654,7 +2693,7 @@ void CHUDRadar::StartBroadScan(bool useParameters, bool keepEntities, Vec3 pos,
 	for (const EntityId id : m_entitiesInProximity)
 	{
 		IEntity* pEntity = gEnv->pEntitySystem->GetEntity(id);
-		if (IsOnRadar(id, 0, m_entitiesOnRadar.size() - 1) || IsEntityTagged(id))
+		if (IsOnRadar(id) || IsEntityTagged(id))
 			continue;
 		if (stl::find(m_teamMates, id))
 			continue;
@@ -2669,6 +2708,7 @@ void CHUDRadar::GetMemoryStatistics(ICrySizer* s)
 {
 	s->Add(*this);
 	s->AddContainer(m_scannerQueue);
+	s->AddContainer(m_entitiesOnRadarSet);
 	s->AddContainer(m_teamMates);
 	s->AddContainer(m_entitiesInProximity);
 	s->AddContainer(m_itemsInProximity);
@@ -2676,6 +2716,14 @@ void CHUDRadar::GetMemoryStatistics(ICrySizer* s)
 	s->AddContainer(m_storyEntitiesOnRadar);
 	s->AddContainer(m_entitiesOnRadar);
 	s->AddContainer(m_soundsOnRadar);
+	s->AddContainer(m_radarEntityInfo);
+	s->AddContainer(m_mapValues);
+	s->AddContainer(m_mapTexts);
+	s->AddContainer(m_mapDrawnVehicles);
+	s->AddContainer(m_mapSpawnGroups);
+	s->AddContainer(m_shownMapValues);
+	s->AddContainer(m_shownMapTexts);
+	s->AddContainer(m_capturableProperties);
 	s->AddContainer(m_buildingsOnRadar);
 	s->AddContainer(m_missionObjectives);
 	for (std::map<EntityId, RadarObjective>::iterator iter = m_missionObjectives.begin(); iter != m_missionObjectives.end(); ++iter)
@@ -2758,6 +2806,8 @@ void CHUDRadar::ScanProximity(Vec3& pos, float& radius)
 				m_entitiesInProximity.push_back(id);	//create a list of all nearby entities
 		}
 	}
+	//drop cached icon data of entities removed since the last scan
+	PruneRadarEntityInfo();
 }
 
 EntityId CHUDRadar::RayCastBinoculars(CPlayer* pPlayer, ray_hit* pRayHit)
@@ -2983,7 +3033,7 @@ void CHUDRadar::UpdateBinoculars(CActor* pActor, float fDeltaTime)
 					}
 					else
 					{
-						if (!IsOnRadar(lookAtObjectID, 0, m_entitiesOnRadar.size() - 1) && !IsNextObject(lookAtObjectID))
+						if (!IsOnRadar(lookAtObjectID) && !IsNextObject(lookAtObjectID))
 							m_scannerQueue.push_front(lookAtObjectID);
 					}
 				}
@@ -19,6 +19,8 @@ History:
 #include "HUDObject.h"
 #include <deque>
 #include <list>
+#include <map>
+#include <unordered_set>
 
 class CGameFlashAnimation;
 struct IActor;
@@ -30,7 +32,7 @@ template<typename T, EFlashVariableArrayType flashType, int NUM_VALS> struct Arr
 
 const static int NUM_TAGGED_ENTITIES = 4;
 const static int NUM_MAP_TEXTURES = 8;
-const static int NUM_ARRAY_FILL_HELPER_SIZE = 100;
+const static int NUM_ARRAY_FILL_HELPER_SIZE = 11 * 64;	//64 icons per flash call
 
 //-----------------------------------------------------------------------------------------------------
 
@@ -87,6 +89,28 @@ public:
 		}
 	};
 
+	//derived icon data of an entity, recomputed only when its class or team changes
+	struct RadarEntityInfo
+	{
+		IEntityClass	*m_pClass;
+		int						m_team;
+		FlashRadarType m_type;
+		RadarEntityInfo() : m_pClass(NULL), m_team(0), m_type(EFirstType)
+		{}
+	};
+
+	struct CapturableProperty
+	{
+		EntityId	m_id;
+		bool			m_isBool;		//set as boolean (buildings)
+		bool			m_isNumber;	//set as number (spawn points)
+		int				m_value;
+		CapturableProperty(EntityId id = 0) : m_id(id), m_isBool(false), m_isNumber(false), m_value(0)
+		{}
+		bool operator<(const CapturableProperty &other) const
+		{ return m_id < other.m_id; }
+	};
+
 	struct RadarObjective
 	{
 		string text;
@@ -126,7 +150,7 @@ public:
 	//this can be used to get the minimap description for a entity id
 	const char* GetObjectiveDescription(EntityId id);
 	//sets the flash pda
-	void SetFlashPDA(CGameFlashAnimation *flashPDA) {m_flashPDA = flashPDA;}
+	void SetFlashPDA(CGameFlashAnimation *flashPDA) {m_flashPDA = flashPDA; InvalidateMapOverlay();}
 	//sets the flash Radar
 	void SetFlashRadar(CGameFlashAnimation *flashRadar) {m_flashRadar = flashRadar;}
 	//return nearby entities (non-item)
@@ -209,23 +233,30 @@ private:
 	void UpdateRadarJammer(CActor *pActor);
 
 	float					GetRadarSize(IEntity* entity, class CActor* actor);
-	bool					IsOnRadar(EntityId id, int first, int last);
+	bool					IsOnRadar(EntityId id) const;
 	void					AddToRadar(EntityId id);
 	bool					ScanObject(EntityId id);
-	bool					IsObjectInQueue(EntityId id);
 	bool					IsNextObject(EntityId id);
 	bool					CheckObject(IEntity *pEntity, bool checkVelocity=false, bool checkVisibility=false);
 	void					UpdateScanner(float frameTime);
 	void					ResetScanner();
-	void					GatherScannableObjects();
 	EntityId			RayCastBinoculars(CPlayer *pPlayer,ray_hit *pRayHit);
 	void					UpdateBinoculars(CActor *pActor, float fDeltaTime);
 	bool					CheckObjectMultiplayer(EntityId id);	// additional checks to see if this object is worth looking at in MP.
 
 	//activate minimap rendering
-	ILINE void SetRenderMapOverlay(bool bActive) {	m_renderMiniMap = bActive;}
+	ILINE void SetRenderMapOverlay(bool bActive) {	m_renderMiniMap = bActive; InvalidateMapOverlay();}
 	//renders player position, AI positions and structures on the overview map (should be replaced in flash)
 	void RenderMapOverlay();
+	//forces the next map overlay to be sent to flash
+	void InvalidateMapOverlay();
+	//sets the sector text ("A1" ...) of a map position, only if the sector changed
+	void SetMapSectorText(const char *variable, float x, float y, int &shownSector);
+	//vehicles already drawn in this map overlay
+	bool IsVehicleDrawn(EntityId id) const;
+	void SetVehicleDrawn(EntityId id);
+	//returns the "bCapturable" property of a building or spawn point (cached per level)
+	const CapturableProperty &GetCapturableProperty(IEntity *pEntity);
 	//get an entity's position on the minimap
 	bool GetPosOnMap(float inX, float inY, float &outX, float &outY, bool flashCoordinates = true);
 	bool GetPosOnMap(IEntity *pEntity, float &outX, float &outY, bool flashCoordinates = true);
@@ -235,6 +266,12 @@ private:
 	void ComputeMiniMapResolution();
 	//chooses the right icon for a given vehicle or building entity (class)
 	FlashRadarType ChooseType(IEntity* pEntity, bool radarOnly = false);
+	//computes the icon of an entity without the cache, isFinal is false if it may change once the HUD is complete
+	FlashRadarType ComputeType(IEntity* pEntity, bool &isFinal);
+	//returns the cached icon data of an entity, invalidated on class or team change
+	const RadarEntityInfo &GetRadarEntityInfo(IEntity* pEntity);
+	//removes cached icon data of entities which don't exist anymore
+	void PruneRadarEntityInfo();
 	//chooses the right icon for a given synched entity type (ammo trucks, tac tanks ... special mp units)
 	FlashRadarType GetSynchedEntityType(int type);
 	//return whether the entity is friend or foe to the player
@@ -264,7 +301,6 @@ private:
 	float			m_scannerTimer;
 	float			m_startBroadScanTime;
 	std::deque<EntityId> m_scannerQueue;
-	float			m_scannerGatherTimer;
 	//team / squad mates
 	std::vector<EntityId> m_teamMates;
 	//in MP there is an enemy nearby
@@ -327,7 +363,23 @@ private:
 	std::vector<TempRadarEntity> m_storyEntitiesOnRadar;
 	//entities on the normal radar
 	std::deque<RadarEntity>		m_entitiesOnRadar;
+	std::unordered_set<EntityId> m_entitiesOnRadarSet;	//ids in m_entitiesOnRadar
 	std::vector<RadarSound>		m_soundsOnRadar;
+	//cached icon data of all entities shown on radar or map
+	std::map<EntityId, RadarEntityInfo> m_radarEntityInfo;
+
+	//map overlay working sets, reused every frame
+	std::vector<double> m_mapValues;
+	std::vector<std::pair<EntityId, const char*> > m_mapTexts;
+	std::vector<EntityId> m_mapDrawnVehicles;	//sorted
+	std::vector<EntityId> m_mapSpawnGroups;
+	//map overlay last sent to flash
+	std::vector<double> m_shownMapValues;
+	std::vector<std::pair<EntityId, string> > m_shownMapTexts;
+	bool m_mapOverlayShown;
+	int m_shownObjectiveSector, m_shownDeploySpotSector;
+	//"bCapturable" script property per entity (sorted by id), building properties don't change during a level
+	std::vector<CapturableProperty> m_capturableProperties;
 	//mission objectives on radar
 	std::map<EntityId, RadarObjective>	m_missionObjectives;
 	//additional entities on miniMap in multiplayer
@@ -173,7 +173,7 @@ void CHUDScopes::DisplayBinoculars(CPlayer* pPlayerActor)
 	char szY[32];
 	sprintf(szY, "%f", 336.0f + rCamera.GetViewdir().z * 360.0f);
 
-	m_animBinoculars.CheckedSetVariable("Root.Binoculars.Attitude._y", szY);
+	m_animBinoculars.CachedSetVariable("Root.Binoculars.Attitude._y", szY);
 
 	wchar_t szN[32];
 	wchar_t szW[32];
@@ -371,6 +371,7 @@ void CHUDScopes::ShowBinoculars(bool bVisible, bool bShowIfNoHUD, bool bNoFadeOu
 
 		SFlashVarValue args[3] = { true, 1, m_bThirdPerson };
 		m_animBinoculars.Invoke("setVisible", args, 3);
+		m_animBinoculars.ResetCachedCalls();
 		m_bShowBinoculars = true;
 		m_bShowBinocularsNoHUD = bShowIfNoHUD;
 		m_bDestroyBinocularsAtNextFrame = false;
@@ -104,6 +104,20 @@ bool CHUDScore::ScoreEntry::operator<(const ScoreEntry& entry) const
 	}
 }
 
+bool CHUDScore::ScoreRow::operator==(const ScoreRow& row) const
+{
+	return m_entityId == row.m_entityId && m_team == row.m_team && m_isClient == row.m_isClient &&
+		m_hasPP == row.m_hasPP && m_pp == row.m_pp && m_kills == row.m_kills && m_deaths == row.m_deaths &&
+		m_ping == row.m_ping && m_rank == row.m_rank && m_dead == row.m_dead && m_selected == row.m_selected &&
+		m_muted == row.m_muted && m_name == row.m_name;
+}
+
+bool CHUDScore::TeamPoints::operator==(const TeamPoints& points) const
+{
+	return m_draw == points.m_draw && m_clientTeam == points.m_clientTeam &&
+		m_clientPoints == points.m_clientPoints && m_enemyPoints == points.m_enemyPoints;
+}
+
 void CHUDScore::SRankStats::Update(IScriptTable* pGameRulesScript, IActor* pActor, CGameFlashAnimation* pFlashBoard)
 {
 	HSCRIPTFUNCTION pfnFuHelper = 0;
@@ -171,6 +185,9 @@ void CHUDScore::Update(float fDeltaTime)
 void CHUDScore::Reset()
 {
 	m_scoreBoard.clear();
+	m_rows.clear();
+	m_shownRows.clear();
+	m_redraw = true;
 }
 
 void CHUDScore::AddEntry(EntityId player, int kills, int deaths, int ping)
@@ -269,7 +286,7 @@ void CHUDScore::Render()
 		drawTeamScores = (m_rankStats.currentRank != 0); // if we got here it means we don't want to show the number of kills
 	}
 
-	m_pFlashBoard->Invoke("clearEntries");
+	m_rows.resize(0);
 
 	std::vector<EntityId>::const_iterator start;
 	std::vector<EntityId>::const_iterator end;
@@ -322,52 +339,80 @@ void CHUDScore::Render()
 		int currentRank = 1;
 		pGameRules->GetSynchedEntityValue(pPlayer->GetId(), RANK_KEY, currentRank);
 		currentRank = MAX(currentRank, 1);
-		string strRank;
-		strRank.Format("@ui_short_rank_%d", currentRank);
 
-		SUIWideString name(pPlayer->GetName());
+		ScoreRow row;
+		row.m_name = SUIWideString(pPlayer->GetName()).m_string;
 		if (player.m_spectating)
 		{
-			name.m_string.append(L" (");
-			name.m_string.append(m_pHUD->LocalizeWithParams("@ui_SPECTATE"));
-			name.m_string.append(L")");
+			row.m_name.append(L" (");
+			row.m_name.append(m_pHUD->LocalizeWithParams("@ui_SPECTATE"));
+			row.m_name.append(L")");
 		}
 
-		SFlashVarValue pp(0);
+		row.m_hasPP = !notTeamed;
+		row.m_pp = 0;
+		if (row.m_hasPP)
+			pGameRules->GetSynchedEntityValue(player.m_entityId, PP_AMOUNT_KEY, row.m_pp);
 
-		if (!notTeamed)
-		{
-			int playerPP = 0;
-			pGameRules->GetSynchedEntityValue(player.m_entityId, PP_AMOUNT_KEY, playerPP);
-			pp = SFlashVarValue(playerPP);
-		}
-		else
-			pp = SFlashVarValue("---");
-
-		bool selected = false;
+		row.m_selected = false;
 		if (alreadySelected)
 		{
 			if (std::find(start, end, player.m_entityId) != end)
-				selected = true;
+				row.m_selected = true;
 		}
 
 		IVoiceContext* pVoiceContext = gEnv->pGame->GetIGameFramework()->GetNetContext()->GetVoiceContext();
-		bool muted = pVoiceContext->IsMuted(pClientActor->GetEntityId(), pPlayer->GetId());
+		row.m_muted = pVoiceContext->IsMuted(pClientActor->GetEntityId(), pPlayer->GetId());
 
-		int team = (player.m_team == clientTeam) ? 1 : 2;
+		row.m_team = (player.m_team == clientTeam) ? 1 : 2;
 		if (player.m_spectating)
-			team = 3;
+			row.m_team = 3;
+
+		row.m_isClient = (player.m_entityId == pClientActor->GetEntityId());
+		row.m_kills = player.m_kills;
+		row.m_deaths = player.m_deaths;
+		row.m_ping = player.m_ping;
+		row.m_entityId = player.m_entityId;
+		row.m_rank = currentRank;
+		row.m_dead = !player.m_alive;
+
+		m_rows.push_back(row);
+	}
+
+	TeamPoints teamPoints;
+	teamPoints.m_draw = drawTeamScores;
+	teamPoints.m_clientTeam = clientTeam;
+	teamPoints.m_clientPoints = drawTeamScores ? clientTeamPoints : 0;
+	teamPoints.m_enemyPoints = drawTeamScores ? enemyTeamPoints : 0;
+
+	DrawRows(teamPoints);
+}
+
+void CHUDScore::DrawRows(const TeamPoints& teamPoints)
+{
+	// flash only knows how to rebuild the whole board, so skip it while nothing shown has changed
+	if (!m_redraw && m_rows == m_shownRows && teamPoints == m_shownTeamPoints)
+		return;
 
-		SFlashVarValue args[12] = { name.c_str(), team, (player.m_entityId == pClientActor->GetEntityId()) ? true : false, pp, player.m_kills, player.m_deaths, player.m_ping, player.m_entityId, strRank.c_str(), player.m_alive ? 0 : 1,selected, muted };
+	m_pFlashBoard->Invoke("clearEntries");
+
+	for (const auto& row : m_rows)
+	{
+		string strRank;
+		strRank.Format("@ui_short_rank_%d", row.m_rank);
+
+		SFlashVarValue pp = row.m_hasPP ? SFlashVarValue(row.m_pp) : SFlashVarValue("---");
+
+		SFlashVarValue args[12] = { row.m_name.c_str(), row.m_team, row.m_isClient, pp, row.m_kills, row.m_deaths, row.m_ping, row.m_entityId, strRank.c_str(), row.m_dead ? 1 : 0, row.m_selected, row.m_muted };
 		m_pFlashBoard->Invoke("addEntry", args, 12);
 	}
 
-	if (drawTeamScores)
+	if (teamPoints.m_draw)
 		//set the teams scores in flash
 	{
-		SFlashVarValue argsA[2] = { (clientTeam == 1) ? 1 : 2, enemyTeamPoints };
+		SFlashVarValue argsA[2] = { (teamPoints.m_clientTeam == 1) ? 1 : 2, teamPoints.m_enemyPoints };
 		m_pFlashBoard->CheckedInvoke("setTeamPoints", argsA, 2);
-		SFlashVarValue argsB[2] = { (clientTeam == 1) ? 2 : 1, clientTeamPoints };
+		SFlashVarValue argsB[2] = { (teamPoints.m_clientTeam == 1) ? 2 : 1, teamPoints.m_clientPoints };
 		m_pFlashBoard->CheckedInvoke("setTeamPoints", argsB, 2);
 	}
 	else
@@ -380,6 +425,10 @@ void CHUDScore::Render()
 
 	EntityId playerBeingKicked = 0;
 	m_pFlashBoard->Invoke("drawAllEntries", playerBeingKicked);
+
+	m_shownRows.swap(m_rows);
+	m_shownTeamPoints = teamPoints;
+	m_redraw = false;
 }
 
 void CHUDScore::GetMemoryStatistics(ICrySizer* s)
@@ -388,4 +437,6 @@ void CHUDScore::GetMemoryStatistics(ICrySizer* s)
 	if (m_pFlashBoard)
 		m_pFlashBoard->GetMemoryStatistics(s);
 	s->AddContainer(m_scoreBoard);
+	s->AddContainer(m_rows);
+	s->AddContainer(m_shownRows);
 }
@@ -38,6 +38,37 @@ class CHUDScore : public CHUDObject
 		void UpdateLiveStats();
 	};
 
+	// everything sent to flash for one player, the board is only redrawn when this changes
+	struct ScoreRow
+	{
+		CryFixedWStringT<128>	m_name;
+		int					m_team;
+		bool				m_isClient;
+		bool				m_hasPP;
+		int					m_pp;
+		int					m_kills;
+		int					m_deaths;
+		int					m_ping;
+		EntityId		m_entityId;
+		int					m_rank;
+		bool				m_dead;
+		bool				m_selected;
+		bool				m_muted;
+
+		bool operator==(const ScoreRow& row) const;
+		bool operator!=(const ScoreRow& row) const { return !(*this == row); }
+	};
+
+	struct TeamPoints
+	{
+		bool				m_draw;
+		int					m_clientTeam;
+		int					m_clientPoints;
+		int					m_enemyPoints;
+
+		bool operator==(const TeamPoints& points) const;
+	};
+
 public:
 	struct SRankStats
 	{
@@ -73,6 +104,7 @@ public:
 		m_lastShowSwitch = 0;
 		m_pFlashBoard = NULL;
 		m_currentClientTeam = -1;
+		m_redraw = true;
 	}
 
 	~CHUDScore()
@@ -98,6 +130,7 @@ public:
 		m_bShow = visible;
 		m_pFlashBoard = board;
 		m_lastShowSwitch = gEnv->pTimer->GetFrameStartTime().GetSeconds();
+		m_redraw = true;
 	}
 private:
 
@@ -111,7 +144,13 @@ private:
 	CGameFlashAnimation *m_pFlashBoard;
 	SRankStats m_rankStats;
 
+	std::vector<ScoreRow> m_rows;
+	std::vector<ScoreRow> m_shownRows;
+	TeamPoints	m_shownTeamPoints;
+	bool				m_redraw;		// flash board has to be filled again
+
 	void Render();
+	void DrawRows(const TeamPoints& teamPoints);
 };
 
 #endif
\ No newline at end of file
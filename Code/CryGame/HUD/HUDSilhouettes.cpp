@@ -26,6 +26,10 @@ History:
 CHUDSilhouettes::CHUDSilhouettes()
 {
 	m_silhouettesVector.resize(256);
+
+	m_freeSlots.reserve(m_silhouettesVector.size());
+	for(int iSlot=m_silhouettesVector.size()-1; iSlot>=0; --iSlot)
+		m_freeSlots.push_back(iSlot);
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -53,6 +57,45 @@ void CHUDSilhouettes::SetVisionParams(EntityId uiEntityId,float r,float g,float
 
 //-----------------------------------------------------------------------------------------------------
 
+int CHUDSilhouettes::AllocSlot(EntityId uiEntityId)
+{
+	TSilhouettesIndex::iterator it = m_silhouettesIndex.find(uiEntityId);
+	if(it != m_silhouettesIndex.end())
+		return it->second;
+
+	int iSlot = 0;
+
+	if(m_freeSlots.empty())
+	{
+		iSlot = m_silhouettesVector.size();
+		m_silhouettesVector.resize(iSlot + 1);
+	}
+	else
+	{
+		iSlot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+
+	m_silhouettesIndex[uiEntityId] = iSlot;
+
+	return iSlot;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void CHUDSilhouettes::FreeSlot(int iSlot)
+{
+	SSilhouette *pSilhouette = &m_silhouettesVector[iSlot];
+
+	// slot stays in m_activeSlots until the next update, bActive prevents adding it twice
+	pSilhouette->bValid = false;
+
+	m_silhouettesIndex.erase(pSilhouette->uiEntityId);
+	m_freeSlots.push_back(iSlot);
+}
+
+//-----------------------------------------------------------------------------------------------------
+
 void CHUDSilhouettes::SetFlowGraphSilhouette(IEntity *pEntity,float r,float g,float b,float a,float fDuration)
 {
 	if(!pEntity)
@@ -85,47 +128,26 @@ void CHUDSilhouettes::SetSilhouette(IEntity *pEntity,float r,float g,float b,flo
 	if(!pEntity)
 		return;
 
-	SSilhouette *pSilhouette = NULL;
+	const int iSlot = AllocSlot(pEntity->GetId());
 
-	// First pass: is that Id already in a slot?
-	for(TSilhouettesVector::iterator iter=m_silhouettesVector.begin(); iter!=m_silhouettesVector.end(); ++iter)
-	{
-		SSilhouette *pSil = &(*iter);
-		if(pEntity->GetId() == pSil->uiEntityId)
-		{
-			pSilhouette = pSil;
-			break;
-		}
-	}
-
-	if(!pSilhouette)
-	{
-		// Second pass: try to find a free slot
-		for(TSilhouettesVector::iterator iter=m_silhouettesVector.begin(); iter!=m_silhouettesVector.end(); ++iter)
-		{
-			SSilhouette *pSil = &(*iter);
-			if(!pSil->bValid)
-			{
-				pSilhouette = pSil;
-				break;
-			}
-		}
-	}
+	SSilhouette *pSilhouette = &m_silhouettesVector[iSlot];
 
-	CRY_ASSERT_MESSAGE(pSilhouette,"Vector size should be increased!");
+	pSilhouette->uiEntityId	= pEntity->GetId();
+	pSilhouette->fTime = fDuration;
+	pSilhouette->bValid			= true;
+	pSilhouette->iFadeScale = 255;
+	pSilhouette->r = r;
+	pSilhouette->g = g;
+	pSilhouette->b = b;
+	pSilhouette->a = a;
 
-	if(pSilhouette)
+	if(fDuration != -1 && !pSilhouette->bActive)
 	{
-		pSilhouette->uiEntityId	= pEntity->GetId();
-		pSilhouette->fTime = fDuration;
-		pSilhouette->bValid			= true;
-		pSilhouette->r = r;
-		pSilhouette->g = g;
-		pSilhouette->b = b;
-		pSilhouette->a = a;
-
-		SetVisionParams(pEntity->GetId(),r,g,b,a);
+		pSilhouette->bActive = true;
+		m_activeSlots.push_back(iSlot);
 	}
+
+	SetVisionParams(pEntity->GetId(),r,g,b,a);
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -176,26 +198,20 @@ void CHUDSilhouettes::SetSilhouette(IVehicle *pVehicle,float r,float g,float b,f
 
 void CHUDSilhouettes::ResetSilhouette(EntityId uiEntityId)
 {
-	for(TSilhouettesVector::iterator iter=m_silhouettesVector.begin(); iter!=m_silhouettesVector.end(); ++iter)
-	{
-		SSilhouette *pSilhouette = &(*iter);
-
-		if(pSilhouette->uiEntityId == uiEntityId && pSilhouette->bValid)
-		{
-			std::map<EntityId, Vec3>::iterator it = GetFGSilhouette(pSilhouette->uiEntityId);
-			if(it != m_silhouettesFGVector.end())
-			{
-				Vec3 color = it->second;
-				SetVisionParams(uiEntityId, color.x, color.y, color.z, 1.0f);
-			}
-			else
-			{
-				SetVisionParams(pSilhouette->uiEntityId,0,0,0,0);
-				pSilhouette->bValid = false;
-			}
+	TSilhouettesIndex::iterator iter = m_silhouettesIndex.find(uiEntityId);
+	if(iter == m_silhouettesIndex.end())
+		return;
 
-			return;
-		}
+	std::map<EntityId, Vec3>::iterator it = GetFGSilhouette(uiEntityId);
+	if(it != m_silhouettesFGVector.end())
+	{
+		Vec3 color = it->second;
+		SetVisionParams(uiEntityId, color.x, color.y, color.z, 1.0f);
+	}
+	else
+	{
+		SetVisionParams(uiEntityId,0,0,0,0);
+		FreeSlot(iter->second);
 	}
 }
 
@@ -206,25 +222,24 @@ void CHUDSilhouettes::SetType(int iType)
 	// Exit of binoculars: we need to reset all silhouettes
 	if(0 == iType)
 	{
-		for(TSilhouettesVector::iterator iter=m_silhouettesVector.begin(); iter!=m_silhouettesVector.end(); ++iter)
+		for(TSilhouettesIndex::iterator iter=m_silhouettesIndex.begin(); iter!=m_silhouettesIndex.end(); )
 		{
-			SSilhouette *pSilhouette = &(*iter);
+			const int iSlot = iter->second;
+			const EntityId uiEntityId = iter->first;
+
+			++iter;
 
-			if(pSilhouette->bValid)
+			std::map<EntityId, Vec3>::iterator it = GetFGSilhouette(uiEntityId);
+			if(it != m_silhouettesFGVector.end())
 			{
-				std::map<EntityId, Vec3>::iterator it = GetFGSilhouette(pSilhouette->uiEntityId);
-				if(it != m_silhouettesFGVector.end())
-				{
-					Vec3 color = it->second;
-					SetVisionParams(pSilhouette->uiEntityId, color.x, color.y, color.z, 1.0f);
-				}
-				else
-				{
-					SetVisionParams(pSilhouette->uiEntityId,0,0,0,0);
-					pSilhouette->bValid = false;
-				}
+				Vec3 color = it->second;
+				SetVisionParams(uiEntityId, color.x, color.y, color.z, 1.0f);
+			}
+			else
+			{
+				SetVisionParams(uiEntityId,0,0,0,0);
+				FreeSlot(iSlot);
 			}
-
 		}
 	}
 
@@ -235,28 +250,48 @@ void CHUDSilhouettes::SetType(int iType)
 
 void CHUDSilhouettes::Update(float frameTime)
 {
-	for(TSilhouettesVector::iterator iter=m_silhouettesVector.begin(); iter!=m_silhouettesVector.end(); ++iter)
+	int iActiveCount = 0;
+
+	for(size_t i=0; i<m_activeSlots.size(); ++i)
 	{
-		SSilhouette *pSilhouette = &(*iter);
+		const int iSlot = m_activeSlots[i];
+
+		SSilhouette *pSilhouette = &m_silhouettesVector[iSlot];
 
-		if(pSilhouette->bValid && pSilhouette->fTime != -1)
+		if(!pSilhouette->bValid || pSilhouette->fTime == -1)
 		{
-			pSilhouette->fTime -= frameTime;
-			if(pSilhouette->fTime < 0.0f)
-			{
-				SetVisionParams(pSilhouette->uiEntityId,0,0,0,0);
-				pSilhouette->bValid = false;
-				pSilhouette->fTime = 0.0f;
-			}
-			else if (pSilhouette->fTime < 1.0f)
+			pSilhouette->bActive = false;
+			continue;
+		}
+
+		pSilhouette->fTime -= frameTime;
+		if(pSilhouette->fTime < 0.0f)
+		{
+			SetVisionParams(pSilhouette->uiEntityId,0,0,0,0);
+			FreeSlot(iSlot);
+			pSilhouette->bActive = false;
+			pSilhouette->fTime = 0.0f;
+			continue;
+		}
+		else if (pSilhouette->fTime < 1.0f)
+		{
+			// fade out for the last second
+			float scale = pSilhouette->fTime ;
+			scale *= scale;
+
+			// the colour ends up in 8 bits, don't resend it until it changes
+			const int iFadeScale = int(scale * 255.0f);
+			if(iFadeScale != pSilhouette->iFadeScale)
 			{
-				// fade out for the last second
-				float scale = pSilhouette->fTime ;
-				scale *= scale;
+				pSilhouette->iFadeScale = iFadeScale;
 				SetVisionParams(pSilhouette->uiEntityId,pSilhouette->r*scale,pSilhouette->g*scale,pSilhouette->b*scale,pSilhouette->a*scale);
 			}
 		}
+
+		m_activeSlots[iActiveCount++] = iSlot;
 	}
+
+	m_activeSlots.resize(iActiveCount);
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -303,14 +338,5 @@ void CHUDSilhouettes::Serialize(TSerialize &ser)
 
 std::map<EntityId, Vec3>::iterator CHUDSilhouettes::GetFGSilhouette(EntityId id)
 {
-	std::map<EntityId, Vec3>::iterator returnVal = m_silhouettesFGVector.end();
-
-	std::map<EntityId, Vec3>::iterator it = m_silhouettesFGVector.begin();
-	std::map<EntityId, Vec3>::iterator end = m_silhouettesFGVector.end();
-	for(; it != end; ++it)
-	{
-		if(it->first == id)
-			returnVal = it;
-	}
-	return returnVal;
+	return m_silhouettesFGVector.find(id);
 }
@@ -15,6 +15,10 @@ History:
 #ifndef __HUDSILHOUETTES_H__
 #define __HUDSILHOUETTES_H__
 
+#include <map>
+#include <unordered_map>
+#include <vector>
+
 //-----------------------------------------------------------------------------------------------------
 
 class CHUDSilhouettes
@@ -45,14 +49,19 @@ private:
 
 	std::map<EntityId, Vec3>::iterator GetFGSilhouette(EntityId id);
 
+	int AllocSlot(EntityId uiEntityId);
+	void FreeSlot(int iSlot);
+
 	struct SSilhouette
 	{
 		EntityId uiEntityId;
 		float fTime;
 		bool bValid;
+		bool bActive;			// slot is in m_activeSlots
+		int iFadeScale;		// last fade applied with SetVisionParams, in 1/255 steps
 		float r, g, b, a;
 
-		SSilhouette() : bValid(false)
+		SSilhouette() : uiEntityId(0), fTime(0.0f), bValid(false), bActive(false), iFadeScale(255)
 		{
 		}
 
@@ -71,6 +80,14 @@ private:
 	typedef std::vector<SSilhouette> TSilhouettesVector;
 	TSilhouettesVector m_silhouettesVector;
 	std::map<EntityId, Vec3> m_silhouettesFGVector;
+
+	// slot of each valid silhouette
+	typedef std::unordered_map<EntityId, int> TSilhouettesIndex;
+	TSilhouettesIndex m_silhouettesIndex;
+	// free slots, the next one to use is at the back
+	std::vector<int> m_freeSlots;
+	// slots of silhouettes with a duration, they are the only ones to update
+	std::vector<int> m_activeSlots;
 };
 
 //-----------------------------------------------------------------------------------------------------
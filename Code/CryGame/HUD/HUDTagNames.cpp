@@ -72,7 +72,7 @@ CHUDTagNames::~CHUDTagNames()
 
 //-----------------------------------------------------------------------------------------------------
 
-const std::string & CHUDTagNames::GetPlayerRank(EntityId entityId)
+int CHUDTagNames::GetPlayerRank(EntityId entityId)
 {
 	constexpr TSynchedKey RANK_KEY = 202;
 
@@ -82,7 +82,67 @@ const std::string & CHUDTagNames::GetPlayerRank(EntityId entityId)
 	if (rank < 0 || rank >= m_rankNames.size())
 		rank = 0;
 
-	return m_rankNames[rank];
+	return rank;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+const std::string & CHUDTagNames::GetTagText(IEntity* pEntity)
+{
+	const int rank = GetPlayerRank(pEntity->GetId());
+	const char* name = pEntity->GetName();
+
+	STagText& tagText = m_tagTexts[pEntity->GetId()];
+
+	if (tagText.text.empty() || tagText.rank != rank || tagText.name != name)
+	{
+		tagText.rank = rank;
+		tagText.name = name;
+
+		const std::string & rankName = m_rankNames[rank];
+
+		if (rankName.empty())
+		{
+			tagText.text = name;
+		}
+		else
+		{
+			tagText.text = rankName;
+			tagText.text += ' ';
+			tagText.text += name;
+		}
+	}
+
+	return tagText.text;
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+bool CHUDTagNames::IsTagVisible(const Vec3& vWorld, float fRadius) const
+{
+	// the tag can still be moved up to fRadius towards the camera by ProjectOnSphere
+	float fDistance = std::max((vWorld - m_vCameraPos).len() - fRadius, 0.0f) * m_fFovScale;
+	if (fDistance >= m_fCullDistance)
+		return false;
+
+	return gEnv->pRenderer->GetCamera().IsSphereVisible_F(Sphere(vWorld, fRadius));
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+CHUDTagNames::STagName* CHUDTagNames::AddTagName(IEntity* pEntity, const Vec3& vWorld, bool bDrawOnTop, const ColorF& rgb)
+{
+	m_tagNamesVector.resize(m_tagNamesVector.size() + 1);
+
+	STagName* pTagName = &m_tagNamesVector.back();
+	pTagName->pText = &GetTagText(pEntity);
+	pTagName->vWorld = vWorld;
+	pTagName->bDrawOnTop = bDrawOnTop;
+	pTagName->rgb = rgb;
+	pTagName->iLine = 0;
+	pTagName->iLineCount = 1;
+
+	return pTagName;
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -195,8 +255,6 @@ void CHUDTagNames::DrawTagName(IActor* pActor, bool bLocalVehicle)
 	if (!bLocalVehicle && pActor->GetLinkedVehicle())
 		return;
 
-	const std::string & rank = GetPlayerRank(pActor->GetEntityId());
-
 	IEntity* pEntity = pActor->GetEntity();
 	if (!pEntity)
 		return;
@@ -223,6 +281,9 @@ void CHUDTagNames::DrawTagName(IActor* pActor, bool bLocalVehicle)
 	AABB box;
 	pEntity->GetWorldBounds(box);
 
+	if (!IsTagVisible(vWorldPos, ((box.max - box.min) * 0.5f).len()))
+		return;
+
 	bool bDrawOnTop = bLocalVehicle;
 
 	if (ProjectOnSphere(vWorldPos, box))
@@ -249,8 +310,6 @@ void CHUDTagNames::DrawTagName(IActor* pActor, bool bLocalVehicle)
 		rgbTagName = COLOR_DEAD;
 	}
 
-	m_tagNamesVector.resize(1);
-
 	for (std::vector<EntityId>::iterator iter = SAFE_HUD_FUNC_RET(GetRadar()->GetSelectedTeamMates())->begin(); iter != SAFE_HUD_FUNC_RET(GetRadar()->GetSelectedTeamMates())->end(); ++iter)
 	{
 		if (pActor->GetEntityId() == *iter)
@@ -261,24 +320,7 @@ void CHUDTagNames::DrawTagName(IActor* pActor, bool bLocalVehicle)
 		}
 	}
 
-	STagName* pTagName = &m_tagNamesVector[0];
-
-	if (rank.empty())
-	{
-		pTagName->text = pEntity->GetName();
-	}
-	else
-	{
-		pTagName->text = rank;
-		pTagName->text += ' ';
-		pTagName->text += pEntity->GetName();
-	}
-
-	pTagName->vWorld = vWorldPos;
-	pTagName->bDrawOnTop = bDrawOnTop;
-	pTagName->rgb = rgbTagName;
-
-	DrawTagNames();
+	AddTagName(pEntity, vWorldPos, bDrawOnTop, rgbTagName);
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -343,6 +385,9 @@ void CHUDTagNames::DrawTagName(IVehicle* pVehicle)
 	AABB box;
 	pVehicle->GetEntity()->GetWorldBounds(box);
 
+	if (!IsTagVisible(vWorldPos, ((box.max - box.min) * 0.5f).len()))
+		return;
+
 	bool bDrawOnTop = false;
 
 	if (ProjectOnSphere(vWorldPos, box))
@@ -350,7 +395,7 @@ void CHUDTagNames::DrawTagName(IVehicle* pVehicle)
 		bDrawOnTop = true;
 	}
 
-	m_tagNamesVector.resize(0);
+	const int iFirstTagName = m_tagNamesVector.size();
 
 	for (int iSeatId = 1; iSeatId <= pVehicle->GetLastSeatId(); iSeatId++)
 	{
@@ -364,8 +409,6 @@ void CHUDTagNames::DrawTagName(IVehicle* pVehicle)
 		if (!pActor)
 			continue;
 
-		const std::string & rank = GetPlayerRank(uiEntityId);
-
 		IEntity* pEntity = pActor->GetEntity();
 		if (!pEntity)
 			continue;
@@ -387,27 +430,16 @@ void CHUDTagNames::DrawTagName(IVehicle* pVehicle)
 			rgbTagName = COLOR_DEAD;
 		}
 
-		m_tagNamesVector.resize(m_tagNamesVector.size() + 1);
-
-		STagName* pTagName = &m_tagNamesVector[m_tagNamesVector.size() - 1];
-
-		if (rank.empty())
-		{
-			pTagName->text = pEntity->GetName();
-		}
-		else
-		{
-			pTagName->text = rank;
-			pTagName->text += ' ';
-			pTagName->text += pEntity->GetName();
-		}
-
-		pTagName->vWorld = vWorldPos;
-		pTagName->bDrawOnTop = bDrawOnTop;
-		pTagName->rgb = rgbTagName;
+		AddTagName(pEntity, vWorldPos, bDrawOnTop, rgbTagName);
 	}
 
-	DrawTagNames();
+	// passengers are stacked above the vehicle
+	const int iLineCount = m_tagNamesVector.size() - iFirstTagName;
+	for (int iLine = 0; iLine < iLineCount; iLine++)
+	{
+		m_tagNamesVector[iFirstTagName + iLine].iLine = iLine;
+		m_tagNamesVector[iFirstTagName + iLine].iLineCount = iLineCount;
+	}
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -420,6 +452,36 @@ void CHUDTagNames::Update()
 	if (!pClientActor || !pGameRules || !gEnv->bMultiplayer)
 		return;
 
+	m_tagNamesVector.resize(0);
+
+	m_vCameraPos = gEnv->pSystem->GetViewCamera().GetPosition();
+
+	// Adjust distance when zoomed. Default fov is 60, so we use (1/(60*pi/180)=3/pi)
+	m_fFovScale = 3.0f * gEnv->pRenderer->GetCamera().GetFov() / gf_PI;
+
+	m_fMinDistance = (float)g_pGameCVars->hud_mpNamesNearDistance;
+	m_fMaxDistance = (float)g_pGameCVars->hud_mpNamesFarDistance;
+
+	// if local player is in a vehicle, increase the max distance
+	if (pClientActor->GetLinkedVehicle())
+	{
+		m_fMaxDistance *= 3.0f;
+	}
+
+	// names are fully visible below the near distance, even if the far distance is smaller
+	m_fCullDistance = std::max(m_fMinDistance, m_fMaxDistance);
+
+	// forget players who left
+	if (m_tagTexts.size() > 64)
+	{
+		for (TTagTextMap::iterator iter = m_tagTexts.begin(); iter != m_tagTexts.end();)
+		{
+			if (gEnv->pEntitySystem->GetEntity(iter->first))
+				++iter;
+			else
+				iter = m_tagTexts.erase(iter);
+		}
+	}
 
 	int iClientTeam = pGameRules->GetTeam(pClientActor->GetEntityId());
 
@@ -450,7 +512,10 @@ void CHUDTagNames::Update()
 
 	IVehicleSystem* pVehicleSystem = gEnv->pGame->GetIGameFramework()->GetIVehicleSystem();
 	if (!pVehicleSystem)
+	{
+		DrawTagNames();
 		return;
+	}
 
 	IVehicleIteratorPtr pVehicleIter = pVehicleSystem->CreateVehicleIterator();
 	while (IVehicle* pVehicle = pVehicleIter->Next())
@@ -513,20 +578,35 @@ void CHUDTagNames::Update()
 			}
 		}
 	}
+
+	DrawTagNames();
 }
 
 //-----------------------------------------------------------------------------------------------------
 
 void CHUDTagNames::DrawTagNames()
 {
-	int iTagName = 0;
-	for (TTagNamesVector::iterator iter = m_tagNamesVector.begin(); iter != m_tagNamesVector.end(); ++iter, ++iTagName)
+	const float fScreenScaleX = gEnv->pRenderer->GetWidth() * 0.01f;
+	const float fScreenScaleY = gEnv->pRenderer->GetHeight() * 0.01f;
+	const float fScaleY = gEnv->pRenderer->GetHeight() / 600.0f;
+	const float fBaseSize = 11.0f;
+
+	int iVisibleCount = 0;
+
+	// It's important that the projection is done outside the UIDraw->PreRender/PostRender because of the Set2DMode(true) which is done internally
+
+	for (TTagNamesVector::iterator iter = m_tagNamesVector.begin(); iter != m_tagNamesVector.end(); ++iter)
 	{
 		STagName* pTagName = &(*iter);
 
-		const char* szText = pTagName->text.c_str();
+		pTagName->fAlpha = 0.0f;
 
-		// It's important that the projection is done outside the UIDraw->PreRender/PostRender because of the Set2DMode(true) which is done internally
+		float fDistance = (pTagName->vWorld - m_vCameraPos).len() * m_fFovScale;
+
+		if (fDistance >= m_fCullDistance)
+		{
+			continue;
+		}
 
 		Vec3 vScreenSpace;
 		gEnv->pRenderer->ProjectToScreen(pTagName->vWorld.x, pTagName->vWorld.y, pTagName->vWorld.z, &vScreenSpace.x, &vScreenSpace.y, &vScreenSpace.z);
@@ -537,87 +617,72 @@ void CHUDTagNames::DrawTagNames()
 			continue;
 		}
 
-		vScreenSpace.x *= gEnv->pRenderer->GetWidth() * 0.01f;
-		vScreenSpace.y *= gEnv->pRenderer->GetHeight() * 0.01f;
+		vScreenSpace.x *= fScreenScaleX;
+		vScreenSpace.y *= fScreenScaleY;
 
 		// Seems that Z is on range [1 .. -1]
 		vScreenSpace.z = 1.0f - (vScreenSpace.z * 2.0f);
 
-		float fDistance = (pTagName->vWorld - gEnv->pSystem->GetViewCamera().GetPosition()).len();
-
-		// Adjust distance when zoomed. Default fov is 60, so we use (1/(60*pi/180)=3/pi)
-		fDistance *= 3.0f * gEnv->pRenderer->GetCamera().GetFov() / gf_PI;
-
-		float fSize = 0.0f;
-		float fAlpha = 0.0f;
-
-		float fMinDistance = (float)g_pGameCVars->hud_mpNamesNearDistance;
-		float fMaxDistance = (float)g_pGameCVars->hud_mpNamesFarDistance;
-
-		// if local player is in a vehicle, increase the max distance
-		IActor* pActor = g_pGame->GetIGameFramework()->GetClientActor();
-		if (pActor && pActor->GetLinkedVehicle())
+		if (pTagName->bDrawOnTop)
 		{
-			fMaxDistance *= 3.0f;
+			vScreenSpace.z = 1.0f;
 		}
 
-		if (fDistance < fMinDistance)
-		{
-			fAlpha = 1.0f;
-		}
-		else if (fDistance < fMaxDistance)
-		{
-			fAlpha = 1.0f - (fDistance - fMinDistance) / (fMaxDistance - fMinDistance);
-		}
+		float fSize = fBaseSize;
+		float fAlpha = 1.0f;
 
-		if (0.0f == fAlpha)
+		if (fDistance >= m_fMinDistance)
 		{
-			continue;
+			fAlpha = 1.0f - (fDistance - m_fMinDistance) / (m_fMaxDistance - m_fMinDistance);
+			fSize = fBaseSize * fAlpha;
 		}
 
-		fAlpha = MIN(fAlpha, 0.8f);
+		pTagName->vScreen = vScreenSpace;
+		pTagName->fSize = fSize * fScaleY;
+		pTagName->fAlpha = MIN(fAlpha, 0.8f);
 
-		const float fBaseSize = 11.0f;
+		iVisibleCount++;
+	}
 
-		if (fDistance < fMinDistance)
-		{
-			fSize = fBaseSize;
-		}
-		else if (fDistance < fMaxDistance)
-		{
-			fSize = fBaseSize * (1.0f - (fDistance - fMinDistance) / (fMaxDistance - fMinDistance));
-		}
+	if (0 == iVisibleCount)
+	{
+		return;
+	}
 
-		m_pUIDraw->PreRender();
+	m_pUIDraw->PreRender();
 
-		float fScaleY = gEnv->pRenderer->GetHeight() / 600.0f;
+	m_pMPNamesFont->UseRealPixels(true);
+	m_pMPNamesFont->SetSameSize(false);
 
-		fSize *= fScaleY;
+	for (TTagNamesVector::iterator iter = m_tagNamesVector.begin(); iter != m_tagNamesVector.end(); ++iter)
+	{
+		STagName* pTagName = &(*iter);
 
-		m_pMPNamesFont->UseRealPixels(true);
-		m_pMPNamesFont->SetSize(vector2f(fSize, fSize));
-		m_pMPNamesFont->SetSameSize(false);
+		if (0.0f == pTagName->fAlpha)
+		{
+			continue;
+		}
 
-		vector2f vDim = m_pMPNamesFont->GetTextSize(szText);
+		const char* szText = pTagName->pText->c_str();
+		const float fAlpha = pTagName->fAlpha;
 
-		float fTextX = vScreenSpace.x - vDim.x * 0.5f;
-		float fTextY = vScreenSpace.y - vDim.y * (m_tagNamesVector.size() * 0.5f - iTagName);
+		m_pMPNamesFont->SetSize(vector2f(pTagName->fSize, pTagName->fSize));
 
-		if (pTagName->bDrawOnTop)
-		{
-			vScreenSpace.z = 1.0f;
-		}
+		vector2f vDim = m_pMPNamesFont->GetTextSize(szText);
+
+		float fTextX = pTagName->vScreen.x - vDim.x * 0.5f;
+		float fTextY = pTagName->vScreen.y - vDim.y * (pTagName->iLineCount * 0.5f - pTagName->iLine);
 
 		m_pMPNamesFont->SetEffect("simple");
 		m_pMPNamesFont->SetColor(ColorF(0, 0, 0, fAlpha));
-		m_pMPNamesFont->DrawString(fTextX + 1.0f, fTextY + 1.0f, vScreenSpace.z, szText);
+		m_pMPNamesFont->DrawString(fTextX + 1.0f, fTextY + 1.0f, pTagName->vScreen.z, szText);
 
 		m_pMPNamesFont->SetEffect("default");
 		m_pMPNamesFont->SetColor(ColorF(pTagName->rgb.r, pTagName->rgb.g, pTagName->rgb.b, fAlpha));
-		m_pMPNamesFont->DrawString(fTextX, fTextY, vScreenSpace.z, szText);
-
-		m_pUIDraw->PostRender();
+		m_pMPNamesFont->DrawString(fTextX, fTextY, pTagName->vScreen.z, szText);
 	}
+
+	m_pUIDraw->PostRender();
 }
 
 //-----------------------------------------------------------------------------------------------------
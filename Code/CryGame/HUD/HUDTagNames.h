@@ -15,6 +15,7 @@ History:
 #ifndef __HUDTAGNAMES_H__
 #define __HUDTAGNAMES_H__
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -36,7 +37,10 @@ public:
 
 private:
 
-	const std::string & GetPlayerRank(EntityId entityId);
+	int GetPlayerRank(EntityId entityId);
+
+	//"RANK Name" of a player, rebuilt only when the rank or the name changes
+	const std::string & GetTagText(IEntity *pEntity);
 
 	bool ProjectOnSphere(Vec3 &rvWorldPos,const AABB &rvBBox);
 
@@ -47,14 +51,43 @@ private:
 
 	struct STagName
 	{
-		std::string text;
+		const std::string *pText;
 		Vec3 vWorld;
 		bool bDrawOnTop;
 		ColorF rgb;
+		int iLine;			// lines of one vehicle are stacked
+		int iLineCount;
+		// filled by DrawTagNames
+		Vec3 vScreen;
+		float fSize;
+		float fAlpha;
 	};
 	typedef std::vector<STagName> TTagNamesVector;
+	// all tag names of the frame, drawn together
 	TTagNamesVector m_tagNamesVector;
 
+	struct STagText
+	{
+		int rank;
+		std::string name;
+		std::string text;
+
+		STagText() : rank(0) {}
+	};
+	typedef std::map<EntityId, STagText> TTagTextMap;
+	TTagTextMap m_tagTexts;
+
+	// per frame constants
+	Vec3 m_vCameraPos;
+	float m_fFovScale;
+	float m_fMinDistance;
+	float m_fMaxDistance;
+	float m_fCullDistance;
+
+	// false if the tag is outside the view or too far away to be drawn
+	bool IsTagVisible(const Vec3 &vWorld, float fRadius) const;
+	STagName *AddTagName(IEntity *pEntity, const Vec3 &vWorld, bool bDrawOnTop, const ColorF &rgb);
+
 	struct SEnemyTagName
 	{
 		EntityId uiEntityId;
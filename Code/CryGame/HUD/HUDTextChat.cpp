@@ -20,6 +20,7 @@ History:
 #include "CryGame/GameActions.h"
 #include "CryGame/GameRules.h"
 #include "CryGame/Voting.h"
+#include "CryGame/GameCVars.h"
 
 #include "GameFlashAnimation.h"
 #include "GameFlashLogic.h"
@@ -374,22 +375,13 @@ void CHUDTextChat::AddChatMessage(const char* nick, const wchar_t* msg, int team
 	if (!m_flashChat)
 		return;
 
-	if (teamChat)
-	{
-		wstring nameAndTarget = g_pGame->GetHUD()->LocalizeWithParams("@ui_chat_team", true, nick);
-		SFlashVarValue args[3] = { nameAndTarget.c_str(), msg, teamFaction };
-		m_flashChat->Invoke("setChatText", args, 3);
-	}
-	else
-	{
-		SFlashVarValue args[3] = { nick, msg, teamFaction };
-		m_flashChat->Invoke("setChatText", args, 3);
-	}
-
-	m_chatHead++;
-	if (m_chatHead > CHAT_LENGTH - 1)
-		m_chatHead = 0;
-	m_anyCurrentText = true;
+	SChatLine& line = m_chatQueue.Push();
+	line.nick = nick;
+	line.msg.clear();
+	line.wideMsg = msg;
+	line.teamFaction = teamFaction;
+	line.isWide = true;
+	line.teamChat = teamChat;
 }
 
 void CHUDTextChat::AddChatMessage(EntityId sourceId, const wchar_t* msg, int teamFaction, bool teamChat)
@@ -414,30 +406,64 @@ void CHUDTextChat::AddChatMessage(const char* nick, const char* msg, int teamFac
 	if (!m_flashChat)
 		return;
 
-	string message(msg);
-	int idx = message.find("@mp_vote_initialized_kick:#:");
-	if (idx != -1)
+	static const char VOTE_KICK_MARKER[] = "@mp_vote_initialized_kick:#:";
+
+	if (const char* voteKick = strstr(msg, VOTE_KICK_MARKER))
 	{
-		message = message.substr(idx + strlen("@mp_vote_initialized_kick:#:"));
 		wstring localizedString;
 		if (g_pGame->GetHUD())
-			localizedString = g_pGame->GetHUD()->LocalizeWithParams("@mp_vote_initialized_kick", true, message.c_str());
+			localizedString = g_pGame->GetHUD()->LocalizeWithParams("@mp_vote_initialized_kick", true, voteKick + sizeof(VOTE_KICK_MARKER) - 1);
 		AddChatMessage(nick, localizedString.c_str(), teamFaction, teamChat);
 		return;
 	}
-	m_chatStrings[m_chatHead] = string(msg);
-	m_chatSpawnTime[m_chatHead] = gEnv->pTimer->GetAsyncTime().GetMilliSeconds();
+
+	SChatLine& line = m_chatQueue.Push();
+	line.nick = nick;
+	line.msg = msg;
+	line.wideMsg.clear();
+	line.teamFaction = teamFaction;
+	line.isWide = false;
+	line.teamChat = teamChat;
+}
+
+void CHUDTextChat::FlushChatMessages()
+{
+	if (!m_chatQueue.GetCount())
+		return;
+
+	if (!m_flashChat)
+	{
+		m_chatQueue.Clear();
+		return;
+	}
+
+	// only CHAT_LENGTH lines are visible, older messages of this frame would scroll out right away
+	m_chatQueue.Flush(CHAT_LENGTH, g_pGameCVars->hud_chatMessagesPerSecond, [this](const SChatLine& line)
+	{
+		ShowChatLine(line);
+	});
+}
+
+void CHUDTextChat::ShowChatLine(const SChatLine& line)
+{
+	if (!line.isWide)
+	{
+		m_chatStrings[m_chatHead] = line.msg;
+		m_chatSpawnTime[m_chatHead] = gEnv->pTimer->GetAsyncTime().GetMilliSeconds();
+	}
 
 	// flash stuff
-	if (teamChat)
+	SFlashVarValue msg = line.isWide ? SFlashVarValue(line.wideMsg.c_str()) : SFlashVarValue(line.msg.c_str());
+
+	if (line.teamChat)
 	{
-		wstring nameAndTarget = g_pGame->GetHUD()->LocalizeWithParams("@ui_chat_team", true, nick);
-		SFlashVarValue args[3] = { nameAndTarget.c_str(), msg, teamFaction };
+		wstring nameAndTarget = g_pGame->GetHUD()->LocalizeWithParams("@ui_chat_team", true, line.nick.c_str());
+		SFlashVarValue args[3] = { nameAndTarget.c_str(), msg, line.teamFaction };
 		m_flashChat->Invoke("setChatText", args, 3);
 	}
 	else
 	{
-		SFlashVarValue args[3] = { nick, msg, teamFaction };
+		SFlashVarValue args[3] = { line.nick.c_str(), msg, line.teamFaction };
 		m_flashChat->Invoke("setChatText", args, 3);
 	}
 	//m_showing = true;
@@ -454,6 +480,7 @@ void CHUDTextChat::GetMemoryStatistics(ICrySizer* s)
 	s->Add(m_lastInputText);
 	for (int i = 0; i < CHAT_LENGTH; i++)
 		s->Add(m_chatStrings[i]);
+	m_chatQueue.GetMemoryStatistics(s);
 }
 
 void CHUDTextChat::HandleFSCommand(const char* pCommand, const char* pArgs)
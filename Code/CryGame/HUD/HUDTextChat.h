@@ -17,6 +17,7 @@ History:
 //-----------------------------------------------------------------------------------------------------
 
 #include "HUDObject.h"
+#include "HUDMessageQueue.h"
 #include "CryCommon/CryInput/IInput.h"
 #include "CryCommon/CrySystem/IFlashPlayer.h"
 #include "CryCommon/CryAction/IActionMapManager.h"
@@ -24,6 +25,7 @@ History:
 class CGameFlashAnimation;
 
 static const int CHAT_LENGTH = 6;
+static const int CHAT_QUEUE_LENGTH = 32;
 
 
 class CHUDTextChat : public CHUDObject,public IInputEventListener, public IFSCommandHandler
@@ -57,6 +59,9 @@ public:
 	virtual void AddChatMessage(const char* nick, const wchar_t* msg, int teamFaction, bool teamChat);
   virtual void AddChatMessage(const char* nick, const char* msg, int teamFaction, bool teamChat);
 
+	//sends the chat messages of this frame to flash, called once per frame
+	void FlushChatMessages();
+
 	ILINE virtual void ShutDown() {Flush();};
 
 	//open/close chat
@@ -64,6 +69,25 @@ public:
 	ILINE void CloseChat() {Flush();};
 
 private:
+	struct SChatLine
+	{
+		string nick;
+		string msg;
+		wstring wideMsg;
+		int teamFaction;
+		bool isWide;
+		bool teamChat;
+
+		void GetMemoryStatistics(ICrySizer *s)
+		{
+			s->Add(nick);
+			s->Add(msg);
+			s->Add(wideMsg);
+		}
+	};
+
+	void ShowChatLine(const SChatLine &line);
+
 	virtual void Flush(bool close=true);
 	virtual void ProcessInput(const SInputEvent &event);
 	virtual void Delete();
@@ -96,6 +120,9 @@ private:
 	float					m_chatSpawnTime[CHAT_LENGTH];
 	int						m_chatHead;
 
+	//messages waiting for FlushChatMessages
+	CHUDMessageQueue<SChatLine, CHAT_QUEUE_LENGTH> m_chatQueue;
+
 	bool					m_textInputActive;
 	bool					m_showVirtualKeyboard;
 
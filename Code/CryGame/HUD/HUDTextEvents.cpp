@@ -990,33 +990,27 @@ void CHUD::ObituaryMessage(EntityId targetId, EntityId shooterId, const char *we
 		
 	if(bSuicide)
 	{
-		SFlashVarValue args[6] = {"", "Suicide", target.c_str(), headshot, shooterFriendly, targetFriendly};
-		m_animKillLog.Invoke("addLog",args,6);
+		m_pHUDObituary->AddKillLog(L"", L"Suicide", target.c_str(), headshot, shooterFriendly, targetFriendly);
 	}
 	else if(bTurret)
 	{
-		SFlashVarValue args[6] = {"", "AutoTurret", target.c_str(), headshot, shooterFriendly, targetFriendly};
-		m_animKillLog.Invoke("addLog",args,6);
+		m_pHUDObituary->AddKillLog(L"", L"AutoTurret", target.c_str(), headshot, shooterFriendly, targetFriendly);
 	}
 	else if(g_pGame->GetIGameFramework()->GetIVehicleSystem()->IsVehicleClass(weaponClassName))
 	{
-		SFlashVarValue args[6] = {shooter.c_str(), "RunOver", target.c_str(), headshot, shooterFriendly, targetFriendly};
-		m_animKillLog.Invoke("addLog",args,6);
+		m_pHUDObituary->AddKillLog(shooter.c_str(), L"RunOver", target.c_str(), headshot, shooterFriendly, targetFriendly);
 	}
 	else if(bMounted)
 	{
-		SFlashVarValue args[6] = {shooter.c_str(), "Mounted", target.c_str(), headshot, shooterFriendly, targetFriendly};
-		m_animKillLog.Invoke("addLog",args,6);
+		m_pHUDObituary->AddKillLog(shooter.c_str(), L"Mounted", target.c_str(), headshot, shooterFriendly, targetFriendly);
 	}
 	else if(melee)
 	{
-		SFlashVarValue args[6] = {shooter.c_str(), "Melee", target.c_str(), headshot, shooterFriendly, targetFriendly};
-		m_animKillLog.Invoke("addLog",args,6);
+		m_pHUDObituary->AddKillLog(shooter.c_str(), L"Melee", target.c_str(), headshot, shooterFriendly, targetFriendly);
 	}
 	else
 	{
-		SFlashVarValue args[6] = {shooter.c_str(), entity.c_str(), target.c_str(), headshot, shooterFriendly, targetFriendly};
-		m_animKillLog.Invoke("addLog",args,6);
+		m_pHUDObituary->AddKillLog(shooter.c_str(), entity.c_str(), target.c_str(), headshot, shooterFriendly, targetFriendly);
 	}
 }
 
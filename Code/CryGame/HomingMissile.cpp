@@ -203,41 +203,60 @@ void CHomingMissile::UpdateControlledMissile(float frameTime)
 					static const int objTypes = ent_all;
 					static const int flags = (geom_colltype_ray << rwi_colltype_bit) | rwi_colltype_any | (pierceability & rwi_pierceability_mask) | (geom_colltype14 << rwi_colltype_bit);
 
-					IPhysicalWorld* pWorld = gEnv->pPhysicalWorld;
 					static IPhysicalEntity* pSkipEnts[10];
 					int numSkip = CSingle::GetSkipEntities(pWeapon, pSkipEnts, 10);
 
+					float range = m_maxTargetDistance;
+
+					SRayRequest request;
+					request.origin = eyePos + 1.5f * eyeDir;
+					request.dir = eyeDir * range;
+					request.objTypes = objTypes;
+					request.flags = flags;
+					request.SetSkipEntities(pSkipEnts, numSkip);
+
+					// the designator ray is cast with the other queued rays after the entity update,
+					// the destination follows the eye ray of the previous frame
+					CRayBroker& rayBroker = g_pGame->GetWeaponSystem()->GetRayBroker();
+					rayBroker.QueueRay(GetEntityId(), request);
+
 					ray_hit hit;
 					int hits = 0;
 
-					float range = m_maxTargetDistance;
-					hits = pWorld->RayWorldIntersection(eyePos + 1.5f * eyeDir, eyeDir * range, objTypes, flags, &hit, 1, pSkipEnts, numSkip);
-
-					while (hits)
+					if (rayBroker.GetQueuedResult(GetEntityId(), request, hit, hits))
 					{
-						if (gEnv->p3DEngine->RefineRayHit(&hit, eyeDir * range))
-							break;
+						eyeDir = request.dir.GetNormalized();
+						eyePos = request.origin - 1.5f * eyeDir;
 
-						eyePos = hit.pt + eyeDir * 0.003f;
-						range -= hit.dist + 0.003f;
+						while (hits)
+						{
+							if (gEnv->p3DEngine->RefineRayHit(&hit, eyeDir * range))
+								break;
 
-						hits = pWorld->RayWorldIntersection(eyePos, eyeDir * range, objTypes, flags, &hit, 1, pSkipEnts, numSkip);
-					}
+							eyePos = hit.pt + eyeDir * 0.003f;
+							range -= hit.dist + 0.003f;
 
-					DestinationParams params;
+							request.origin = eyePos;
+							request.dir = eyeDir * range;
 
-					if (hits)
-						params.pt = hit.pt;
-					else
-						params.pt = (eyePos + m_maxTargetDistance * eyeDir);	//Some point in the sky...
+							hits = rayBroker.CastRay(request, hit);
+						}
 
-					GetGameObject()->InvokeRMI(SvRequestDestination(), params, eRMI_ToServer);
+						DestinationParams params;
 
-					if (bDebug)
-					{
-						pRenderer->Draw2dLabel(5.0f, y += step, 1.5f, color, false, "PlayerView eye direction: %.3f %.3f %.3f", eyeDir.x, eyeDir.y, eyeDir.z);
-						pRenderer->Draw2dLabel(5.0f, y += step, 1.5f, color, false, "PlayerView Target: %.3f %.3f %.3f", hit.pt.x, hit.pt.y, hit.pt.z);
-						pRenderer->GetIRenderAuxGeom()->DrawCone(m_destination, Vec3(0, 0, -1), 2.5f, 7.f, ColorB(255, 0, 0, 255));
+						if (hits)
+							params.pt = hit.pt;
+						else
+							params.pt = (eyePos + m_maxTargetDistance * eyeDir);	//Some point in the sky...
+
+						GetGameObject()->InvokeRMI(SvRequestDestination(), params, eRMI_ToServer);
+
+						if (bDebug)
+						{
+							pRenderer->Draw2dLabel(5.0f, y += step, 1.5f, color, false, "PlayerView eye direction: %.3f %.3f %.3f", eyeDir.x, eyeDir.y, eyeDir.z);
+							pRenderer->Draw2dLabel(5.0f, y += step, 1.5f, color, false, "PlayerView Target: %.3f %.3f %.3f", hit.pt.x, hit.pt.y, hit.pt.z);
+							pRenderer->GetIRenderAuxGeom()->DrawCone(m_destination, Vec3(0, 0, -1), 2.5f, 7.f, ColorB(255, 0, 0, 255));
+						}
 					}
 				}
 
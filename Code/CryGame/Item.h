@@ -845,6 +845,12 @@ public:
 	// params
 	virtual bool ReadItemParams(const IItemParamsNode *root);
 	virtual bool ReadParams(const IItemParamsNode *params);
+	static void CompileParams(const IItemParamsNode *params, class CItemSharedParams *shared);
+	// the per instance reading that CompileParams replaced, kept as the reference for VerifySharedParams
+	static void ReadLegacyParams(const IItemParamsNode *params, SParams &itemParams, SMountParams &mountParams);
+	static int CompareParams(const char *className, const SParams &a, const SMountParams &am, const SParams &b, const SMountParams &bm, const char *what);
+	// compares the compiled params of all item classes and instances against the legacy reader
+	static void VerifySharedParams();
 	virtual bool ReadGeometry(const IItemParamsNode *geometry);
 	virtual bool ReadActions(const IItemParamsNode *actions);
 	virtual bool ReadAction(const IItemParamsNode *action, SAction *pAction);
@@ -977,6 +983,7 @@ public:
 
 	// freeze
 	virtual void Freeze(bool freeze);
+	bool IsFrozen() const { return m_frozen; }
 
   // damage
   virtual void OnHit(float damage, const char* damageType);
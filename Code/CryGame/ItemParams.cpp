@@ -48,46 +48,86 @@ bool CItem::ReadItemParams(const IItemParamsNode *root)
 	return true;
 }
 
-#define ReadValue(hold, param)	reader.Read(#param, hold.param)
+// every field of SParams read from the params node, shared by reading and verification
+#define ITEM_PARAMS_FIELDS(f) \
+	f(selectable, selectable) \
+	f(droppable, droppable) \
+	f(pickable, pickable) \
+	f(mountable, mountable) \
+	f(usable, usable) \
+	f(giveable, giveable) \
+	f(unique, unique) \
+	f(arms, arms) \
+	f(two_hand, two_hand) \
+	f(mass, mass) \
+	f(fly_timer, fly_timer) \
+	f(drop_impulse, drop_impulse) \
+	f(drop_impulse_pos, drop_impulse_pos) \
+	f(drop_angles, drop_angles) \
+	f(pose, pose) \
+	f(select_override, select_override) \
+	f(attachment_right, attachment[eIH_Right]) \
+	f(attachment_left, attachment[eIH_Left]) \
+	f(dual_wield_suffix, dual_wield_suffix) \
+	f(prone_not_usable, prone_not_usable) \
+	f(raiseable, raiseable) \
+	f(raise_distance, raise_distance) \
+	f(update_hud, update_hud) \
+	f(auto_droppable, auto_droppable) \
+	f(has_first_select, has_first_select) \
+	f(attach_to_back, attach_to_back) \
+	f(scopeAttachment, scopeAttachment) \
+	f(attachment_gives_ammo, attachment_gives_ammo) \
+	f(display_name, display_name) \
+	f(bone_attachment_01, bone_attachment_01) \
+	f(bone_attachment_02, bone_attachment_02) \
+	f(select_on_pickup, select_on_pickup)
+
+// fields of SMountParams read from the mount node
+// min_pitch, max_pitch and yaw_range are per-entity properties set from script
+#define ITEM_MOUNT_PARAMS_FIELDS(f) \
+	f(pivot, pivot) \
+	f(eye_distance, eye_distance) \
+	f(eye_height, eye_height) \
+	f(body_distance, body_distance) \
+	f(left_hand_helper, left_hand_helper) \
+	f(right_hand_helper, right_hand_helper)
+
 #define ReadValueEx(hold, name, param)	reader.Read(#name, hold.param)
 
-//------------------------------------------------------------------------			
+//------------------------------------------------------------------------
 bool CItem::ReadParams(const IItemParamsNode *params)
 {
+	// the params node is the same for all instances of a class, so it's read only once
+	if (!m_sharedparams->Valid())
+		CompileParams(params, m_sharedparams);
+
+	m_params = m_sharedparams->params;
+
+	if (m_sharedparams->hasMountParams)
+	{
+#define CopyMountValue(name, param)	m_mountparams.param = m_sharedparams->mountparams.param;
+		ITEM_MOUNT_PARAMS_FIELDS(CopyMountValue)
+#undef CopyMountValue
+	}
+
+	return true;
+}
+
+//------------------------------------------------------------------------
+void CItem::CompileParams(const IItemParamsNode *params, CItemSharedParams *shared)
+{
+	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
+
+	shared->params = SParams();
+	shared->mountparams = SMountParams();
+	shared->hasMountParams = false;
+
 	{
 		CItemParamReader reader(params);
-		ReadValue(m_params, selectable);
-		ReadValue(m_params, droppable);
-		ReadValue(m_params, pickable);
-		ReadValue(m_params, mountable);
-		ReadValue(m_params, usable);
-		ReadValue(m_params, giveable);
-		ReadValue(m_params, unique);
-		ReadValue(m_params, arms);
-		ReadValue(m_params, two_hand);
-		ReadValue(m_params, mass);
-		ReadValue(m_params, fly_timer);
-		ReadValue(m_params, drop_impulse);
-		ReadValue(m_params, drop_impulse_pos);
-		ReadValue(m_params, drop_angles);
-		ReadValue(m_params, pose);
-		ReadValue(m_params, select_override);
-		ReadValueEx(m_params, attachment_right, attachment[eIH_Right]);
-		ReadValueEx(m_params, attachment_left, attachment[eIH_Left]);
-		ReadValue(m_params, dual_wield_suffix);
-		ReadValue(m_params, prone_not_usable);
-		ReadValue(m_params, raiseable);
-		ReadValue(m_params, raise_distance);
-		ReadValue(m_params, update_hud);
-		ReadValue(m_params, auto_droppable);
-		ReadValue(m_params, has_first_select);
-		ReadValue(m_params, attach_to_back);
-		ReadValue(m_params, scopeAttachment);
-		ReadValue(m_params, attachment_gives_ammo);
-		ReadValue(m_params, display_name);
-		ReadValueEx(m_params, bone_attachment_01, bone_attachment_01);
-		ReadValueEx(m_params, bone_attachment_02, bone_attachment_02);
-		ReadValue(m_params, select_on_pickup);
+#define ReadParamsValue(name, param)	ReadValueEx(shared->params, name, param);
+		ITEM_PARAMS_FIELDS(ReadParamsValue)
+#undef ReadParamsValue
 	}
 
 	const IItemParamsNode *dw = params->GetChild("dualWield");
@@ -97,23 +137,23 @@ bool CItem::ReadParams(const IItemParamsNode *params)
 		for (int i=0; i<n; i++)
 		{
 			const IItemParamsNode *item = dw->GetChild(i);
-			if (!stricmp(dw->GetChildName(i), "item") && !m_sharedparams->Valid())
+			if (!stricmp(dw->GetChildName(i), "item"))
 			{
 				const char *name = item->GetAttribute("value");
 				if (name && name[0])
-					m_sharedparams->dualWieldSupport.insert(TDualWieldSupportMap::value_type(name, true));
+					shared->dualWieldSupport.insert(TDualWieldSupportMap::value_type(name, true));
 			}
 			else if (!stricmp(dw->GetChildName(i), "suffix"))
 			{
 				const char *suffix = item->GetAttribute("value");
 				if (suffix)
-					m_params.dual_wield_suffix = suffix;
+					shared->params.dual_wield_suffix = suffix;
 			}
 			else if (!stricmp(dw->GetChildName(i), "pose"))
 			{
 				const char *pose = item->GetAttribute("value");
 				if (pose)
-					m_params.dual_wield_pose = pose;
+					shared->params.dual_wield_pose = pose;
 			}
 		}
 	}
@@ -122,23 +162,222 @@ bool CItem::ReadParams(const IItemParamsNode *params)
 	if (mp)
 	{
 		CItemParamReader reader(mp);
-		ReadValue(m_mountparams, pivot);
-		ReadValue(m_mountparams, eye_distance);
-		ReadValue(m_mountparams, eye_height);
-		ReadValue(m_mountparams, body_distance);
-//kirill - those are per-entity properties now, set from script
-//		ReadValue(m_mountparams, min_pitch);
-//		ReadValue(m_mountparams, max_pitch);
-//		ReadValue(m_mountparams, yaw_range);
-		ReadValue(m_mountparams, left_hand_helper);
-		ReadValue(m_mountparams, right_hand_helper);
+#define ReadMountValue(name, param)	ReadValueEx(shared->mountparams, name, param);
+		ITEM_MOUNT_PARAMS_FIELDS(ReadMountValue)
+#undef ReadMountValue
+
+		shared->hasMountParams = true;
 	}
+}
 
-	return true;
+#undef ReadValueEx
+
+#define ReadValue(hold, param)	reader.Read(#param, hold.param)
+#define ReadValueEx(hold, name, param)	reader.Read(#name, hold.param)
+
+//------------------------------------------------------------------------
+void CItem::ReadLegacyParams(const IItemParamsNode *params, SParams &itemParams, SMountParams &mountParams)
+{
+	{
+		CItemParamReader reader(params);
+		ReadValue(itemParams, selectable);
+		ReadValue(itemParams, droppable);
+		ReadValue(itemParams, pickable);
+		ReadValue(itemParams, mountable);
+		ReadValue(itemParams, usable);
+		ReadValue(itemParams, giveable);
+		ReadValue(itemParams, unique);
+		ReadValue(itemParams, arms);
+		ReadValue(itemParams, two_hand);
+		ReadValue(itemParams, mass);
+		ReadValue(itemParams, fly_timer);
+		ReadValue(itemParams, drop_impulse);
+		ReadValue(itemParams, drop_impulse_pos);
+		ReadValue(itemParams, drop_angles);
+		ReadValue(itemParams, pose);
+		ReadValue(itemParams, select_override);
+		ReadValueEx(itemParams, attachment_right, attachment[eIH_Right]);
+		ReadValueEx(itemParams, attachment_left, attachment[eIH_Left]);
+		ReadValue(itemParams, dual_wield_suffix);
+		ReadValue(itemParams, prone_not_usable);
+		ReadValue(itemParams, raiseable);
+		ReadValue(itemParams, raise_distance);
+		ReadValue(itemParams, update_hud);
+		ReadValue(itemParams, auto_droppable);
+		ReadValue(itemParams, has_first_select);
+		ReadValue(itemParams, attach_to_back);
+		ReadValue(itemParams, scopeAttachment);
+		ReadValue(itemParams, attachment_gives_ammo);
+		ReadValue(itemParams, display_name);
+		ReadValueEx(itemParams, bone_attachment_01, bone_attachment_01);
+		ReadValueEx(itemParams, bone_attachment_02, bone_attachment_02);
+		ReadValue(itemParams, select_on_pickup);
+	}
+
+	const IItemParamsNode *dw = params->GetChild("dualWield");
+	if (dw)
+	{
+		int n = dw->GetChildCount();
+		for (int i=0; i<n; i++)
+		{
+			const IItemParamsNode *item = dw->GetChild(i);
+			if (!stricmp(dw->GetChildName(i), "suffix"))
+			{
+				const char *suffix = item->GetAttribute("value");
+				if (suffix)
+					itemParams.dual_wield_suffix = suffix;
+			}
+			else if (!stricmp(dw->GetChildName(i), "pose"))
+			{
+				const char *pose = item->GetAttribute("value");
+				if (pose)
+					itemParams.dual_wield_pose = pose;
+			}
+		}
+	}
+
+	const IItemParamsNode *mp = params->GetChild("mount");
+	if (mp)
+	{
+		CItemParamReader reader(mp);
+		ReadValue(mountParams, pivot);
+		ReadValue(mountParams, eye_distance);
+		ReadValue(mountParams, eye_height);
+		ReadValue(mountParams, body_distance);
+		ReadValue(mountParams, left_hand_helper);
+		ReadValue(mountParams, right_hand_helper);
+	}
 }
 
+#undef ReadValueEx
 #undef ReadValue
 
+//------------------------------------------------------------------------
+int CItem::CompareParams(const char *className, const SParams &a, const SMountParams &am, const SParams &b, const SMountParams &bm, const char *what)
+{
+	int mismatches = 0;
+
+	// every member of the structs, not only the ones read from xml, so a field missed by the reader shows up
+#define CompareParam(member) \
+	if (!(a.member == b.member)) \
+	{ \
+		CryLogAlways("$4%s: %s differs in %s", className, #member, what); \
+		++mismatches; \
+	}
+#define CompareMountParam(member) \
+	if (!(am.member == bm.member)) \
+	{ \
+		CryLogAlways("$4%s: mount %s differs in %s", className, #member, what); \
+		++mismatches; \
+	}
+
+	CompareParam(prone_not_usable)
+	CompareParam(raiseable)
+	CompareParam(selectable)
+	CompareParam(droppable)
+	CompareParam(pickable)
+	CompareParam(mountable)
+	CompareParam(usable)
+	CompareParam(giveable)
+	CompareParam(unique)
+	CompareParam(arms)
+	CompareParam(two_hand)
+	CompareParam(fly_timer)
+	CompareParam(mass)
+	CompareParam(drop_impulse)
+	CompareParam(select_override)
+	CompareParam(raise_distance)
+	CompareParam(drop_impulse_pos)
+	CompareParam(drop_angles)
+	CompareParam(update_hud)
+	CompareParam(auto_droppable)
+	CompareParam(scopeAttachment)
+	CompareParam(attachment_gives_ammo)
+	CompareParam(pose)
+	CompareParam(attachment[eIH_Right])
+	CompareParam(attachment[eIH_Left])
+	CompareParam(dual_wield_suffix)
+	CompareParam(dual_wield_pose)
+	CompareParam(display_name)
+	CompareParam(has_first_select)
+	CompareParam(attach_to_back)
+	CompareParam(bone_attachment_01)
+	CompareParam(bone_attachment_02)
+	CompareParam(select_on_pickup)
+
+	// min_pitch, max_pitch and yaw_range are set from script per entity
+	CompareMountParam(eye_distance)
+	CompareMountParam(eye_height)
+	CompareMountParam(body_distance)
+	CompareMountParam(pivot)
+	CompareMountParam(left_hand_helper)
+	CompareMountParam(right_hand_helper)
+
+#undef CompareMountParam
+#undef CompareParam
+
+	return mismatches;
+}
+
+//------------------------------------------------------------------------
+void CItem::VerifySharedParams()
+{
+	IItemSystem *pItemSystem = g_pGame->GetIGameFramework()->GetIItemSystem();
+	CItemSharedParamsList *pList = g_pGame->GetItemSharedParamsList();
+
+	int classes = 0;
+	int instances = 0;
+	int mismatches = 0;
+
+	const int n = pItemSystem->GetItemParamsCount();
+	for (int i=0; i<n; i++)
+	{
+		const char *className = pItemSystem->GetItemParamName(i);
+		const IItemParamsNode *root = pItemSystem->GetItemParams(className);
+		const IItemParamsNode *params = root ? root->GetChild("params") : 0;
+		if (!params)
+			continue;
+
+		// what an instance read from the xml before the params were compiled
+		SParams legacyParams;
+		SMountParams legacyMountParams;
+		ReadLegacyParams(params, legacyParams, legacyMountParams);
+		++classes;
+
+		CItemSharedParams *cached = pList->GetSharedParams(className, false);
+		if (cached && cached->Valid())
+		{
+			mismatches += CompareParams(className, legacyParams, legacyMountParams, cached->params, cached->mountparams, "shared params");
+
+			if (cached->hasMountParams != (params->GetChild("mount") != 0))
+			{
+				CryLogAlways("$4%s: mount differs in shared params", className);
+				++mismatches;
+			}
+		}
+
+		IEntityClass *pClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(className);
+		if (!pClass)
+			continue;
+
+		IEntityItPtr pIt = gEnv->pEntitySystem->GetEntityIterator();
+		while (IEntity *pEntity = pIt->Next())
+		{
+			if (pEntity->GetClass() != pClass)
+				continue;
+
+			CItem *pItem = static_cast<CItem *>(pItemSystem->GetItem(pEntity->GetId()));
+			if (!pItem)
+				continue;
+
+			mismatches += CompareParams(className, legacyParams, legacyMountParams, pItem->m_params, pItem->m_mountparams, pEntity->GetName());
+			++instances;
+		}
+	}
+
+	CryLogAlways("Verified item params of %d classes and %d instances against the legacy reader, %d mismatches", classes, instances, mismatches);
+}
+
 //------------------------------------------------------------------------
 bool CItem::ReadGeometry(const IItemParamsNode *geometry)
 {
@@ -17,14 +17,16 @@ History:
 #include "CryCommon/CryAction/IGameObject.h"
 
 
+// delay before trying again to execute a timer of a frozen or destroyed item
+#define ITEM_TIMER_RETRY_DELAY	100
+
 //------------------------------------------------------------------------
 CItemScheduler::CItemScheduler(CItem *item)
 : m_busy(false),
-	m_pTimer(0),
 	m_pItem(item),
-	m_locked(false)
+	m_locked(false),
+	m_firstTimer(-1)
 {
-	m_pTimer = gEnv->pTimer;
 }
 
 //------------------------------------------------------------------------
@@ -36,16 +38,8 @@ CItemScheduler::~CItemScheduler()
 //------------------------------------------------------------------------
 void CItemScheduler::Reset(bool keepPersistent)
 {
-	for (TTimerActionVector::iterator it = m_timers.begin(); it != m_timers.end();)
-	{
-		if (!it->persist || !keepPersistent)
-		{
-			it->action->destroy();
-			it = m_timers.erase(it);
-		}
-		else
-			it++;
-	}
+	if (m_firstTimer >= 0 && g_pGame)
+		g_pGame->GetItemTimerWheel()->Reset(this, keepPersistent);
 
 	for (TScheduledActionVector::iterator it = m_schedule.begin(); it != m_schedule.end();)
 	{
@@ -58,7 +52,7 @@ void CItemScheduler::Reset(bool keepPersistent)
 			it++;
 	}
 
-	if (m_timers.empty() && m_schedule.empty())
+	if (m_schedule.empty())
 		m_pItem->EnableUpdate(false, eIUS_Scheduler);
 
   SetBusy(false);
@@ -67,55 +61,18 @@ void CItemScheduler::Reset(bool keepPersistent)
 //------------------------------------------------------------------------
 void CItemScheduler::Update(float frameTime)
 {
-	if (frameTime > 0.2f)
-		frameTime = 0.2f;
-
-	if (!m_schedule.empty())
+	// timers are executed by CItemTimerWheel, only actions waiting for the item to stop being busy are left here
+	while(!m_schedule.empty() && !m_busy)
 	{
-		while(!m_schedule.empty() && !m_busy)
-		{
-			SScheduledAction &action = *m_schedule.begin();
-			ISchedulerAction *pAction= action.action;
-			m_schedule.erase(m_schedule.begin());
+		SScheduledAction &action = *m_schedule.begin();
+		ISchedulerAction *pAction= action.action;
+		m_schedule.erase(m_schedule.begin());
 
-			pAction->execute(m_pItem);
-			pAction->destroy();
-		}
+		pAction->execute(m_pItem);
+		pAction->destroy();
 	}
 
-	if (!m_timers.empty())
-	{
-		uint count=0;
-		m_actives.swap(m_timers);
-
-		for (TTimerActionVector::iterator it = m_actives.begin(); it != m_actives.end(); it++)
-		{
-			STimerAction &action = *it;
-			action.time -= frameTime;
-			if (action.time <= 0.0f)
-			{
-				action.action->execute(m_pItem);
-				action.action->destroy();
-				++count;
-			}
-		}
-
-		if (count)
-			m_actives.erase(m_actives.begin(), m_actives.begin()+count);
-
-		if (!m_timers.empty())
-		{
-			for (TTimerActionVector::iterator it=m_timers.begin(); it!=m_timers.end(); ++it)
-				m_actives.push_back(*it);
-
-			std::sort(m_actives.begin(), m_actives.end(), compare_timers());
-		}
-
-		m_actives.swap(m_timers);
-		m_actives.resize(0);
-	}
-
-	if (m_timers.empty() && m_schedule.empty())
+	if (m_schedule.empty())
 		m_pItem->EnableUpdate(false, eIUS_Scheduler);
 }
 
@@ -146,15 +103,7 @@ void CItemScheduler::TimerAction(uint time, ISchedulerAction *action, bool persi
 	if (m_locked)
 		return;
 
-	STimerAction timerAction;
-	timerAction.action = action;
-	timerAction.time = (float)time/1000.0f;
-	timerAction.persist = persistent;
-
-	m_timers.push_back(timerAction);
-	std::sort(m_timers.begin(), m_timers.end(), compare_timers());
-
-	m_pItem->EnableUpdate(true, eIUS_Scheduler);
+	g_pGame->GetItemTimerWheel()->Add(this, time, action, persistent);
 }
 
 //------------------------------------------------------------------------
@@ -180,13 +129,311 @@ bool CItemScheduler::IsLocked()
 
 void CItemScheduler::GetMemoryStatistics(ICrySizer * s)
 {
-	s->AddContainer(m_timers);
-	s->AddContainer(m_actives);
 	s->AddContainer(m_schedule);
-	for (size_t i=0; i<m_timers.size(); i++)
-		m_timers[i].action->GetMemoryStatistics(s);
-	for (size_t i=0; i<m_actives.size(); i++)
-		m_actives[i].action->GetMemoryStatistics(s);
 	for (size_t i=0; i<m_schedule.size(); i++)
 		m_schedule[i].action->GetMemoryStatistics(s);
+
+	if (m_firstTimer >= 0 && g_pGame)
+		g_pGame->GetItemTimerWheel()->GetMemoryStatistics(this, s);
+}
+
+//------------------------------------------------------------------------
+CItemTimerWheel::CItemTimerWheel()
+: m_free(-1),
+	m_count(0),
+	m_currentTick(0),
+	m_updateEndTick(0),
+	m_updating(false),
+	m_remainder(0.0f)
+{
+	for (int i=0; i<=eTWL_ListCount; i++)
+	{
+		m_heads[i] = -1;
+		m_tails[i] = -1;
+	}
+}
+
+//------------------------------------------------------------------------
+CItemTimerWheel::~CItemTimerWheel()
+{
+	for (TTimerVector::iterator it = m_timers.begin(); it != m_timers.end(); ++it)
+	{
+		if (it->list >= 0)
+		{
+			it->owner->m_firstTimer = -1;
+			it->action->destroy();
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+int CItemTimerWheel::AllocTimer()
+{
+	if (m_free >= 0)
+	{
+		int idx = m_free;
+		m_free = m_timers[idx].next;
+		return idx;
+	}
+
+	m_timers.push_back(STimer());
+
+	return (int)m_timers.size()-1;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::FreeTimer(int idx)
+{
+	STimer &timer = m_timers[idx];
+	timer.action = 0;
+	timer.owner = 0;
+	timer.list = -1;
+	timer.next = m_free;
+
+	m_free = idx;
+	--m_count;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Link(int idx, int list)
+{
+	STimer &timer = m_timers[idx];
+	timer.list = list;
+	timer.prev = m_tails[list];
+	timer.next = -1;
+
+	if (m_tails[list] >= 0)
+		m_timers[m_tails[list]].next = idx;
+	else
+		m_heads[list] = idx;
+
+	m_tails[list] = idx;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Unlink(int idx)
+{
+	STimer &timer = m_timers[idx];
+
+	if (timer.prev >= 0)
+		m_timers[timer.prev].next = timer.next;
+	else
+		m_heads[timer.list] = timer.next;
+
+	if (timer.next >= 0)
+		m_timers[timer.next].prev = timer.prev;
+	else
+		m_tails[timer.list] = timer.prev;
+
+	timer.prev = -1;
+	timer.next = -1;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::UnlinkOwner(int idx)
+{
+	STimer &timer = m_timers[idx];
+
+	if (timer.ownerPrev >= 0)
+		m_timers[timer.ownerPrev].ownerNext = timer.ownerNext;
+	else
+		timer.owner->m_firstTimer = timer.ownerNext;
+
+	if (timer.ownerNext >= 0)
+		m_timers[timer.ownerNext].ownerPrev = timer.ownerPrev;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Insert(int idx)
+{
+	const uint expireTick = m_timers[idx].expireTick;
+	const uint delay = expireTick - m_currentTick;
+
+	if (delay < eTWL_FirstSize)
+	{
+		Link(idx, expireTick & (eTWL_FirstSize-1));
+		return;
+	}
+
+	for (int level=1; level<eTWL_Levels; level++)
+	{
+		const int levelShift = eTWL_FirstBits + (level-1)*eTWL_UpperBits;
+
+		if (delay < (1u << (levelShift + eTWL_UpperBits)) || level == eTWL_Levels-1)
+		{
+			const int slot = (expireTick >> levelShift) & (eTWL_UpperSize-1);
+			Link(idx, eTWL_FirstSize + (level-1)*eTWL_UpperSize + slot);
+			return;
+		}
+	}
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Cascade(int level, int slot)
+{
+	const int list = eTWL_FirstSize + (level-1)*eTWL_UpperSize + slot;
+
+	int idx = m_heads[list];
+	m_heads[list] = -1;
+	m_tails[list] = -1;
+
+	// timers keep their order when moved to the lower levels
+	while (idx >= 0)
+	{
+		const int next = m_timers[idx].next;
+		Insert(idx);
+		idx = next;
+	}
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::ExpireSlot(int slot)
+{
+	if (m_heads[slot] < 0)
+		return;
+
+	for (int idx = m_heads[slot]; idx >= 0; idx = m_timers[idx].next)
+		m_timers[idx].list = eTWL_Expiring;
+
+	m_heads[eTWL_Expiring] = m_heads[slot];
+	m_tails[eTWL_Expiring] = m_tails[slot];
+	m_heads[slot] = -1;
+	m_tails[slot] = -1;
+
+	// executed actions may add new timers or remove any timer, including the expiring ones
+	int idx;
+	while ((idx = m_heads[eTWL_Expiring]) >= 0)
+	{
+		CItem *pItem = m_timers[idx].owner->m_pItem;
+
+		Unlink(idx);
+
+		// the item does not update while frozen or destroyed, so its timers wait too
+		if (pItem->IsFrozen() || pItem->IsDestroyed())
+		{
+			m_timers[idx].expireTick = m_currentTick + ITEM_TIMER_RETRY_DELAY;
+			Insert(idx);
+			continue;
+		}
+
+		ISchedulerAction *pAction = m_timers[idx].action;
+
+		UnlinkOwner(idx);
+		FreeTimer(idx);
+
+		pAction->execute(pItem);
+		pAction->destroy();
+	}
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Add(CItemScheduler *owner, uint time, ISchedulerAction *action, bool persistent)
+{
+	const int idx = AllocTimer();
+
+	STimer &timer = m_timers[idx];
+	timer.action = action;
+	timer.owner = owner;
+	timer.persist = persistent;
+	// never expire in the current tick
+	timer.expireTick = m_currentTick + CLAMP(time, 1u, (uint)eTWL_MaxDelay);
+
+	// timers added by executed actions wait for the next update, so they cannot chain within a frame
+	if (m_updating && (int)(timer.expireTick - m_updateEndTick) <= 0)
+		timer.expireTick = m_updateEndTick + 1;
+
+	timer.ownerPrev = -1;
+	timer.ownerNext = owner->m_firstTimer;
+	if (owner->m_firstTimer >= 0)
+		m_timers[owner->m_firstTimer].ownerPrev = idx;
+	owner->m_firstTimer = idx;
+
+	Insert(idx);
+
+	++m_count;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Reset(CItemScheduler *owner, bool keepPersistent)
+{
+	int idx = owner->m_firstTimer;
+
+	while (idx >= 0)
+	{
+		const int next = m_timers[idx].ownerNext;
+
+		if (!m_timers[idx].persist || !keepPersistent)
+		{
+			ISchedulerAction *pAction = m_timers[idx].action;
+
+			Unlink(idx);
+			UnlinkOwner(idx);
+			FreeTimer(idx);
+
+			pAction->destroy();
+		}
+
+		idx = next;
+	}
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::Update(float frameTime)
+{
+	if (frameTime > 0.2f)
+		frameTime = 0.2f;
+
+	m_remainder += frameTime*1000.0f;
+
+	const uint ticks = (uint)m_remainder;
+	m_remainder -= (float)ticks;
+
+	if (!m_count)
+	{
+		// nothing to cascade or expire
+		m_currentTick += ticks;
+		return;
+	}
+
+	m_updateEndTick = m_currentTick + ticks;
+	m_updating = true;
+
+	for (uint i=0; i<ticks; i++)
+	{
+		++m_currentTick;
+
+		const int index = m_currentTick & (eTWL_FirstSize-1);
+
+		if (!index)
+		{
+			for (int level=1; level<eTWL_Levels; level++)
+			{
+				const int slot = (m_currentTick >> (eTWL_FirstBits + (level-1)*eTWL_UpperBits)) & (eTWL_UpperSize-1);
+
+				Cascade(level, slot);
+
+				if (slot)
+					break;
+			}
+		}
+
+		ExpireSlot(index);
+	}
+
+	m_updating = false;
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::GetMemoryStatistics(ICrySizer * s)
+{
+	SIZER_SUBCOMPONENT_NAME(s, "ItemTimerWheel");
+	s->Add(*this);
+	s->AddContainer(m_timers);
+}
+
+//------------------------------------------------------------------------
+void CItemTimerWheel::GetMemoryStatistics(CItemScheduler *owner, ICrySizer * s)
+{
+	for (int idx = owner->m_firstTimer; idx >= 0; idx = m_timers[idx].ownerNext)
+		m_timers[idx].action->GetMemoryStatistics(s);
 }
@@ -75,29 +75,16 @@ typename CSchedulerAction<T>::Alloc CSchedulerAction<T>::m_alloc;
 
 class CItemScheduler
 {
+	friend class CItemTimerWheel;
+
 	struct SScheduledAction
 	{
 		ISchedulerAction	*action;
 		bool							persist;
 	};
-	struct STimerAction
-	{
-		ISchedulerAction	*action;
-		float							time;
-		bool							persist;
-	};
 
-	typedef std::vector<STimerAction>									TTimerActionVector;
 	typedef std::vector<SScheduledAction>							TScheduledActionVector;
 
-	struct compare_timers
-	{
-		bool operator() (const STimerAction &lhs, const STimerAction &rhs ) const
-		{
-			return lhs.time < rhs.time;
-		}
-	};
-
 public:
 	CItemScheduler(CItem *item);
 	virtual ~CItemScheduler();
@@ -116,14 +103,79 @@ public:
 private:
 	bool				m_locked;
 	bool				m_busy;
-	ITimer			*m_pTimer;
 	CItem				*m_pItem;
 
-	TTimerActionVector				m_timers;
-	TTimerActionVector				m_actives;
+	int												m_firstTimer;		// list of this item's timers in the timer wheel
 	TScheduledActionVector		m_schedule;
 };
 
 
+// Game-wide timer wheel executing timed actions of all items.
+// Time is counted in milliseconds. The first level has one slot per millisecond and each upper level
+// covers the whole range of the level below in a single slot. Upper level slots are moved down when
+// the level below wraps around, so adding and removing a timer is O(1) and expired timers are
+// executed a whole slot at a time.
+class CItemTimerWheel
+{
+	enum
+	{
+		eTWL_Levels = 4,
+		eTWL_FirstBits = 8,
+		eTWL_FirstSize = 1 << eTWL_FirstBits,
+		eTWL_UpperBits = 6,
+		eTWL_UpperSize = 1 << eTWL_UpperBits,
+		eTWL_MaxDelay = (1 << (eTWL_FirstBits + (eTWL_Levels - 1) * eTWL_UpperBits)) - 1,
+		eTWL_ListCount = eTWL_FirstSize + (eTWL_Levels - 1) * eTWL_UpperSize,
+		eTWL_Expiring = eTWL_ListCount,	// list of timers being executed
+	};
+
+	struct STimer
+	{
+		ISchedulerAction	*action;
+		CItemScheduler		*owner;
+		uint							expireTick;
+		int								list;
+		int								prev;
+		int								next;
+		int								ownerPrev;
+		int								ownerNext;
+		bool							persist;
+	};
+
+	typedef std::vector<STimer>	TTimerVector;
+
+public:
+	CItemTimerWheel();
+	~CItemTimerWheel();
+
+	void Add(CItemScheduler *owner, uint time, ISchedulerAction *action, bool persistent);
+	// removes timers of the owner, keeping persistent ones if requested
+	void Reset(CItemScheduler *owner, bool keepPersistent);
+	void Update(float frameTime);
+	void GetMemoryStatistics(ICrySizer * s);
+	void GetMemoryStatistics(CItemScheduler *owner, ICrySizer * s);
+
+private:
+	int AllocTimer();
+	void FreeTimer(int idx);
+	void Insert(int idx);
+	void Link(int idx, int list);
+	void Unlink(int idx);
+	void UnlinkOwner(int idx);
+	void Cascade(int level, int slot);
+	void ExpireSlot(int slot);
+
+	TTimerVector	m_timers;
+	int						m_free;
+	int						m_count;
+	int						m_heads[eTWL_ListCount + 1];
+	int						m_tails[eTWL_ListCount + 1];
+	uint					m_currentTick;
+	uint					m_updateEndTick;	// last tick of the running update
+	bool					m_updating;
+	float					m_remainder;
+};
+
+
 
 #endif //__ITEMSCHEDULER_H__
@@ -21,6 +21,9 @@ void CItemSharedParams::GetMemoryStatistics(ICrySizer *s)
 	s->AddContainer(helpers);
 	s->AddContainer(layers);
 	s->AddContainer(dualWieldSupport);
+	params.GetMemoryStatistics(s);
+	mountparams.GetMemoryStatistics(s);
+	s->Add(meleeAttackFireMode);
 
 	for (CItem::TActionMap::iterator iter = actions.begin(); iter != actions.end(); ++iter)
 		s->Add(iter->first);
@@ -29,7 +29,7 @@ protected:
 	mutable uint	m_refs;
 	bool					m_valid;
 public:
-	CItemSharedParams(): m_refs(0), m_valid(false) {};
+	CItemSharedParams(): m_refs(0), m_valid(false), hasMountParams(false) {};
 	virtual ~CItemSharedParams() {};
 
 	virtual void AddRef() const { ++m_refs; };
@@ -49,6 +49,12 @@ public:
 	CItem::THelperVector				helpers;
 	CItem::TLayerMap						layers;
 	CItem::TDualWieldSupportMap	dualWieldSupport;
+
+	// compiled from the params node once per class, copied into every instance
+	CItem::SParams							params;
+	CItem::SMountParams					mountparams;
+	bool												hasMountParams;
+	string											meleeAttackFireMode;
 };
 
 
@@ -89,6 +89,9 @@ void CFlashMenuObject::AddProfile(const char* profileName)
 
 		const char* userName = m_pPlayerProfileManager->GetCurrentUser();
 
+		//the new profile is a copy of the current one
+		g_pGame->GetOptions()->FlushProfile();
+
 		IPlayerProfileManager::EProfileOperationResult result;
 		bool bDone = m_pPlayerProfileManager->CreateProfile(userName, sName.c_str(), false, result);
 		if (bDone)
@@ -155,6 +158,9 @@ void CFlashMenuObject::SelectProfile(const char* profileName, bool silent, bool
 
 void CFlashMenuObject::SwitchProfiles(const char* oldProfile, const char* newProfile)
 {
+	//pending changes belong to the current profile
+	g_pGame->GetOptions()->FlushProfile();
+
 	const char* userName = m_pPlayerProfileManager->GetCurrentUser();
 	if (oldProfile)
 	{
@@ -183,6 +189,9 @@ void CFlashMenuObject::SelectActiveProfile()
 	IPlayerProfileManager* pMan = g_pGame->GetOptions()->GetProfileManager();
 	if (!pMan) return;
 
+	//pending changes belong to the current profile
+	g_pGame->GetOptions()->FlushProfile();
+
 	const char* userName = pMan->GetCurrentUser();
 
 	for (int i = 0; i < pMan->GetProfileCount(userName); ++i)
@@ -210,6 +219,9 @@ void CFlashMenuObject::DeleteProfile(const char* profileName)
 {
 	if (!m_pPlayerProfileManager)
 		return;
+	//pending changes belong to the current profile, which may be the deleted one
+	g_pGame->GetOptions()->FlushProfile();
+
 	const char* userName = m_pPlayerProfileManager->GetCurrentUser();
 	IPlayerProfileManager::EProfileOperationResult result;
 	m_pPlayerProfileManager->DeleteProfile(userName, profileName, result);
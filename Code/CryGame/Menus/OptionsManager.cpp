@@ -12,7 +12,11 @@ History:
 
 *************************************************************************/
 
+#include <condition_variable>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <mutex>
 
 #include "CryGame/StdAfx.h"
 #include "OptionsManager.h"
@@ -22,6 +26,8 @@ History:
 #include "CryGame/Game.h"
 #include "CryGame/HUD/HUD.h"
 #include "Launcher/GameWindow.h"
+#include "Client/Client.h"
+#include "Client/Executor.h"
 
 //-----------------------------------------------------------------------------------------------------
 
@@ -31,12 +37,28 @@ History:
 #define CRYSIS_PROFILE_COLOR_RED   "7474188"
 #define CRYSIS_PROFILE_COLOR_WHITE "13553087"
 
+//seconds without profile changes before they are written to disk
+#define PROFILE_SAVE_DELAY 0.5f
+
 //-----------------------------------------------------------------------------------------------------
 
 COptionsManager* COptionsManager::sp_optionsManager = NULL;
 
 //-----------------------------------------------------------------------------------------------------
 
+struct COptionsManager::SGameCfgWriter
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::string path;
+	std::string content;
+	bool hasContent = false;	//not taken by a writer yet
+	bool isQueued = false;		//executor task queued or running
+	bool isWriting = false;		//executor task writing the file
+};
+
+//-----------------------------------------------------------------------------------------------------
+
 COptionsManager::COptionsManager() : m_pPlayerProfileManager(NULL)
 {
 	m_defaultColorLine = "4481854";
@@ -48,6 +70,10 @@ COptionsManager::COptionsManager() : m_pPlayerProfileManager(NULL)
 	m_pbEnabled = false;
 	m_firstStart = false;
 
+	m_profileDirty = false;
+
+	m_pGameCfgWriter = std::make_shared<SGameCfgWriter>();
+
 	InitOpFuncMap();
 }
 
@@ -527,8 +553,7 @@ void COptionsManager::SaveCVarToProfile(const char* key, const string& value)
 		return;
 
 	pProfile->SetAttribute(key, value);
-	IPlayerProfileManager::EProfileOperationResult result;
-	m_pPlayerProfileManager->SaveProfile(m_pPlayerProfileManager->GetCurrentUser(), result);
+	MarkProfileDirty();
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -614,7 +639,7 @@ void COptionsManager::SaveValueToProfile(const char* key, const string& value)
 		return;
 
 	pProfile->SetAttribute(key, value);
-	SaveProfile();
+	MarkProfileDirty();
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -629,7 +654,7 @@ void COptionsManager::SaveValueToProfile(const char* key, bool value)
 		return;
 
 	pProfile->SetAttribute(key, value);
-	SaveProfile();
+	MarkProfileDirty();
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -644,7 +669,7 @@ void COptionsManager::SaveValueToProfile(const char* key, int value)
 		return;
 
 	pProfile->SetAttribute(key, value);
-	SaveProfile();
+	MarkProfileDirty();
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -659,7 +684,7 @@ void COptionsManager::SaveValueToProfile(const char* key, float value)
 		return;
 
 	pProfile->SetAttribute(key, value);
-	SaveProfile();
+	MarkProfileDirty();
 }
 
 //-----------------------------------------------------------------------------------------------------
@@ -668,10 +693,42 @@ void COptionsManager::SaveProfile()
 {
 	if (!m_pPlayerProfileManager)
 		return;
+	m_profileDirty = false;
 	IPlayerProfileManager::EProfileOperationResult result;
 	m_pPlayerProfileManager->SaveProfile(m_pPlayerProfileManager->GetCurrentUser(), result);
 	WriteGameCfg();
 }
+
+//-----------------------------------------------------------------------------------------------------
+
+void COptionsManager::MarkProfileDirty()
+{
+	m_profileDirty = true;
+	m_profileDirtyTime = gEnv->pTimer->GetAsyncTime();
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void COptionsManager::Update()
+{
+	if (!m_profileDirty)
+		return;
+
+	if ((gEnv->pTimer->GetAsyncTime() - m_profileDirtyTime).GetSeconds() < PROFILE_SAVE_DELAY)
+		return;
+
+	SaveProfile();
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void COptionsManager::FlushProfile()
+{
+	if (m_profileDirty)
+		SaveProfile();
+
+	WaitForGameCfg();
+}
 //-----------------------------------------------------------------------------------------------------
 
 void COptionsManager::OnElementFound(ICVar* pCVar)
@@ -865,20 +922,120 @@ CFlashMenuScreen* COptionsManager::GetCurrentMenu()
 
 bool COptionsManager::WriteGameCfg()
 {
-	FILE* pFile = fxopen("%USER%/game.cfg", "wb");
-	if (pFile == 0)
-		return false;
+	// the cvars are read here, only the file is written in the background
+	string content;
+	content += "-- [Game-Configuration]\r\n";
+	content += "-- Attention: This file is re-generated by the system! Editing is not recommended! \r\n\r\n";
 
-	fputs("-- [Game-Configuration]\r\n", pFile);
-	fputs("-- Attention: This file is re-generated by the system! Editing is not recommended! \r\n\r\n", pFile);
-
-	CCVarSink sink(this, pFile);
+	CCVarSink sink(this, &content);
 	gEnv->pConsole->DumpCVars(&sink);
 
-	fclose(pFile);
+	char path[_MAX_PATH];
+	const int adjustFlags = ICryPak::FLAGS_NO_MASTER_FOLDER_MAPPING | ICryPak::FLAGS_FOR_WRITING;
+	string filePath = gEnv->pCryPak->AdjustFileName("%USER%/game.cfg", path, adjustFlags);
+
+	std::shared_ptr<SGameCfgWriter> pWriter = m_pGameCfgWriter;
+
+	{
+		std::lock_guard<std::mutex> lock(pWriter->mutex);
+
+		// string is copy-on-write with a non-atomic refcount, the writer gets deep copies it owns alone
+		// content not written yet is replaced, the last one wins
+		pWriter->path.assign(filePath.c_str(), filePath.length());
+		pWriter->content.assign(content.c_str(), content.length());
+		pWriter->hasContent = true;
+
+		if (pWriter->isQueued)
+			return true;
+
+		pWriter->isQueued = true;
+	}
+
+	// one task writes until no content is left, so writes never overlap
+	gClient->GetExecutor()->RunAsync([pWriter]()
+	{
+		for (;;)
+		{
+			std::string path;
+			std::string content;
+
+			{
+				std::lock_guard<std::mutex> lock(pWriter->mutex);
+
+				if (!pWriter->hasContent)
+				{
+					pWriter->isQueued = false;
+					return;
+				}
+
+				path.swap(pWriter->path);
+				content.swap(pWriter->content);
+				pWriter->hasContent = false;
+				pWriter->isWriting = true;
+			}
+
+			WriteFileAtomic(path, content);
+
+			std::lock_guard<std::mutex> lock(pWriter->mutex);
+			pWriter->isWriting = false;
+			pWriter->cv.notify_all();
+		}
+	});
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------------------------------
+
+void COptionsManager::WaitForGameCfg()
+{
+	SGameCfgWriter& writer = *m_pGameCfgWriter;
+
+	std::unique_lock<std::mutex> lock(writer.mutex);
+
+	writer.cv.wait(lock, [&writer]() { return !writer.isWriting; });
+
+	if (!writer.hasContent)
+		return;
+
+	// the executor may be busy with other tasks, so content it has not taken yet is written here
+	std::string path;
+	std::string content;
+	path.swap(writer.path);
+	content.swap(writer.content);
+	writer.hasContent = false;
+
+	lock.unlock();
+
+	WriteFileAtomic(path, content);
+}
+
+//-----------------------------------------------------------------------------------------------------
+
+void COptionsManager::WriteFileAtomic(const std::string& path, const std::string& content)
+{
+	// write a temporary file and replace the old one only once it is complete
+	const std::string tempPath = path + ".tmp";
+
+	FILE* pFile = std::fopen(tempPath.c_str(), "wb");
+	if (!pFile)
+		return;
+
+	const bool written = std::fwrite(content.data(), 1, content.length(), pFile) == content.length();
+
+	if (std::fclose(pFile) != 0 || !written)
+	{
+		std::remove(tempPath.c_str());
+		return;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempPath.c_str(), path.c_str(), error);
+
+	if (error)
+		std::remove(tempPath.c_str());
+}
+
 void COptionsManager::CCVarSink::OnElementFound(ICVar* pCVar)
 {
 	if (pCVar == 0)
@@ -932,5 +1089,5 @@ void COptionsManager::CCVarSink::OnElementFound(ICVar* pCVar)
 	else
 		szLine += " = " + szValue + "\r\n";
 
-	fputs(szLine.c_str(), m_pFile);
+	m_pContent->append(szLine.c_str());
 }
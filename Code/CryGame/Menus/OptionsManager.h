@@ -17,6 +17,9 @@ History:
 
 #pragma once
 
+#include <memory>
+#include <string>
+
 #include "CryCommon/CryAction/IGameFramework.h"
 #include "CryGame/GameCVars.h"
 
@@ -48,6 +51,7 @@ public :
 
 	~COptionsManager() 
 	{
+		WaitForGameCfg();
 		sp_optionsManager = 0;
 	};
 
@@ -86,7 +90,12 @@ public :
 	void SaveValueToProfile(const char* key, int value);
 	void SaveValueToProfile(const char* key, float value);
 	void SaveValueToProfile(const char* key, const string& value);
+	//writes the profile and game.cfg now, SaveValueToProfile only marks the profile for a deferred save
 	void SaveProfile();
+	//saves pending profile changes, called on shutdown
+	void FlushProfile();
+	//saves pending profile changes once they stopped coming in
+	void Update();
 	const char* GetProfileName();
 	void CVarToProfile();
 	void ProfileToCVar();
@@ -100,17 +109,23 @@ public :
 private:
 	struct CCVarSink : public ICVarDumpSink
 	{
-		CCVarSink(COptionsManager* pMgr, FILE* pFile)
+		CCVarSink(COptionsManager* pMgr, string* pContent)
 		{
 			m_pOptionsManager = pMgr;
-			m_pFile = pFile;
+			m_pContent = pContent;
 		}
 
 		void OnElementFound(ICVar *pCVar);
 		COptionsManager* m_pOptionsManager;
-		FILE* m_pFile;
+		string* m_pContent;
 	};
 
+	struct SGameCfgWriter;
+
+	void MarkProfileDirty();
+	void WaitForGameCfg();
+	static void WriteFileAtomic(const std::string& path, const std::string& content);
+
 	COptionsManager();
 	IPlayerProfileManager* m_pPlayerProfileManager;
 
@@ -151,6 +166,13 @@ private:
 	bool m_pbEnabled;
 	bool m_firstStart;
 
+	//profile changes not saved yet
+	bool m_profileDirty;
+	CTimeValue m_profileDirtyTime;
+
+	//game.cfg content waiting for the executor, shared with its task
+	std::shared_ptr<SGameCfgWriter> m_pGameCfgWriter;
+
 };
 
 //-----------------------------------------------------------------------------------------------------
@@ -466,6 +466,9 @@ void CProjectile::ProcessEvent(SEntityEvent& event)
 {
 	switch (event.event)
 	{
+	case ENTITY_EVENT_XFORM:
+		g_pGame->GetWeaponSystem()->MoveProjectile(this);
+		break;
 	case ENTITY_EVENT_TIMER:
 	{
 		switch (event.nParam[0])
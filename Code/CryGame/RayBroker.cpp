@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "CryCommon/CrySystem/ISystem.h"
+#include "CryCommon/CrySystem/ITimer.h"
+
+#include "RayBroker.h"
+
+void SRayRequest::SetSkipEntities(IPhysicalEntity **pEnts, int count)
+{
+	skipCount = std::min(count, MAX_SKIP);
+
+	for (int i = 0; i < skipCount; i++)
+	{
+		pSkipEnts[i] = pEnts[i];
+	}
+}
+
+bool SRayRequest::operator==(const SRayRequest & other) const
+{
+	return origin == other.origin
+	    && dir == other.dir
+	    && objTypes == other.objTypes
+	    && flags == other.flags
+	    && skipCount == other.skipCount
+	    && std::equal(pSkipEnts, pSkipEnts + skipCount, other.pSkipEnts);
+}
+
+int CRayBroker::Cast(const SRayRequest & request, ray_hit & hit)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	// the skip list is not modified, the interface just lacks const
+	IPhysicalEntity **pSkipEnts = const_cast<IPhysicalEntity**>(request.pSkipEnts);
+
+	const int hits = gEnv->pPhysicalWorld->RayWorldIntersection(request.origin, request.dir, request.objTypes, request.flags,
+	                                                            &hit, 1, pSkipEnts, request.skipCount);
+
+	const std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - start;
+
+	m_castCount++;
+	m_castTimeMs += duration.count();
+
+	return hits;
+}
+
+const CRayBroker::SRayResult *CRayBroker::FindCached(const SRayRequest & request)
+{
+	const CTimeValue frameTime = gEnv->pTimer->GetFrameStartTime();
+
+	if (m_cacheFrameTime != frameTime)
+	{
+		m_cacheFrameTime = frameTime;
+		m_frameCache.clear();
+		return nullptr;
+	}
+
+	for (const SRayResult & cached : m_frameCache)
+	{
+		if (cached.request == request)
+		{
+			return &cached;
+		}
+	}
+
+	return nullptr;
+}
+
+int CRayBroker::CastRay(const SRayRequest & request, ray_hit & hit)
+{
+	m_requestCount++;
+
+	if (const SRayResult *pCached = FindCached(request))
+	{
+		hit = pCached->hit;
+		return pCached->hits;
+	}
+
+	SRayResult & result = m_frameCache.emplace_back();
+	result.request = request;
+	result.hits = Cast(request, result.hit);
+
+	hit = result.hit;
+
+	return result.hits;
+}
+
+void CRayBroker::QueueRay(EntityId ownerId, const SRayRequest & request)
+{
+	m_requestCount++;
+
+	auto it = std::find_if(m_queue.begin(), m_queue.end(), [ownerId](const SQueuedRay & queued)
+	{
+		return queued.ownerId == ownerId;
+	});
+
+	if (it == m_queue.end())
+	{
+		it = m_queue.insert(m_queue.end(), SQueuedRay());
+		it->ownerId = ownerId;
+	}
+
+	it->result.request = request;
+	it->isQueued = true;
+}
+
+bool CRayBroker::GetQueuedResult(EntityId ownerId, SRayRequest & request, ray_hit & hit, int & hits) const
+{
+	for (const SQueuedRay & queued : m_queue)
+	{
+		if (queued.ownerId == ownerId)
+		{
+			if (!queued.isReady)
+			{
+				return false;
+			}
+
+			request = queued.result.request;
+			hit = queued.result.hit;
+			hits = queued.result.hits;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CRayBroker::Flush()
+{
+	// owners that stopped queueing rays are dropped
+	m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [](const SQueuedRay & queued)
+	{
+		return !queued.isQueued;
+	}), m_queue.end());
+
+	for (size_t i = 0; i < m_queue.size(); i++)
+	{
+		SQueuedRay & queued = m_queue[i];
+
+		// several weapons of the same actor often probe along the same eye ray
+		const SQueuedRay *pSame = nullptr;
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (m_queue[j].result.request == queued.result.request)
+			{
+				pSame = &m_queue[j];
+				break;
+			}
+		}
+
+		if (pSame)
+		{
+			queued.result.hit = pSame->result.hit;
+			queued.result.hits = pSame->result.hits;
+		}
+		else
+		{
+			queued.result.hits = Cast(queued.result.request, queued.result.hit);
+		}
+
+		queued.isQueued = false;
+		queued.isReady = true;
+	}
+}
+
+void CRayBroker::Reset()
+{
+	m_frameCache.clear();
+	m_queue.clear();
+}
+
+void CRayBroker::LogStatistics()
+{
+	const unsigned int savedCount = m_requestCount - std::min(m_castCount, m_requestCount);
+
+	CryLogAlways("[RayBroker] %u ray requests, %u casts, %u saved, %.3f ms in physics",
+	             m_requestCount, m_castCount, savedCount, m_castTimeMs);
+
+	m_requestCount = 0;
+	m_castCount = 0;
+	m_castTimeMs = 0;
+}
+
+void CRayBroker::GetMemoryStatistics(ICrySizer *s)
+{
+	s->AddContainer(m_frameCache);
+	s->AddContainer(m_queue);
+}
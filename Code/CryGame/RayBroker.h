@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "CryCommon/CryEntitySystem/IEntity.h"
+#include "CryCommon/CryPhysics/IPhysics.h"
+#include "CryCommon/CrySystem/TimeValue.h"
+
+struct SRayRequest
+{
+	static constexpr int MAX_SKIP = 10;
+
+	Vec3 origin = Vec3(ZERO);
+	Vec3 dir = Vec3(ZERO);
+	int objTypes = ent_all;
+	unsigned int flags = 0;
+	IPhysicalEntity *pSkipEnts[MAX_SKIP] = {};
+	int skipCount = 0;
+
+	void SetSkipEntities(IPhysicalEntity **pEnts, int count);
+
+	bool operator==(const SRayRequest & other) const;
+};
+
+// Single place for the ray casts of weapons.
+// Identical rays cast in the same frame hit the physics only once.
+// Rays needed every frame can be queued and are cast together once the entities are updated.
+class CRayBroker
+{
+	struct SRayResult
+	{
+		SRayRequest request;
+		ray_hit hit;
+		int hits = 0;
+	};
+
+	struct SQueuedRay
+	{
+		EntityId ownerId = 0;
+		SRayResult result;
+		bool isQueued = false;  // requested again since the last flush
+		bool isReady = false;   // result is valid
+	};
+
+	std::vector<SRayResult> m_frameCache;
+	std::vector<SQueuedRay> m_queue;
+	CTimeValue m_cacheFrameTime;
+
+	// statistics since the last reset
+	unsigned int m_requestCount = 0;
+	unsigned int m_castCount = 0;
+	float m_castTimeMs = 0;
+
+	int Cast(const SRayRequest & request, ray_hit & hit);
+	const SRayResult *FindCached(const SRayRequest & request);
+
+public:
+	// casts the ray now unless an identical ray was already cast in this frame
+	int CastRay(const SRayRequest & request, ray_hit & hit);
+
+	// one queued ray per owner, the latest request replaces the previous one
+	void QueueRay(EntityId ownerId, const SRayRequest & request);
+	// result of the ray queued by the owner before the last flush
+	bool GetQueuedResult(EntityId ownerId, SRayRequest & request, ray_hit & hit, int & hits) const;
+
+	// casts all queued rays, called once per frame after the entities are updated
+	void Flush();
+	void Reset();
+
+	void LogStatistics();
+	void GetMemoryStatistics(ICrySizer *s);
+};
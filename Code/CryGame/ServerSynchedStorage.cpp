@@ -1,5 +1,52 @@
+#include <algorithm>
+
 #include "ServerSynchedStorage.h"
 
+namespace
+{
+	bool IsSameValue(const TSynchedValue & a, const TSynchedValue & b)
+	{
+		if (a.GetType() != b.GetType())
+		{
+			return false;
+		}
+
+		switch (a.GetType())
+		{
+			case eSVT_Bool:     return *a.GetPtr<bool>() == *b.GetPtr<bool>();
+			case eSVT_Float:    return *a.GetPtr<float>() == *b.GetPtr<float>();
+			case eSVT_Int:      return *a.GetPtr<int>() == *b.GetPtr<int>();
+			case eSVT_EntityId: return *a.GetPtr<EntityId>() == *b.GetPtr<EntityId>();
+			case eSVT_String:   return *a.GetPtr<string>() == *b.GetPtr<string>();
+		}
+
+		return false;
+	}
+
+	template<class T>
+	void SortUnique(std::vector<T> & values)
+	{
+		std::sort(values.begin(), values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+	}
+}
+
+CServerSynchedStorage::CServerSynchedStorage(IGameFramework *pGameFramework)
+{
+	m_pGameFramework = pGameFramework;
+
+	// sent values of removed entities are forgotten
+	gEnv->pEntitySystem->AddSink(this);
+}
+
+CServerSynchedStorage::~CServerSynchedStorage()
+{
+	if (gEnv->pEntitySystem)
+	{
+		gEnv->pEntitySystem->RemoveSink(this);
+	}
+}
+
 CServerSynchedStorage::SChannel *CServerSynchedStorage::GetChannel(int channelId)
 {
 	auto it = m_channels.find(channelId);
@@ -37,12 +84,150 @@ int CServerSynchedStorage::GetChannelId(INetChannel *pNetChannel) const
 	return 0;
 }
 
+bool CServerSynchedStorage::IsSendNeeded(const SSentValue & sent, const TSynchedValue & value)
+{
+	// the client already has this value and nothing else is on the way
+	return !sent.acked || sent.pending > 0 || !IsSameValue(sent.value, value);
+}
+
+void CServerSynchedStorage::OnSent(SSentValue & sent, const TSynchedValue & value)
+{
+	if (sent.pending > 0)
+	{
+		// delivery order of reliable unordered messages is unknown
+		sent.unsure = true;
+	}
+
+	sent.value = value;
+	sent.pending++;
+	sent.acked = false;
+}
+
+void CServerSynchedStorage::OnSendComplete(SSentValue & sent, bool ack)
+{
+	if (!ack)
+	{
+		sent.unsure = true;
+	}
+
+	if (sent.pending > 0)
+	{
+		sent.pending--;
+	}
+
+	if (sent.pending == 0)
+	{
+		sent.acked = !sent.unsure;
+		sent.unsure = false;
+	}
+}
+
+void CServerSynchedStorage::QueueCompletion(const SCompletion & completion)
+{
+	CCryMutex::CLock lock(m_completionMutex);
+
+	m_completions.push_back(completion);
+}
+
+void CServerSynchedStorage::ApplyCompletions()
+{
+	{
+		CCryMutex::CLock lock(m_completionMutex);
+
+		m_completionsToApply.swap(m_completions);
+	}
+
+	for (const SCompletion & completion : m_completionsToApply)
+	{
+		SChannel *pChannel = GetChannel(completion.channelId);
+		if (!pChannel)
+		{
+			continue;
+		}
+
+		switch (completion.type)
+		{
+			case SCompletion::eCT_Global:
+			{
+				auto it = pChannel->sentGlobal.find(completion.key);
+				if (it != pChannel->sentGlobal.end())
+					OnSendComplete(it->second, completion.ack);
+				break;
+			}
+			case SCompletion::eCT_Channel:
+			{
+				auto it = pChannel->sentChannel.find(completion.key);
+				if (it != pChannel->sentChannel.end())
+					OnSendComplete(it->second, completion.ack);
+				break;
+			}
+			case SCompletion::eCT_Entity:
+			{
+				auto it = pChannel->sentEntity.find(std::make_pair(completion.entityId, completion.key));
+				if (it != pChannel->sentEntity.end())
+					OnSendComplete(it->second, completion.ack);
+				break;
+			}
+		}
+	}
+
+	m_completionsToApply.clear();
+}
+
+void CServerSynchedStorage::Update()
+{
+	CCryMutex::CLock lock(m_mutex);
+
+	// before anything is sent, so acknowledged values are not sent again
+	ApplyCompletions();
+
+	if (!m_dirtyChannel.empty())
+	{
+		SortUnique(m_dirtyChannel);
+
+		for (const auto & item : m_dirtyChannel)
+		{
+			AddToChannelQueue(item.first, item.second);
+		}
+
+		m_dirtyChannel.clear();
+	}
+
+	if (!m_dirtyGlobal.empty())
+	{
+		SortUnique(m_dirtyGlobal);
+
+		for (TSynchedKey key : m_dirtyGlobal)
+		{
+			AddToGlobalQueue(key);
+		}
+
+		m_dirtyGlobal.clear();
+	}
+
+	if (!m_dirtyEntity.empty())
+	{
+		SortUnique(m_dirtyEntity);
+
+		for (const auto & item : m_dirtyEntity)
+		{
+			AddToEntityQueue(item.first, item.second);
+		}
+
+		m_dirtyEntity.clear();
+	}
+}
+
 void CServerSynchedStorage::Reset()
 {
 	CCryMutex::CLock lock(m_mutex);
 
 	CSynchedStorage::Reset();
 
+	m_dirtyGlobal.clear();
+	m_dirtyChannel.clear();
+	m_dirtyEntity.clear();
+
 	for (const auto & item : m_channels)
 	{
 		ResetChannel(item.first);
@@ -72,6 +257,34 @@ void CServerSynchedStorage::ResetChannel(int channelId)
 	}
 
 	SChannel *pChannel = GetChannel(channelId);
+
+	if (pChannel)
+	{
+		// the client clears its storage, only messages still on the way keep being counted
+		const auto forget = [](auto & sentMap)
+		{
+			for (auto it = sentMap.begin(); it != sentMap.end();)
+			{
+				SSentValue & sent = it->second;
+
+				if (sent.pending > 0)
+				{
+					sent.acked = false;
+					sent.unsure = true;
+					++it;
+				}
+				else
+				{
+					it = sentMap.erase(it);
+				}
+			}
+		};
+
+		forget(pChannel->sentGlobal);
+		forget(pChannel->sentChannel);
+		forget(pChannel->sentEntity);
+	}
+
 	if (pChannel && pChannel->pNetChannel)
 	{
 		auto *pMsg = new CClientSynchedStorage::CResetMsg(channelId, this);
@@ -123,6 +336,12 @@ void CServerSynchedStorage::AddToChannelQueue(int channelId, TSynchedKey key)
 		return;
 	}
 
+	SSentValue & sent = pChannel->sentChannel[key];
+	if (!IsSendNeeded(sent, value))
+	{
+		return;
+	}
+
 	CClientSynchedStorage::CSetChannelMsg *pMsg = nullptr;
 
 	switch (value.GetType())
@@ -146,6 +365,8 @@ void CServerSynchedStorage::AddToChannelQueue(int channelId, TSynchedKey key)
 
 	if (pMsg)
 	{
+		OnSent(sent, value);
+
 		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHandle);
 	}
 }
@@ -166,6 +387,12 @@ void CServerSynchedStorage::AddToGlobalQueueFor(int channelId, TSynchedKey key)
 		return;
 	}
 
+	SSentValue & sent = pChannel->sentGlobal[key];
+	if (!IsSendNeeded(sent, value))
+	{
+		return;
+	}
+
 	CClientSynchedStorage::CSetGlobalMsg *pMsg = nullptr;
 
 	switch (value.GetType())
@@ -189,6 +416,8 @@ void CServerSynchedStorage::AddToGlobalQueueFor(int channelId, TSynchedKey key)
 
 	if (pMsg)
 	{
+		OnSent(sent, value);
+
 		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHandle);
 	}
 }
@@ -209,6 +438,12 @@ void CServerSynchedStorage::AddToEntityQueueFor(int channelId, EntityId entityId
 		return;
 	}
 
+	SSentValue & sent = pChannel->sentEntity[std::make_pair(entityId, key)];
+	if (!IsSendNeeded(sent, value))
+	{
+		return;
+	}
+
 	CClientSynchedStorage::CSetEntityMsg *pMsg = nullptr;
 
 	switch (value.GetType())
@@ -232,6 +467,8 @@ void CServerSynchedStorage::AddToEntityQueueFor(int channelId, EntityId entityId
 
 	if (pMsg)
 	{
+		OnSent(sent, value);
+
 		pChannel->pNetChannel->SubstituteSendable(pMsg, 1, &pChannel->lastOrderedMessage, &msgHandle);
 	}
 }
@@ -239,6 +476,8 @@ void CServerSynchedStorage::AddToEntityQueueFor(int channelId, EntityId entityId
 //------------------------------------------------------------------------
 void CServerSynchedStorage::FullSynch(int channelId, bool reset)
 {
+	CCryMutex::CLock lock(m_mutex);
+
 	if (reset)
 	{
 		ResetChannel(channelId);
@@ -254,32 +493,37 @@ void CServerSynchedStorage::FullSynch(int channelId, bool reset)
 		AddToGlobalQueueFor(channelId, item.first);
 	}
 
-	for (const auto & entityItem : m_entityStorage)
+	for (const auto & entry : m_entityStorage)
 	{
-		for (const auto & item : entityItem.second)
-		{
-			AddToEntityQueueFor(channelId, entityItem.first, item.first);
-		}
+		AddToEntityQueueFor(channelId, entry.entityId, entry.key);
 	}
 }
 
 void CServerSynchedStorage::OnGlobalChanged(TSynchedKey key, const TSynchedValue & value)
 {
-	AddToGlobalQueue(key);
+	CCryMutex::CLock lock(m_mutex);
+
+	m_dirtyGlobal.push_back(key);
 }
 
 void CServerSynchedStorage::OnChannelChanged(int channelId, TSynchedKey key, const TSynchedValue & value)
 {
-	AddToChannelQueue(channelId, key);
+	CCryMutex::CLock lock(m_mutex);
+
+	m_dirtyChannel.emplace_back(channelId, key);
 }
 
 void CServerSynchedStorage::OnEntityChanged(EntityId entityId, TSynchedKey key, const TSynchedValue & value)
 {
-	AddToEntityQueue(entityId, key);
+	CCryMutex::CLock lock(m_mutex);
+
+	m_dirtyEntity.emplace_back(entityId, key);
 }
 
 void CServerSynchedStorage::OnClientConnect(int channelId)
 {
+	CCryMutex::CLock lock(m_mutex);
+
 	INetChannel *pNetChannel = m_pGameFramework->GetNetChannel(channelId);
 
 	SChannel *pChannel = GetChannel(channelId);
@@ -303,6 +547,8 @@ void CServerSynchedStorage::OnClientConnect(int channelId)
 
 void CServerSynchedStorage::OnClientDisconnect(int channelId, bool onhold)
 {
+	CCryMutex::CLock lock(m_mutex);
+
 	SChannel *pChannel = GetChannel(channelId);
 	if (pChannel)
 	{
@@ -335,38 +581,63 @@ void CServerSynchedStorage::OnClientEnteredGame(int channelId)
 
 bool CServerSynchedStorage::OnSetGlobalMsgComplete(CClientSynchedStorage::CSetGlobalMsg *pMsg, int channelId, uint32 fromSeq, bool ack)
 {
-	CCryMutex::CLock lock(m_mutex);
+	// the messages are reliable, so a nack is not requeued here, it only makes the sent state unknown
+	SCompletion completion;
+	completion.type = SCompletion::eCT_Global;
+	completion.channelId = channelId;
+	completion.key = pMsg->key;
+	completion.ack = ack;
 
-	if (!ack)
-	{
-		// got a nack, so reque
-		AddToGlobalQueueFor(channelId, pMsg->key);
-	}
+	QueueCompletion(completion);
 
 	return true;
 }
 
 bool CServerSynchedStorage::OnSetChannelMsgComplete(CClientSynchedStorage::CSetChannelMsg *pMsg, int channelId, uint32 fromSeq, bool ack)
 {
-	CCryMutex::CLock lock(m_mutex);
+	// the messages are reliable, so a nack is not requeued here, it only makes the sent state unknown
+	SCompletion completion;
+	completion.type = SCompletion::eCT_Channel;
+	completion.channelId = channelId;
+	completion.key = pMsg->key;
+	completion.ack = ack;
 
-	if (!ack)
-	{
-		// got a nack, so reque
-		AddToChannelQueue(channelId, pMsg->key);
-	}
+	QueueCompletion(completion);
 
 	return true;
 }
 
 bool CServerSynchedStorage::OnSetEntityMsgComplete(CClientSynchedStorage::CSetEntityMsg *pMsg, int channelId, uint32 fromSeq, bool ack)
+{
+	// the messages are reliable, so a nack is not requeued here, it only makes the sent state unknown
+	SCompletion completion;
+	completion.type = SCompletion::eCT_Entity;
+	completion.channelId = channelId;
+	completion.entityId = pMsg->entityId;
+	completion.key = pMsg->key;
+	completion.ack = ack;
+
+	QueueCompletion(completion);
+
+	return true;
+}
+
+bool CServerSynchedStorage::OnRemove(IEntity *pEntity)
 {
 	CCryMutex::CLock lock(m_mutex);
 
-	if (!ack)
+	const EntityId entityId = pEntity->GetId();
+
+	for (auto & item : m_channels)
 	{
-		// got a nack, so reque
-		AddToEntityQueueFor(channelId, pMsg->entityId, pMsg->key);
+		TEntitySentMap & sentEntity = item.second.sentEntity;
+
+		// completions of messages still on the way find nothing and are ignored
+		auto it = sentEntity.lower_bound(std::make_pair(entityId, TSynchedKey(0)));
+		while (it != sentEntity.end() && it->first.first == entityId)
+		{
+			it = sentEntity.erase(it);
+		}
 	}
 
 	return true;
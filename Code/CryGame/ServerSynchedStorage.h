@@ -1,9 +1,26 @@
 #pragma once
 
+#include <utility>
+#include <vector>
+
+#include "CryCommon/CryEntitySystem/IEntitySystem.h"
+
 #include "ClientSynchedStorage.h"
 
-class CServerSynchedStorage : public CNetMessageSinkHelper<CServerSynchedStorage, CSynchedStorage>
+class CServerSynchedStorage : public CNetMessageSinkHelper<CServerSynchedStorage, CSynchedStorage>, public IEntitySystemSink
 {
+	// what the client of a channel is known to have
+	struct SSentValue
+	{
+		TSynchedValue value;  // last value given to the network
+		int pending = 0;      // messages not acknowledged yet
+		bool acked = false;   // value is on the client
+		bool unsure = false;  // messages overlapped or were lost since the last acknowledged state
+	};
+
+	using TSentMap = std::map<TSynchedKey, SSentValue>;
+	using TEntitySentMap = std::map<std::pair<EntityId, TSynchedKey>, SSentValue>;
+
 	struct SChannel
 	{
 		INetChannel *pNetChannel = nullptr;
@@ -11,6 +28,10 @@ class CServerSynchedStorage : public CNetMessageSinkHelper<CServerSynchedStorage
 		bool local = false;
 		bool onhold = false;
 
+		TSentMap sentGlobal;
+		TSentMap sentChannel;
+		TEntitySentMap sentEntity;
+
 		SChannel() = default;
 
 		SChannel(INetChannel *pNetChannel, bool isLocal)
@@ -78,24 +99,61 @@ class CServerSynchedStorage : public CNetMessageSinkHelper<CServerSynchedStorage
 	using TChannelEntityQueueMap = std::map<SChannelEntityQueueEnt, SSendableHandle>;
 	using TChannelMap = std::map<int, SChannel>;
 
+	// set message completion reported by the network thread
+	struct SCompletion
+	{
+		enum EType
+		{
+			eCT_Global,
+			eCT_Channel,
+			eCT_Entity,
+		};
+
+		EType type = eCT_Global;
+		int channelId = 0;
+		EntityId entityId = 0;
+		TSynchedKey key = 0;
+		bool ack = false;
+	};
+
 	TChannelQueueMap m_globalQueue;
 	TChannelQueueMap m_channelQueue;
 	TChannelEntityQueueMap m_entityQueue;
 	TChannelMap m_channels;
 	CCryMutex m_mutex;
 
+	// changes made during the current frame, sent by Update
+	std::vector<TSynchedKey> m_dirtyGlobal;
+	std::vector<std::pair<int, TSynchedKey>> m_dirtyChannel;
+	std::vector<std::pair<EntityId, TSynchedKey>> m_dirtyEntity;
+
+	// The network thread holds the network lock when it reports completions, and m_mutex is held while
+	// messages are added to the channels, which takes the network lock. Completions are therefore only
+	// queued under their own mutex and applied by Update on the main thread.
+	std::vector<SCompletion> m_completions;
+	std::vector<SCompletion> m_completionsToApply;
+	CCryMutex m_completionMutex;
+
 	SChannel *GetChannel(int channelId);
 	SChannel *GetChannel(INetChannel *pNetChannel);
 	int GetChannelId(INetChannel *pNetChannel) const;
 
+	void QueueCompletion(const SCompletion & completion);
+	void ApplyCompletions();
+
+	static bool IsSendNeeded(const SSentValue & sent, const TSynchedValue & value);
+	static void OnSent(SSentValue & sent, const TSynchedValue & value);
+	static void OnSendComplete(SSentValue & sent, bool ack);
+
 public:
-	CServerSynchedStorage(IGameFramework *pGameFramework)
-	{
-		m_pGameFramework = pGameFramework;
-	}
+	CServerSynchedStorage(IGameFramework *pGameFramework);
+	~CServerSynchedStorage();
 
 	virtual void DefineProtocol(IProtocolBuilder *pBuilder);
 
+	// sends all changes made since the last call, once per frame
+	virtual void Update();
+
 	virtual void Reset();
 	virtual void ResetChannel(int channelId);
 
@@ -120,4 +178,11 @@ public:
 	virtual void OnGlobalChanged(TSynchedKey key, const TSynchedValue & value);
 	virtual void OnChannelChanged(int channelId, TSynchedKey key, const TSynchedValue & value);
 	virtual void OnEntityChanged(EntityId entityId, TSynchedKey key, const TSynchedValue & value);
+
+	// IEntitySystemSink
+	virtual bool OnBeforeSpawn(SEntitySpawnParams & params) { return true; }
+	virtual void OnSpawn(IEntity *pEntity, SEntitySpawnParams & params) {}
+	virtual bool OnRemove(IEntity *pEntity);
+	virtual void OnEvent(IEntity *pEntity, SEntityEvent & event) {}
+	// ~IEntitySystemSink
 };
@@ -11,10 +11,49 @@ History:
 
 *************************************************************************/
 #include "StdAfx.h"
+#ifdef _DEBUG
+#include <chrono>
+#endif
 #include "ShotValidator.h"
 #include "GameRules.h"
 
 
+//------------------------------------------------------------------------
+void CShotValidator::TWeaponWindow::Init(EntityId id)
+{
+	weaponId=id;
+	orderHead=0;
+	orderCount=0;
+	pendingHitCount=0;
+
+	for (int i=0;i<SHOT_WINDOW_SIZE;i++)
+	{
+		shots[i].life=0;
+		hitHeads[i]=-1;
+	}
+}
+
+//------------------------------------------------------------------------
+void CShotValidator::TWeaponWindow::PopShot()
+{
+	const TShotRef &ref=order[orderHead];
+
+	if (IsOwner(ref))
+		shots[ref.seq&SHOT_WINDOW_MASK].life=0;
+
+	orderHead=(orderHead+1)&SHOT_WINDOW_MASK;
+	--orderCount;
+}
+
+//------------------------------------------------------------------------
+bool CShotValidator::TWeaponWindow::IsOwner(const TShotRef &ref) const
+{
+	// the slot may have been consumed or reused by a newer sequence number since
+	const TShot &shot=shots[ref.seq&SHOT_WINDOW_MASK];
+
+	return shot.life>0 && shot.seq==ref.seq && shot.time==ref.time;
+}
+
 //------------------------------------------------------------------------
 CShotValidator::CShotValidator(CGameRules *pGameRules, IItemSystem *pItemSystem, IGameFramework *pGameFramework)
 : m_pGameRules(pGameRules)
@@ -39,51 +78,82 @@ void CShotValidator::AddShot(EntityId playerId, EntityId weaponId, uint16 seq, u
 
 	CTimeValue now=gEnv->pTimer->GetFrameStartTime();
 	int channelId=m_pGameRules->GetChannelId(playerId);
-	int shotLife=3;
 
-	TShot shot(seq, weaponId, now, shotLife);
+	uint16 nseq=seq;
+	for (int i=0;i<=seqr;i++)
+	{
+		if (i>0 && nseq==0)
+			nseq=1;
 
-	TChannelHits::iterator chit=m_pendinghits.find(channelId);
-	assert(chit!=m_pendinghits.end());
-	THits &hits=chit->second;
-	THits::iterator hit=hits.find(shot);
+		// looked up again every time, the hits below may change the channels
+		TChannels::iterator cit=m_channels.find(channelId);
+		assert(cit!=m_channels.end());
+		if (cit==m_channels.end())
+			return;
 
-	while (shot.life>0 && hit!=hits.end() && shot==hit->first)
-	{
-		//CryLogAlways("found a matching hit! seq: %d  id: %d  age: %.2f  size: %d", shot.seq, shot.weaponId, (now-hit->second.time).GetMilliSeconds(), hits.size());
+		HitInfo matched[SHOT_LIFE];
+		int count=AddChannelShot(cit->second, weaponId, nseq++, now, matched);
 
-		HitInfo info=hit->second.info;
-		hits.erase(hit);
+		for (int h=0;h<count;h++)
+		{
+			//CryLogAlways("found a matching hit! seq: %d  id: %d", matched[h].seq, matched[h].weaponId);
 
-		m_doingHit=true;
-		m_pGameRules->ServerHit(info);
-		m_doingHit=false;
-		
-		--shot.life;
-		hit=hits.find(shot);
+			m_doingHit=true;
+			m_pGameRules->ServerHit(matched[h]);
+			m_doingHit=false;
+		}
 	}
+}
 
-	if (shot.life>0)
+//------------------------------------------------------------------------
+int CShotValidator::AddChannelShot(TChannel &channel, EntityId weaponId, uint16 seq, const CTimeValue &now, HitInfo *pMatched)
+{
+	TWeaponWindow *pWindow=GetWindow(channel, weaponId, true);
+	int slot=seq&SHOT_WINDOW_MASK;
+	int life=SHOT_LIFE;
+	int matched=0;
+
+	// consume the hits that arrived before this shot, in arrival order
+	int16 *pLink=&pWindow->hitHeads[slot];
+	while (life>0 && *pLink>=0)
 	{
-		TChannelShots::iterator csit=m_shots.find(channelId);
-		assert(csit!=m_shots.end());
-		TShots &shots=csit->second;
-		shots.insert(shot);
+		THit &hit=channel.hits[*pLink];
+
+		if (hit.info.seq!=seq)
+		{
+			pLink=&hit.next;
+			continue;
+		}
+
+		pMatched[matched++]=hit.info;
 
-		//CryLogAlways("added shot! seq: %d  id: %d", shot.seq, shot.weaponId);
+		*pLink=hit.next;
+		hit.next=-1;
+		hit.pending=false;
+		--pWindow->pendingHitCount;
+
+		--life;
 	}
 
-	if (seqr>0)
+	if (life>0)
 	{
-		uint16 nseq=seq+1;
-		for (uint8 i=0;i<seqr;i++)
-		{
-			if (nseq==0)
-				nseq=1;
+		if (pWindow->orderCount==SHOT_WINDOW_SIZE)
+			pWindow->PopShot();
 
-			AddShot(playerId, weaponId, nseq++, 0);
-		}
+		TShot &shot=pWindow->shots[slot];
+		shot.seq=seq;
+		shot.life=life;
+		shot.time=now;
+
+		TShotRef &ref=pWindow->order[(pWindow->orderHead+pWindow->orderCount)&SHOT_WINDOW_MASK];
+		ref.seq=seq;
+		ref.time=now;
+		++pWindow->orderCount;
+
+		//CryLogAlways("added shot! seq: %d  id: %d", seq, weaponId);
 	}
+
+	return matched;
 }
 
 //------------------------------------------------------------------------
@@ -97,42 +167,55 @@ bool CShotValidator::ProcessHit(const HitInfo &hitInfo)
 	CTimeValue now=gEnv->pTimer->GetFrameStartTime();
 	int channelId=m_pGameRules->GetChannelId(hitInfo.shooterId);
 
-	TShot shot(hitInfo.seq, hitInfo.weaponId, now, 0);
-	
-	TChannelShots::iterator csit=m_shots.find(channelId);
-	if (csit!=m_shots.end())
-	{
-		TShots &shots=csit->second;
-		TShots::iterator found=shots.find(shot);
+	TChannels::iterator cit=m_channels.find(channelId);
+	assert(cit!=m_channels.end());
+	if (cit==m_channels.end())
+		return false;
 
-		if (found!=shots.end())
-		{
-			//CryLogAlways("found a matching shot! seq: %d  id: %d  age: %.2f  size: %d", shot.seq, shot.weaponId, (now-found->time).GetMilliSeconds(), shots.size());
+	return ProcessChannelHit(channelId, cit->second, hitInfo, now);
+}
 
-			TShot &fshot=const_cast<TShot&>(*found);
+//------------------------------------------------------------------------
+bool CShotValidator::ProcessChannelHit(int channelId, TChannel &channel, const HitInfo &hitInfo, const CTimeValue &now)
+{
+	TWeaponWindow *pWindow=GetWindow(channel, hitInfo.weaponId, true);
+	int slot=hitInfo.seq&SHOT_WINDOW_MASK;
 
-			if (fshot.life>0)
-				--fshot.life;
-		//	else
-		//		CryLogAlways("invalid shot consumption! seq: %d  id: %d", fshot.seq, fshot.weaponId);
+	TShot &shot=pWindow->shots[slot];
+	if (shot.life>0 && shot.seq==hitInfo.seq)
+	{
+		//CryLogAlways("found a matching shot! seq: %d  id: %d  age: %.2f", shot.seq, hitInfo.weaponId, (now-shot.time).GetMilliSeconds());
 
-			if (Expired(now, fshot))
-			{
-				//CryLogAlways("expired shot found! seq: %d  id: %d  age: %.2f", fshot.seq, fshot.weaponId, (now-fshot.time).GetMilliSeconds());
+		--shot.life;
 
-				shots.erase(found);
-			}
+		// the stale entry in the order ring is skipped once the cursor reaches it
+		if (Expired(now, shot))
+			shot.life=0;
 
-			return true;
-		}
+		return true;
 	}
 
-	TChannelHits::iterator chit=m_pendinghits.find(channelId);
-	assert(chit!=m_pendinghits.end());
-	THits &hits=chit->second;
-	hits.insert(THits::value_type(shot, THit(hitInfo, now)));
+	// the ring is full, so the oldest hit is declared expired before its 500ms are up
+	if (channel.hitCount==MAX_PENDING_HITS)
+		PopHit(channelId, channel);
+
+	int index=(channel.hitHead+channel.hitCount)%MAX_PENDING_HITS;
+	++channel.hitCount;
+
+	THit &hit=channel.hits[index];
+	hit.info=hitInfo;
+	hit.time=now;
+	hit.next=-1;
+	hit.pending=true;
+
+	int16 *pLink=&pWindow->hitHeads[slot];
+	while (*pLink>=0)
+		pLink=&channel.hits[*pLink].next;
+	*pLink=index;
 
-	//CryLogAlways("hit pending! seq: %d  id: %d  age: %.2f  size: %d", shot.seq, shot.weaponId, 0.0f, hits.size());
+	++pWindow->pendingHitCount;
+
+	//CryLogAlways("hit pending! seq: %d  id: %d  size: %d", hitInfo.seq, hitInfo.weaponId, channel.hitCount);
 
 	return false;
 }
@@ -142,32 +225,29 @@ void CShotValidator::Connected(int channelId)
 {
 	Disconnected(channelId); // make sure it's cleaned up
 
-	m_shots.insert(TChannelShots::value_type(channelId, TShots()));
-	m_pendinghits.insert(TChannelHits::value_type(channelId, THits()));
+	TChannel &channel=m_channels[channelId];
+	channel.windows.reserve(4);
+	channel.windowIndex.reserve(4);
 }
 
 //------------------------------------------------------------------------
 void CShotValidator::Disconnected(int channelId)
 {
-	m_shots.erase(channelId);
-	m_pendinghits.erase(channelId);
+	m_channels.erase(channelId);
 }
 
 //------------------------------------------------------------------------
 void CShotValidator::Reset()
 {
-	TChannelShots::iterator csend=m_shots.end();
-	for (TChannelShots::iterator csit=m_shots.begin(); csit!=csend; ++csit)
-	{
-		TShots &shots=csit->second;
-		shots.clear();
-	}
-
-	TChannelHits::iterator chend=m_pendinghits.end();
-	for (TChannelHits::iterator chit=m_pendinghits.begin(); chit!=chend; ++chit)
+	TChannels::iterator cend=m_channels.end();
+	for (TChannels::iterator cit=m_channels.begin(); cit!=cend; ++cit)
 	{
-		THits &hits=chit->second;
-		hits.clear();
+		TChannel &channel=cit->second;
+		channel.windows.clear();
+		channel.windowIndex.clear();
+		channel.idleWindows.clear();
+		channel.hitHead=0;
+		channel.hitCount=0;
 	}
 }
 
@@ -178,48 +258,123 @@ void CShotValidator::Update()
 
 	CTimeValue now=gEnv->pTimer->GetFrameStartTime();
 
-	TChannelShots::iterator csend=m_shots.end();
-	for (TChannelShots::iterator csit=m_shots.begin(); csit!=csend; ++csit)
+	TChannels::iterator cend=m_channels.end();
+	for (TChannels::iterator cit=m_channels.begin(); cit!=cend; ++cit)
+		UpdateChannel(cit->first, cit->second, now);
+}
+
+//------------------------------------------------------------------------
+void CShotValidator::UpdateChannel(int channelId, TChannel &channel, const CTimeValue &now)
+{
+	// both rings are in time order, so expiry stops at the first live entry
+	for (uint16 i=0;i<channel.windows.size();i++)
 	{
-		TShots &shots=csit->second;
+		TWeaponWindow &window=channel.windows[i];
+		if (!window.weaponId)
+			continue;
 
-		for (TShots::iterator shot=shots.begin(); shot!=shots.end();)
+		while (window.orderCount>0)
 		{
-			if (!Expired(now, *shot))
-			{
-				++shot;
-				continue;
-			}
+			const TShotRef &ref=window.order[window.orderHead];
 
-			//CryLogAlways("expired shot found! seq: %d  id: %d  age: %.2f", shot->seq, shot->weaponId, (now-shot->time).GetMilliSeconds());
+			if (window.IsOwner(ref) && !Expired(now, window.shots[ref.seq&SHOT_WINDOW_MASK]))
+				break;
 
-			TShots::iterator erasing=shot++;
-			shots.erase(erasing);
+			window.PopShot();
+		}
+
+		// release the window of a weapon that has nothing in flight
+		if (window.IsIdle())
+		{
+			channel.windowIndex.erase(window.weaponId);
+			channel.idleWindows.push_back(i);
+			window.weaponId=0;
 		}
 	}
 
-	TChannelHits::iterator chend=m_pendinghits.end();
-	for (TChannelHits::iterator chit=m_pendinghits.begin(); chit!=chend; ++chit)
+	while (channel.hitCount>0)
 	{
-		THits &hits=chit->second;
-		for (THits::iterator hit=hits.begin(); hit!=hits.end();)
-		{
-			if (!Expired(now, hit->second))
-			{
-				++hit;
-				continue;
-			}
+		const THit &hit=channel.hits[channel.hitHead];
+
+		if (hit.pending && !Expired(now, hit))
+			break;
 
-			DeclareExpired(chit->first, hit->second.info);
+		// CryLogAlways("aged hit found! seq: %d  id: %d  age: %.2f", hit.info.seq, hit.info.weaponId, (now-hit.time).GetMilliSeconds());
 
-			// CryLogAlways("aged hit found! seq: %d  id: %d  age: %.2f", hit->second.info.seq, hit->second.info.weaponId, (now-hit->second.time).GetMilliSeconds());
+		PopHit(channelId, channel);
+	}
+}
 
-			THits::iterator erasing=hit++;
-			hits.erase(erasing);
+//------------------------------------------------------------------------
+CShotValidator::TWeaponWindow *CShotValidator::GetWindow(TChannel &channel, EntityId weaponId, bool create)
+{
+	TWeaponWindowIndex::const_iterator it=channel.windowIndex.find(weaponId);
+	if (it!=channel.windowIndex.end())
+		return &channel.windows[it->second];
+
+	if (!create)
+		return 0;
+
+	uint16 index;
+	if (!channel.idleWindows.empty())
+	{
+		index=channel.idleWindows.back();
+		channel.idleWindows.pop_back();
+	}
+	else
+	{
+		index=(uint16)channel.windows.size();
+		channel.windows.resize(index+1);
+	}
+
+	TWeaponWindow &window=channel.windows[index];
+	window.Init(weaponId);
+
+	channel.windowIndex.insert(TWeaponWindowIndex::value_type(weaponId, index));
+
+	return &window;
+}
+
+//------------------------------------------------------------------------
+void CShotValidator::UnlinkHit(TChannel &channel, int index)
+{
+	THit &hit=channel.hits[index];
+	hit.pending=false;
+
+	TWeaponWindow *pWindow=GetWindow(channel, hit.info.weaponId, false);
+	if (!pWindow)
+		return;
+
+	int16 *pLink=&pWindow->hitHeads[hit.info.seq&SHOT_WINDOW_MASK];
+	while (*pLink>=0)
+	{
+		if (*pLink==index)
+		{
+			*pLink=hit.next;
+			hit.next=-1;
+			--pWindow->pendingHitCount;
+			break;
 		}
+
+		pLink=&channel.hits[*pLink].next;
 	}
 }
 
+//------------------------------------------------------------------------
+void CShotValidator::PopHit(int channelId, TChannel &channel)
+{
+	THit &hit=channel.hits[channel.hitHead];
+
+	if (hit.pending)
+	{
+		DeclareExpired(channelId, hit.info);
+		UnlinkHit(channel, channel.hitHead);
+	}
+
+	channel.hitHead=(channel.hitHead+1)%MAX_PENDING_HITS;
+	--channel.hitCount;
+}
+
 //------------------------------------------------------------------------
 bool CShotValidator::CanHit(const HitInfo &hit) const
 {
@@ -262,4 +417,131 @@ void CShotValidator::DeclareExpired(int channelId, const HitInfo &hit)
 	}
 
 	++it->second;
-}
\ No newline at end of file
+}
+
+#ifdef _DEBUG
+//------------------------------------------------------------------------
+void CShotValidator::Benchmark()
+{
+	typedef std::chrono::steady_clock TClock;
+
+	// 32 players firing automatic weapons for a minute, every 4th player uses a shotgun with 8 pellets
+	// and everyone switches between two weapons every 10 seconds
+	const int players=32;
+	const int frames=30*60;
+	const float frameTime=1.0f/30.0f;
+
+	struct TEvent
+	{
+		int				channelId;
+		EntityId	weaponId;
+		uint16		seq;
+		uint8			seqr;
+		bool			hit;
+	};
+
+	// the trace is generated up front, so only the validator is measured
+	std::vector<std::vector<TEvent> > trace(frames);
+	std::vector<uint16> nextSeq(players, 1);
+	uint32 random=12345;
+	int shots=0;
+	int hits=0;
+
+	for (int frame=0;frame<frames;frame++)
+	{
+		for (int player=0;player<players;player++)
+		{
+			bool shotgun=(player%4)==0;
+
+			// automatic weapons fire every 3rd frame, shotguns every 20th
+			if (frame%(shotgun?20:3)!=player%3)
+				continue;
+
+			TEvent shot;
+			shot.channelId=player+1;
+			shot.weaponId=1000+player*2+(frame/300)%2;
+			shot.seq=nextSeq[player];
+			shot.seqr=shotgun?7:0;
+			shot.hit=false;
+
+			nextSeq[player]+=shot.seqr+1;
+			if (nextSeq[player]==0)
+				nextSeq[player]=1;
+
+			for (int pellet=0;pellet<=shot.seqr;pellet++)
+			{
+				random=random*1103515245+12345;
+
+				// most shots miss, a quarter of the hits arrive a frame before their shot
+				if ((random>>16)%3!=0)
+					continue;
+
+				TEvent hit=shot;
+				hit.seq=shot.seq+pellet;
+				hit.seqr=0;
+				hit.hit=true;
+
+				int hitFrame=frame+((random>>8)%4==0?-1:(int)((random>>10)%3));
+				trace[CLAMP(hitFrame, 0, frames-1)].push_back(hit);
+				++hits;
+			}
+
+			trace[frame].push_back(shot);
+			++shots;
+		}
+	}
+
+	CShotValidator validator(0, 0, 0);
+	for (int player=0;player<players;player++)
+		validator.Connected(player+1);
+
+	int matched=0;
+	int pending=0;
+	HitInfo matchedHits[SHOT_LIFE];
+
+	TClock::time_point start=TClock::now();
+
+	for (int frame=0;frame<frames;frame++)
+	{
+		CTimeValue now(frame*frameTime);
+
+		const std::vector<TEvent> &events=trace[frame];
+		for (std::vector<TEvent>::const_iterator it=events.begin(); it!=events.end(); ++it)
+		{
+			TChannel &channel=validator.m_channels[it->channelId];
+
+			if (it->hit)
+			{
+				HitInfo info;
+				info.shooterId=it->weaponId;
+				info.weaponId=it->weaponId;
+				info.seq=it->seq;
+
+				if (validator.ProcessChannelHit(it->channelId, channel, info, now))
+					++matched;
+				else
+					++pending;
+			}
+			else
+			{
+				for (int i=0;i<=it->seqr;i++)
+					matched+=validator.AddChannelShot(channel, it->weaponId, it->seq+i, now, matchedHits);
+			}
+		}
+
+		TChannels::iterator cend=validator.m_channels.end();
+		for (TChannels::iterator cit=validator.m_channels.begin(); cit!=cend; ++cit)
+			validator.UpdateChannel(cit->first, cit->second, now);
+	}
+
+	float ms=std::chrono::duration<float, std::milli>(TClock::now()-start).count();
+
+	int expired=0;
+	for (TChannelExpiredHits::const_iterator it=validator.m_expired.begin(); it!=validator.m_expired.end(); ++it)
+		expired+=it->second;
+
+	CryLogAlways("Shot validator benchmark: %d frames, %d shots, %d hits", frames, shots, hits);
+	CryLogAlways("  %.3f ms total, %.3f us per frame", ms, ms*1000.0f/frames);
+	CryLogAlways("  %d matched, %d pending, %d expired", matched, pending, expired);
+}
+#endif
@@ -19,6 +19,8 @@ History:
 #endif
 
 
+#include <unordered_map>
+
 #include "CryCommon/CryAction/IGameRulesSystem.h"
 
 
@@ -26,41 +28,75 @@ class CGameRules;
 
 class CShotValidator
 {
-	struct TShot
+	enum
 	{
-		TShot(uint16 seqn, EntityId wpnId, CTimeValue t, uint8 lives): seq(seqn), weaponId(wpnId), time(t), life(lives) {};
-		bool ILINE operator==(const TShot &that) const {
-			return seq==that.seq && weaponId==that.weaponId;
-		};
-		bool ILINE operator!=(const TShot &that) const {
-			return !(*this == that);
-		};
-		bool ILINE operator<(const TShot &that) const {
-			return weaponId<that.weaponId || (weaponId==that.weaponId && seq<that.seq);
-		};
+		SHOT_WINDOW_SIZE=256,		// sequence numbers tracked per weapon, must be a power of two
+		SHOT_WINDOW_MASK=SHOT_WINDOW_SIZE-1,
+		// hits waiting for their shot per channel, the list used to be unbounded
+		// hits only wait while their shot is late, for 500ms at most, so a full ring means more than 512
+		// unmatched hits per second from one client; that is hits without shots, not a slow connection
+		MAX_PENDING_HITS=256,
+		SHOT_LIFE=3,
+	};
 
+	struct TShot
+	{
 		uint16			seq;
-		EntityId		weaponId;
-		
+		uint8				life;			// 0 means free slot
+
 		CTimeValue	time;
-		uint8				life;
+	};
 
+	// shots in the order they were added, so expiry only advances a cursor
+	struct TShotRef
+	{
+		uint16			seq;
+		CTimeValue	time;
 	};
 
 	struct THit
 	{
-		THit(const HitInfo &hit, CTimeValue t): info(hit), time(t) {};
-
-		CTimeValue	time;
 		HitInfo			info;
+		CTimeValue	time;
+		int16				next;			// next pending hit with the same window slot
+		bool				pending;
+	};
 
+	struct TWeaponWindow
+	{
+		EntityId		weaponId;
+
+		TShot				shots[SHOT_WINDOW_SIZE];				// indexed by seq
+		TShotRef		order[SHOT_WINDOW_SIZE];
+		uint16			orderHead;
+		uint16			orderCount;
+
+		int16				hitHeads[SHOT_WINDOW_SIZE];			// indexed by seq, -1 means no pending hit
+		int					pendingHitCount;
+
+		void Init(EntityId id);
+		void PopShot();
+		bool IsOwner(const TShotRef &ref) const;
+		bool IsIdle() const { return orderCount==0 && pendingHitCount==0; };
 	};
 
-	typedef std::set<TShot>																TShots;
-	typedef std::multimap<TShot, THit, std::less<TShot> >	THits;
+	typedef std::vector<TWeaponWindow>										TWeaponWindows;
+	typedef std::unordered_map<EntityId, uint16>					TWeaponWindowIndex;
+
+	struct TChannel
+	{
+		TChannel(): hitHead(0), hitCount(0) {};
+
+		TWeaponWindows				windows;
+		TWeaponWindowIndex		windowIndex;		// weapon id to its window
+		std::vector<uint16>		idleWindows;		// released windows, reused by the next weapon
+
+		THit				hits[MAX_PENDING_HITS];					// ring buffer in arrival order
+		uint16			hitHead;
+		uint16			hitCount;
+	};
 
-	typedef std::map<int, TShots>													TChannelShots;
-	typedef std::map<int, THits>													TChannelHits;
+	typedef std::map<int, TChannel>												TChannels;
 
 	typedef std::map<int, uint16>													TChannelExpiredHits;
 
@@ -77,7 +113,20 @@ public:
 	void Connected(int channelId);
 	void Disconnected(int channelId);
 
+#ifdef _DEBUG
+	// replays a generated shot and hit trace of a full server and logs the time taken
+	static void Benchmark();
+#endif
+
 private:
+	int AddChannelShot(TChannel &channel, EntityId weaponId, uint16 seq, const CTimeValue &now, HitInfo *pMatched);
+	bool ProcessChannelHit(int channelId, TChannel &channel, const HitInfo &hit, const CTimeValue &now);
+	void UpdateChannel(int channelId, TChannel &channel, const CTimeValue &now);
+
+	TWeaponWindow *GetWindow(TChannel &channel, EntityId weaponId, bool create);
+	void UnlinkHit(TChannel &channel, int index);
+	void PopHit(int channelId, TChannel &channel);
+
 	bool CanHit(const HitInfo &hit) const;
 	bool Expired(const CTimeValue &now, const TShot &shot) const;
 	bool Expired(const CTimeValue &now, const THit &hit) const;
@@ -88,8 +137,7 @@ private:
 	IItemSystem					*m_pItemSystem;
 	IGameFramework			*m_pGameFramework;
 
-	TChannelShots				m_shots;
-	TChannelHits				m_pendinghits;
+	TChannels						m_channels;
 	bool								m_doingHit;
 	TChannelExpiredHits	m_expired;
 };
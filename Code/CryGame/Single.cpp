@@ -567,16 +567,25 @@ void CSingle::UpdateAutoAim(float frameTime)
 
 	float maxDistance = m_fireparams.autoaim_distance;
 
-	ray_hit ray;
-
 	IPhysicalEntity* pSkipEnts[10];
 	int nSkipEnts = GetSkipEntities(m_pWeapon, pSkipEnts, 10);
 
-	const int objects = ent_all;
-	const int flags = (geom_colltype_ray << rwi_colltype_bit) | rwi_colltype_any | (8 & rwi_pierceability_mask) | (geom_colltype14 << rwi_colltype_bit);
+	SRayRequest request;
+	request.origin = aimPos;
+	request.dir = aimDir * 2.f * maxDistance;
+	request.objTypes = ent_all;
+	request.flags = (geom_colltype_ray << rwi_colltype_bit) | rwi_colltype_any | (8 & rwi_pierceability_mask) | (geom_colltype14 << rwi_colltype_bit);
+	request.SetSkipEntities(pSkipEnts, nSkipEnts);
+
+	// the ray is cast together with the other queued rays after the entity update,
+	// so lock-on reacts to the eye ray of the previous frame
+	CRayBroker& rayBroker = g_pGame->GetWeaponSystem()->GetRayBroker();
+	rayBroker.QueueRay(m_pWeapon->GetEntityId(), request);
 
-	int result = gEnv->pPhysicalWorld->RayWorldIntersection(aimPos, aimDir * 2.f * maxDistance,
-		objects, flags, &ray, 1, pSkipEnts, nSkipEnts);
+	ray_hit ray;
+	int result = 0;
+	if (!rayBroker.GetQueuedResult(m_pWeapon->GetEntityId(), request, ray, result))
+		return;
 
 	bool hitValidTarget = false;
 	IEntity* pEntity = 0;
@@ -1335,7 +1344,15 @@ bool CSingle::CrosshairAssistAiming(const Vec3& firingPos, Vec3& firingDir, ray_
 			// check path to new target pos 
 			ray_hit chkhit;
 			IPhysicalEntity* pSkip = m_pWeapon->GetEntity()->GetPhysics(); // we shouldn't need all child entities for skipping at this point (subject to be proven)
-			if (gEnv->pPhysicalWorld->RayWorldIntersection(firingPos, 1.1f * (newPos - firingPos), ent_all, (13 & rwi_pierceability_mask), &chkhit, 1, &pSkip, 1))
+
+			SRayRequest request;
+			request.origin = firingPos;
+			request.dir = 1.1f * (newPos - firingPos);
+			request.objTypes = ent_all;
+			request.flags = (13 & rwi_pierceability_mask);
+			request.SetSkipEntities(&pSkip, 1);
+
+			if (g_pGame->GetWeaponSystem()->GetRayBroker().CastRay(request, chkhit))
 			{
 				IEntity* pFound = chkhit.pCollider ? gEnv->pEntitySystem->GetEntityFromPhysics(chkhit.pCollider) : 0;
 				if (pFound != pEntity)
@@ -1794,7 +1811,17 @@ Vec3 CSingle::GetProbableHit(float range, bool* pbHit, ray_hit* pHit) const
 	}
 	flags |= pierceability;
 
-	if (gEnv->pPhysicalWorld->RayWorldIntersection(pos, dir, ent_all, flags, &hit, 1, pSkipEntities, nSkip))
+	// the HUD, auto aim and firing often ask for the same probe in one frame
+	CRayBroker& rayBroker = g_pGame->GetWeaponSystem()->GetRayBroker();
+
+	SRayRequest request;
+	request.origin = pos;
+	request.dir = dir;
+	request.objTypes = ent_all;
+	request.flags = flags;
+	request.SetSkipEntities(pSkipEntities, nSkip);
+
+	if (rayBroker.CastRay(request, hit))
 	{
 		if (pbHit)
 			*pbHit = true;
@@ -1819,8 +1846,11 @@ Vec3 CSingle::GetProbableHit(float range, bool* pbHit, ray_hit* pHit) const
 				{
 					// now do a new intersection test forwards from the point where the previous rwi intersected the plane...
 					Vec3 newPos = pos - dist * n;
-					if (gEnv->pPhysicalWorld->RayWorldIntersection(newPos, dir, ent_all,
-						rwi_stop_at_pierceable | rwi_ignore_back_faces, &hit, 1, pSkipEntities, nSkip))
+
+					request.origin = newPos;
+					request.flags = rwi_stop_at_pierceable | rwi_ignore_back_faces;
+
+					if (rayBroker.CastRay(request, hit))
 					{
 						if (pbHit)
 							*pbHit = true;
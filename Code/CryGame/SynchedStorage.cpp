@@ -1,3 +1,8 @@
+#include <algorithm>
+#ifdef _DEBUG
+#include <chrono>
+#endif
+
 #include "CryCommon/CrySystem/ISystem.h"
 #include "CryCommon/CryEntitySystem/IEntitySystem.h"
 
@@ -43,7 +48,7 @@ static void DumpValue(TSynchedKey key, const TSynchedValue & value)
 void CSynchedStorage::Reset()
 {
 	m_globalStorage.clear();
-	m_entityStorage.clear();
+	m_entityStorage.Clear();
 	m_channelStorageMap.clear();
 	m_channelStorage.clear();
 }
@@ -88,20 +93,194 @@ void CSynchedStorage::Dump()
 
 	CryLogAlways("---------------------------\n");
 
-	for (const auto & entityItem : m_entityStorage)
+	// entity values are stored in insertion order, so group them by entity and key first
+	std::vector<const CSynchedEntityStorage::SEntry*> entries;
+	entries.reserve(m_entityStorage.Size());
+
+	for (const auto & entry : m_entityStorage)
+	{
+		entries.push_back(&entry);
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const auto *a, const auto *b)
 	{
-		IEntity *pEntity = gEnv->pEntitySystem->GetEntity(entityItem.first);
-		const char *name = pEntity ? pEntity->GetName() : "null";
+		return a->entityId != b->entityId ? a->entityId < b->entityId : a->key < b->key;
+	});
 
-		CryLogAlways("Entity %.08d(%s)", entityItem.first, name);
+	EntityId lastEntityId = 0;
 
-		for (const auto & item : entityItem.second)
+	for (const CSynchedEntityStorage::SEntry *pEntry : entries)
+	{
+		if (pEntry == entries.front() || pEntry->entityId != lastEntityId)
 		{
-			DumpValue(item.first, item.second);
+			IEntity *pEntity = gEnv->pEntitySystem->GetEntity(pEntry->entityId);
+			const char *name = pEntity ? pEntity->GetName() : "null";
+
+			CryLogAlways("Entity %.08d(%s)", pEntry->entityId, name);
+
+			lastEntityId = pEntry->entityId;
 		}
+
+		DumpValue(pEntry->key, pEntry->value);
 	}
 }
 
+#ifdef _DEBUG
+namespace
+{
+	// entity values without network messages, so only the storage is timed
+	class CBenchmarkSynchedStorage : public CSynchedStorage
+	{
+	public:
+		void DefineProtocol(IProtocolBuilder *pBuilder) override
+		{
+		}
+
+		bool HasDef(const SNetMessageDef *pDef) override
+		{
+			return false;
+		}
+	};
+
+	// the previous entity storage layout with the previous set and get code
+	class CNestedEntityStorage
+	{
+		std::map<EntityId, CSynchedStorage::TStorage> m_storage;
+
+	public:
+		void SetEntityValue(EntityId id, TSynchedKey key, int value)
+		{
+			CSynchedStorage::TStorage & storage = m_storage[id];
+
+			auto it = storage.find(key);
+			if (it == storage.end())
+			{
+				storage[key].Set(value);
+			}
+			else
+			{
+				const int *pStoredValue = it->second.GetPtr<int>();
+				if (!pStoredValue || *pStoredValue != value)
+				{
+					it->second.Set(value);
+				}
+			}
+		}
+
+		bool GetEntityValue(EntityId id, TSynchedKey key, int & value) const
+		{
+			auto eit = m_storage.find(id);
+			if (eit == m_storage.end())
+			{
+				return false;
+			}
+
+			auto it = eit->second.find(key);
+			if (it == eit->second.end())
+			{
+				return false;
+			}
+
+			const int *pStoredValue = it->second.GetPtr<int>();
+			if (!pStoredValue)
+			{
+				return false;
+			}
+
+			value = *pStoredValue;
+
+			return true;
+		}
+
+		int64 Sum() const
+		{
+			int64 sum = 0;
+
+			for (const auto & entityItem : m_storage)
+			{
+				for (const auto & item : entityItem.second)
+				{
+					sum += *item.second.GetPtr<int>();
+				}
+			}
+
+			return sum;
+		}
+	};
+
+	template<class Storage>
+	void BenchmarkEntityValues(Storage & storage, double & setMs, double & getMs, int64 & sum)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		const EntityId PLAYER_COUNT = 64;
+		const TSynchedKey KEY_COUNT = 50;
+		const int ROUNDS = 100;
+
+		Clock::time_point start = Clock::now();
+		for (int round = 0; round < ROUNDS; round++)
+		{
+			for (EntityId id = 1; id <= PLAYER_COUNT; id++)
+			{
+				for (TSynchedKey key = 0; key < KEY_COUNT; key++)
+				{
+					storage.SetEntityValue(id, key, round);
+				}
+			}
+		}
+		setMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		start = Clock::now();
+		for (int round = 0; round < ROUNDS; round++)
+		{
+			for (EntityId id = 1; id <= PLAYER_COUNT; id++)
+			{
+				for (TSynchedKey key = 0; key < KEY_COUNT; key++)
+				{
+					int value = 0;
+					if (storage.GetEntityValue(id, key, value))
+					{
+						sum += value;
+					}
+				}
+			}
+		}
+		getMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+}
+
+void CSynchedStorage::Benchmark()
+{
+	CNestedEntityStorage nested;
+	CBenchmarkSynchedStorage flat;
+
+	double nestedSetMs = 0, nestedGetMs = 0, flatSetMs = 0, flatGetMs = 0;
+	int64 nestedSum = 0, flatSum = 0;
+
+	BenchmarkEntityValues(nested, nestedSetMs, nestedGetMs, nestedSum);
+	BenchmarkEntityValues(flat, flatSetMs, flatGetMs, flatSum);
+
+	nestedSum += nested.Sum();
+
+	const CSynchedStorage & flatStorage = flat;
+
+	for (const auto & entry : flatStorage.m_entityStorage)
+	{
+		flatSum += *entry.value.GetPtr<int>();
+	}
+
+	CryLogAlways("Synched storage benchmark: 64 players, 50 keys, 100 rounds of SetEntityValue and GetEntityValue");
+	CryLogAlways("%-10s %12s %12s", "", "std::map ms", "flat ms");
+	CryLogAlways("%-10s %12.3f %12.3f", "Set", nestedSetMs, flatSetMs);
+	CryLogAlways("%-10s %12.3f %12.3f", "Get", nestedGetMs, flatGetMs);
+
+	if (nestedSum != flatSum)
+	{
+		CryLogWarningAlways("Synched storage benchmark: results differ");
+	}
+}
+#endif
+
 void CSynchedStorage::SerializeValue(TSerialize ser, TSynchedKey & key, TSynchedValue & value, int type)
 {
 	ser.Value("key", key, 'ssk');
@@ -300,22 +479,6 @@ void CSynchedStorage::SerializeEntityValue(TSerialize ser, EntityId id, TSynched
 	}
 }
 
-CSynchedStorage::TStorage *CSynchedStorage::GetEntityStorage(EntityId id, bool create)
-{
-	auto it = m_entityStorage.find(id);
-	if (it == m_entityStorage.end())
-	{
-		if (create)
-		{
-			return &m_entityStorage[id];
-		}
-
-		return nullptr;
-	}
-
-	return &it->second;
-}
-
 CSynchedStorage::TStorage *CSynchedStorage::GetChannelStorage(int channelId, bool create)
 {
 	auto it = m_channelStorageMap.find(channelId);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 
 #include "CryCommon/CryNetwork/INetwork.h"
 #include "CryCommon/CryAction/IGameFramework.h"
@@ -21,18 +22,139 @@ enum ESynchedValueTypes
 using TSynchedKey = uint16;
 using TSynchedValue = CConfigurableVariant<TSynchedValueTypes, sizeof (void*)>;
 
+// Open addressing hash map of entity values keyed by (entity, key).
+// Values are kept in a dense array in insertion order, so iteration is stable and cache friendly.
+// Values are never removed one by one, only all at once.
+class CSynchedEntityStorage
+{
+public:
+	struct SEntry
+	{
+		EntityId entityId;
+		TSynchedKey key;
+		TSynchedValue value;
+	};
+
+	using TEntries = std::vector<SEntry>;
+
+private:
+	TEntries m_entries;
+	std::vector<uint32> m_slots;  // index of entry + 1, 0 is empty slot, size is power of two
+
+	static uint32 Hash(EntityId entityId, TSynchedKey key)
+	{
+		const uint64 x = ((static_cast<uint64>(entityId) << 16) | key) * 0x9E3779B97F4A7C15ULL;
+
+		return static_cast<uint32>(x >> 32);
+	}
+
+	uint32 FindSlot(EntityId entityId, TSynchedKey key) const
+	{
+		const uint32 mask = static_cast<uint32>(m_slots.size()) - 1;
+
+		for (uint32 slot = Hash(entityId, key) & mask;; slot = (slot + 1) & mask)
+		{
+			const uint32 index = m_slots[slot];
+
+			if (index == 0)
+			{
+				return slot;
+			}
+
+			const SEntry & entry = m_entries[index - 1];
+
+			if (entry.entityId == entityId && entry.key == key)
+			{
+				return slot;
+			}
+		}
+	}
+
+	void Rehash(size_t slotCount)
+	{
+		m_slots.assign(slotCount, 0);
+
+		for (size_t i = 0; i < m_entries.size(); i++)
+		{
+			const SEntry & entry = m_entries[i];
+
+			m_slots[FindSlot(entry.entityId, entry.key)] = static_cast<uint32>(i + 1);
+		}
+	}
+
+public:
+	const SEntry *Find(EntityId entityId, TSynchedKey key) const
+	{
+		if (m_entries.empty())
+		{
+			return nullptr;
+		}
+
+		const uint32 index = m_slots[FindSlot(entityId, key)];
+
+		return index ? &m_entries[index - 1] : nullptr;
+	}
+
+	SEntry *Find(EntityId entityId, TSynchedKey key)
+	{
+		return const_cast<SEntry*>(static_cast<const CSynchedEntityStorage*>(this)->Find(entityId, key));
+	}
+
+	// returns the existing entry or a new one with an empty value
+	SEntry & Insert(EntityId entityId, TSynchedKey key, bool & isNew)
+	{
+		// keep load factor below 3/4
+		if ((m_entries.size() + 1) * 4 > m_slots.size() * 3)
+		{
+			Rehash(m_slots.empty() ? 256 : m_slots.size() * 2);
+		}
+
+		uint32 & index = m_slots[FindSlot(entityId, key)];
+
+		isNew = (index == 0);
+
+		if (isNew)
+		{
+			m_entries.push_back(SEntry{ entityId, key, TSynchedValue() });
+			index = static_cast<uint32>(m_entries.size());
+		}
+
+		return m_entries[index - 1];
+	}
+
+	void Clear()
+	{
+		m_entries.clear();
+		m_slots.clear();
+	}
+
+	size_t Size() const
+	{
+		return m_entries.size();
+	}
+
+	TEntries::const_iterator begin() const
+	{
+		return m_entries.begin();
+	}
+
+	TEntries::const_iterator end() const
+	{
+		return m_entries.end();
+	}
+};
+
 class CSynchedStorage : public INetMessageSink
 {
 public:
 	using TStorage = std::map<TSynchedKey, TSynchedValue>;
 
-	using TEntityStorageMap = std::map<EntityId, TStorage>;
 	using TChannelStorageMap = std::map<int, TStorage>;
 
 protected:
 	TStorage m_globalStorage;
 	TStorage m_channelStorage;
-	TEntityStorageMap m_entityStorage;
+	CSynchedEntityStorage m_entityStorage;
 	TChannelStorageMap m_channelStorageMap;
 
 	IGameFramework *m_pGameFramework = nullptr;
@@ -119,33 +241,27 @@ public:
 	template<typename ValueType>
 	void SetEntityValue(EntityId id, TSynchedKey key, const ValueType & value)
 	{
-		TStorage & storage = *GetEntityStorage(id, true);
+		bool isNew = false;
+		TSynchedValue & storedValue = m_entityStorage.Insert(id, key, isNew).value;
 
-		auto it = storage.find(key);
-		if (it == storage.end())
-		{
-			TSynchedValue & newValue = storage[key];
-			newValue.Set(value);
-
-			OnEntityChanged(id, key, newValue);
-		}
-		else
+		if (!isNew)
 		{
-			const ValueType *pStoredValue = it->second.GetPtr<ValueType>();
-			if (!pStoredValue || *pStoredValue != value)
+			const ValueType *pStoredValue = storedValue.GetPtr<ValueType>();
+			if (pStoredValue && *pStoredValue == value)
 			{
-				it->second.Set(value);
-
-				OnEntityChanged(id, key, it->second);
+				return;
 			}
 		}
+
+		storedValue.Set(value);
+
+		OnEntityChanged(id, key, storedValue);
 	}
 
 	void SetEntityValue(EntityId id, TSynchedKey key, const TSynchedValue & value)
 	{
-		TStorage & storage = *GetEntityStorage(id, true);
-
-		storage[key] = value;
+		bool isNew = false;
+		m_entityStorage.Insert(id, key, isNew).value = value;
 
 		// always true since we can't compare two TSynchedValue
 		OnEntityChanged(id, key, value);
@@ -277,19 +393,13 @@ public:
 	template<typename ValueType>
 	bool GetEntityValue(EntityId entityId, TSynchedKey key, ValueType & value) const
 	{
-		auto eit = m_entityStorage.find(entityId);
-		if (eit == m_entityStorage.end())
-		{
-			return false;
-		}
-
-		auto it = eit->second.find(key);
-		if (it == eit->second.end())
+		const CSynchedEntityStorage::SEntry *pEntry = m_entityStorage.Find(entityId, key);
+		if (!pEntry)
 		{
 			return false;
 		}
 
-		const ValueType *pStoredValue = it->second.GetPtr<ValueType>();
+		const ValueType *pStoredValue = pEntry->value.GetPtr<ValueType>();
 		if (!pStoredValue)
 		{
 			return false;
@@ -302,19 +412,13 @@ public:
 
 	bool GetEntityValue(EntityId entityId, TSynchedKey key, TSynchedValue & value) const
 	{
-		auto eit = m_entityStorage.find(entityId);
-		if (eit == m_entityStorage.end())
+		const CSynchedEntityStorage::SEntry *pEntry = m_entityStorage.Find(entityId, key);
+		if (!pEntry)
 		{
 			return false;
 		}
 
-		auto it = eit->second.find(key);
-		if (it == eit->second.end())
-		{
-			return false;
-		}
-
-		value = it->second;
+		value = pEntry->value;
 
 		return true;
 	}
@@ -332,29 +436,27 @@ public:
 
 	int GetEntityValueType(EntityId id, TSynchedKey key) const
 	{
-		auto eit = m_entityStorage.find(id);
-		if (eit == m_entityStorage.end())
+		const CSynchedEntityStorage::SEntry *pEntry = m_entityStorage.Find(id, key);
+		if (!pEntry)
 		{
 			return eSVT_None;
 		}
 
-		auto it = eit->second.find(key);
-		if (it == eit->second.end())
-		{
-			return eSVT_None;
-		}
-
-		return it->second.GetType();
+		return pEntry->value.GetType();
 	}
 
 	virtual void Reset();
 
 	virtual void Dump();
 
+#ifdef _DEBUG
+	// times SetEntityValue and GetEntityValue against the previous nested std::map layout
+	static void Benchmark();
+#endif
+
 	virtual void SerializeValue(TSerialize ser, TSynchedKey & key, TSynchedValue & value, int type);
 	virtual void SerializeEntityValue(TSerialize ser, EntityId id, TSynchedKey & key, TSynchedValue & value, int type);
 
-	virtual TStorage *GetEntityStorage(EntityId id, bool create = false);
 	virtual TStorage *GetChannelStorage(int channelId, bool create = false);
 
 	virtual void OnGlobalChanged(TSynchedKey key, const TSynchedValue & value)
@@ -20,195 +20,128 @@ History:
 
 #define TRACER_GEOM_SLOT  0
 #define TRACER_FX_SLOT    1
+#define TRACER_MAX_CAPACITY 1024
 //------------------------------------------------------------------------
-CTracer::CTracer(const Vec3 &pos)
-: m_pos(0,0,0),
-	m_dest(0,0,0),
-	m_startingpos(pos),
-	m_age(0.0f),
-	m_lifeTime(1.5f),
-	m_entityId(0),
-	m_useGeometry(false),
-	m_geometrySlot(0)
+CTracerManager::CTracerManager()
+: m_activeHead(0),
+	m_activeCount(0),
+	m_capacity(0)
 {
-	CreateEntity();
 }
 
 //------------------------------------------------------------------------
-CTracer::~CTracer()
+CTracerManager::~CTracerManager()
 {
-	if (m_entityId)
-		gEnv->pEntitySystem->RemoveEntity(m_entityId);
-	m_entityId=0;
 }
 
 //------------------------------------------------------------------------
-void CTracer::Reset(const Vec3 &pos)
+EntityId CTracerManager::SpawnTracerEntity()
 {
-	m_pos=Vec3(0,0,0);
-	m_dest=Vec3(0,0,0);
-	m_startingpos=pos;
-	m_age=0.0f;
-	m_lifeTime=1.5f;
+	SEntitySpawnParams spawnParams;
+	spawnParams.pClass = gEnv->pEntitySystem->GetClassRegistry()->GetDefaultClass();
+	spawnParams.sName = "_tracer";
+	spawnParams.nFlags = ENTITY_FLAG_NO_PROXIMITY | ENTITY_FLAG_CLIENT_ONLY | ENTITY_FLAG_NO_SAVE;
 
-	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId))
+	if (IEntity *pEntity=gEnv->pEntitySystem->SpawnEntity(spawnParams))
 	{
-		pEntity->FreeSlot(TRACER_GEOM_SLOT);
-		pEntity->FreeSlot(TRACER_FX_SLOT);
+		pEntity->Hide(1);
+		return pEntity->GetId();
 	}
-}
-
-//------------------------------------------------------------------------
-void CTracer::CreateEntity()
-{
-	if (!m_entityId)
-	{
-		SEntitySpawnParams spawnParams;
-		spawnParams.pClass = gEnv->pEntitySystem->GetClassRegistry()->GetDefaultClass();
-		spawnParams.sName = "_tracer";
-		spawnParams.nFlags = ENTITY_FLAG_NO_PROXIMITY | ENTITY_FLAG_CLIENT_ONLY | ENTITY_FLAG_NO_SAVE;
 
-		if (IEntity *pEntity=gEnv->pEntitySystem->SpawnEntity(spawnParams))
-			m_entityId=pEntity->GetId();
-	}
-}
-
-//------------------------------------------------------------------------
-void CTracer::GetMemoryStatistics(ICrySizer * s) const
-{
-	s->Add(*this);
+	return 0;
 }
 
 //------------------------------------------------------------------------
-void CTracer::SetGeometry(const char *name, float scale)
+void CTracerManager::Prewarm()
 {
-	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId))
-	{
-		m_geometrySlot =pEntity->LoadGeometry(TRACER_GEOM_SLOT, name);
+	Reset();
 
-		if (scale!=1.0f)
-		{
-			Matrix34 tm=Matrix34::CreateIdentity();
-			tm.Scale(Vec3(scale, scale, scale));
-			pEntity->SetSlotLocalTM(m_geometrySlot, tm);
-		}
-	}
-}
-
-//------------------------------------------------------------------------
-void CTracer::SetEffect(const char *name, float scale)
-{
-	IParticleEffect *pEffect = gEnv->p3DEngine->FindParticleEffect(name);
-	if (!pEffect)
+	if (!gEnv->bClient || !g_pGameCVars->g_enableTracers)
 		return;
 
-	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId))
+	m_capacity = CLAMP(g_pGameCVars->tracer_max_count, 0, TRACER_MAX_CAPACITY);
+
+	m_pos.resize(m_capacity, Vec3(0,0,0));
+	m_dest.resize(m_capacity, Vec3(0,0,0));
+	m_speed.resize(m_capacity, 0.0f);
+	m_age.resize(m_capacity, 0.0f);
+	m_lifeTime.resize(m_capacity, 1.5f);
+	m_entityId.resize(m_capacity, 0);
+	m_geometrySlot.resize(m_capacity, 0);
+	m_useGeometry.resize(m_capacity, false);
+	m_dir.resize(m_capacity, Vec3(0,1,0));
+	m_scale.resize(m_capacity, 1.0f);
+
+	m_actives.resize(m_capacity, 0);
+	m_free.reserve(m_capacity);
+	m_finished.reserve(m_capacity);
+
+	// lowest slots are used first
+	for (int i=m_capacity-1; i>=0; --i)
 	{
-		int slot=pEntity->LoadParticleEmitter(TRACER_FX_SLOT, pEffect,0,true);
-		if (scale!=1.0f)
-		{
-			Matrix34 tm=Matrix34::CreateIdentity();
-			tm.Scale(Vec3(scale, scale, scale));
-			pEntity->SetSlotLocalTM(slot, tm);
-		}
+		m_entityId[i]=SpawnTracerEntity();
+		m_free.push_back(i);
 	}
 }
 
 //------------------------------------------------------------------------
-bool CTracer::Update(float frameTime, const Vec3 &camera)
+int CTracerManager::AcquireTracer()
 {
-	if(m_age==0.0f)
+	if (!m_free.empty())
 	{
-		m_age+=0.002f;
-		frameTime = 0.002f;
+		int idx=m_free.back();
+		m_free.pop_back();
+		return idx;
 	}
-	else
-		m_age += frameTime;
-
-	if (m_age >= m_lifeTime)
-		return false;
 
-	Vec3 end(m_dest);
-
-	if (((m_pos-end).len2() <= 0.25f))
-		return false;
-
-	Vec3 dp = end-m_pos;
-	float dist = dp.len();
-	Vec3 dir = dp/dist;
-
-	float scaleMult=1.0f;
-
-	float minDistance = g_pGameCVars->tracer_min_distance;
-	float maxDistance = g_pGameCVars->tracer_max_distance;
-	float minScale = g_pGameCVars->tracer_min_scale;
-	float maxScale = g_pGameCVars->tracer_max_scale;
-	float sqrRadius = g_pGameCVars->tracer_player_radiusSqr;
-
-	float cameraDistance = (m_pos-camera).len2();
-	float speed = m_speed;
-
-	//Slow down tracer when near the player
-	if(cameraDistance<=sqrRadius)
-		speed *= (0.35f + (cameraDistance/(sqrRadius*2)));
-
-	m_pos = m_pos+dir*MIN(speed*frameTime, dist);
-	
-	cameraDistance = (m_pos-camera).len2();
-
-	if (cameraDistance<=minDistance*minDistance)
-		scaleMult=minScale;
-	else if (cameraDistance>=maxDistance*maxDistance)
-		scaleMult=maxScale;
-	else
+	if (m_activeCount>0)
 	{
-		float t=(sqrtf(cameraDistance)-minDistance)/(maxDistance-minDistance);
-		scaleMult=minScale+t*(maxScale-minScale);
+		// pool is full, recycle the oldest tracer
+		int idx=m_actives[m_activeHead];
+		m_activeHead=(m_activeHead+1)%m_capacity;
+		--m_activeCount;
+		return idx;
 	}
 
-	const float assetLenght = 2.0f;
-	if((m_pos-m_dest).len2()<0.25f)
-		return false;
-
-	UpdateVisual(m_pos, dir, m_useGeometry?scaleMult:1.0f, 1.0f);
-
-	return true;
+	return -1;
 }
 
 //------------------------------------------------------------------------
-void CTracer::UpdateVisual(const Vec3 &pos, const Vec3 &dir, float scale, float length)
+void CTracerManager::ReleaseTracer(int idx)
 {
-	Matrix34 tm(Matrix33::CreateRotationVDir(dir));
-	tm.AddTranslation(pos);
-
-	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId))
-	{
-		pEntity->SetWorldTM(tm);
-		//Do not scale effects
-		if(m_useGeometry)
-		{
-			tm.SetIdentity();
-			tm.SetScale(Vec3(1.0f,scale,1.0f));
-			pEntity->SetSlotLocalTM(m_geometrySlot,tm);
-		}
-	}
+	HideTracer(idx);
+	m_free.push_back(idx);
 }
 
 //------------------------------------------------------------------------
-void CTracer::SetLifeTime(float lifeTime)
+void CTracerManager::HideTracer(int idx)
 {
-	m_lifeTime = lifeTime;
+	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId[idx]))
+	{
+		pEntity->Hide(1);
+		pEntity->SetWorldTM(Matrix34::CreateIdentity());
+	}
 }
 
 //------------------------------------------------------------------------
-CTracerManager::CTracerManager()
-: m_lastFree(0)
+void CTracerManager::SetGeometry(int idx, const char *name)
 {
+	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId[idx]))
+	{
+		m_geometrySlot[idx]=pEntity->LoadGeometry(TRACER_GEOM_SLOT, name);
+		m_useGeometry[idx]=true;
+	}
 }
 
 //------------------------------------------------------------------------
-CTracerManager::~CTracerManager()
+void CTracerManager::SetEffect(int idx, const char *name)
 {
+	IParticleEffect *pEffect = gEnv->p3DEngine->FindParticleEffect(name);
+	if (!pEffect)
+		return;
+
+	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId[idx]))
+		pEntity->LoadParticleEmitter(TRACER_FX_SLOT, pEffect,0,true);
 }
 
 //------------------------------------------------------------------------
@@ -217,69 +150,60 @@ void CTracerManager::EmitTracer(const STracerParams &params)
 	if(!g_pGameCVars->g_enableTracers || !gEnv->bClient)
 		return;
 
-	int idx=0;
-	if (m_pool.empty() && g_pGameCVars->tracer_max_count>0)
+	if (!m_capacity)
 	{
-		m_pool.push_back(new CTracer(params.position));
-		idx=m_pool.size()-1;
+		Prewarm();
+
+		if (!m_capacity)
+			return;
 	}
-	else
+
+	int idx=AcquireTracer();
+	if (idx<0)
+		return;
+
+	IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId[idx]);
+	if (!pEntity)
 	{
-		int s=m_pool.size();
-		int i=m_lastFree+1;
+		// removed by someone else, replace it
+		m_entityId[idx]=SpawnTracerEntity();
+		pEntity=gEnv->pEntitySystem->GetEntity(m_entityId[idx]);
 
-		while (true)
+		if (!pEntity)
 		{
-			IEntity *pEntity=0;
-			if (i<(int)m_pool.size())
-				pEntity=gEnv->pEntitySystem->GetEntity(m_pool[i]->m_entityId);
-
-			if (i==s)
-				i=0;
-			else if (i==m_lastFree)
-			{
-				m_pool.push_back(new CTracer(params.position));
-				idx=m_pool.size()-1;
-				break;
-			}
-			else if (pEntity && pEntity->IsHidden())
-			{
-				m_pool[i]->Reset(params.position);
-				idx=i;
-				break;
-			}
-			else
-				++i;
+			m_free.push_back(idx);
+			return;
 		}
 	}
 
-	m_lastFree=idx;
+	pEntity->FreeSlot(TRACER_GEOM_SLOT);
+	pEntity->FreeSlot(TRACER_FX_SLOT);
 
-	CTracer *tracer = m_pool[idx];
+	m_useGeometry[idx]=false;
 
 	if (params.geometry && params.geometry[0])
-	{
-		tracer->SetGeometry(params.geometry, 1.0f);
-		tracer->m_useGeometry = true;
-	}
+		SetGeometry(idx, params.geometry);
 	if (params.effect && params.effect[0])
-		tracer->SetEffect(params.effect, 1.0f);
-
-	tracer->SetLifeTime(params.lifetime);
+		SetEffect(idx, params.effect);
 
-	tracer->m_speed = params.speed;
-	tracer->m_pos = params.position;
-	tracer->m_dest = params.destination;
+	m_lifeTime[idx]=params.lifetime;
+	m_speed[idx]=params.speed;
+	m_pos[idx]=params.position;
+	m_dest[idx]=params.destination;
+	m_age[idx]=0.0f;
 
-	if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(tracer->m_entityId))
-		pEntity->Hide(0);
+	pEntity->Hide(0);
 
-	m_actives.push_back(idx);
+	m_actives[(m_activeHead+m_activeCount)%m_capacity]=idx;
+	++m_activeCount;
 }
 
 //------------------------------------------------------------------------
 void CTracerManager::Update(float frameTime)
 {
+	if (!m_activeCount)
+		return;
+
 	IActor *pActor=g_pGame->GetIGameFramework()->GetClientActor();
 	if (!pActor)
 		return;
@@ -287,48 +211,155 @@ void CTracerManager::Update(float frameTime)
 	SMovementState state;
 	if (!pActor->GetMovementController())
 		return;
-	
+
 	pActor->GetMovementController()->GetMovementState(state);
 
-	m_actives.swap(m_updating);
-	for (TTracerIdVector::iterator it = m_updating.begin(); it!=m_updating.end(); ++it)
+	const Vec3 camera=state.eyePosition;
+
+	const float minDistance = g_pGameCVars->tracer_min_distance;
+	const float maxDistance = g_pGameCVars->tracer_max_distance;
+	const float minScale = g_pGameCVars->tracer_min_scale;
+	const float maxScale = g_pGameCVars->tracer_max_scale;
+	const float sqrRadius = g_pGameCVars->tracer_player_radiusSqr;
+
+	// move all tracers and keep the active ones in order
+	int kept=0;
+	for (int n=0; n<m_activeCount; ++n)
 	{
-		CTracer *tracer = m_pool[*it];
+		const int idx=m_actives[(m_activeHead+n)%m_capacity];
 
-		if (tracer->Update(frameTime, state.eyePosition))
-			m_actives.push_back(*it);
+		float step=frameTime;
+		if (m_age[idx]==0.0f)
+		{
+			m_age[idx]=0.002f;
+			step=0.002f;
+		}
 		else
+			m_age[idx]+=frameTime;
+
+		Vec3 pos=m_pos[idx];
+		const Vec3 dest=m_dest[idx];
+		const Vec3 dp=dest-pos;
+
+		if (m_age[idx]>=m_lifeTime[idx] || dp.len2()<=0.25f)
+		{
+			m_finished.push_back(idx);
+			continue;
+		}
+
+		const float dist=dp.len();
+		const Vec3 dir=dp/dist;
+
+		float speed=m_speed[idx];
+		float cameraDistance=(pos-camera).len2();
+
+		//Slow down tracer when near the player
+		if (cameraDistance<=sqrRadius)
+			speed *= (0.35f + (cameraDistance/(sqrRadius*2)));
+
+		pos=pos+dir*MIN(speed*step, dist);
+
+		if ((pos-dest).len2()<0.25f)
+		{
+			m_finished.push_back(idx);
+			continue;
+		}
+
+		float scaleMult=1.0f;
+		if (m_useGeometry[idx])
 		{
-			if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(tracer->m_entityId))
+			cameraDistance=(pos-camera).len2();
+
+			if (cameraDistance<=minDistance*minDistance)
+				scaleMult=minScale;
+			else if (cameraDistance>=maxDistance*maxDistance)
+				scaleMult=maxScale;
+			else
 			{
-				pEntity->Hide(1);
-				pEntity->SetWorldTM(Matrix34::CreateIdentity());
+				float t=(sqrtf(cameraDistance)-minDistance)/(maxDistance-minDistance);
+				scaleMult=minScale+t*(maxScale-minScale);
 			}
 		}
+
+		m_pos[idx]=pos;
+		m_dir[idx]=dir;
+		m_scale[idx]=scaleMult;
+
+		m_actives[(m_activeHead+kept)%m_capacity]=idx;
+		++kept;
 	}
 
-	m_updating.resize(0);
+	m_activeCount=kept;
+
+	// apply results to the entities
+	for (int n=0; n<m_activeCount; ++n)
+	{
+		const int idx=m_actives[(m_activeHead+n)%m_capacity];
+
+		if (IEntity *pEntity=gEnv->pEntitySystem->GetEntity(m_entityId[idx]))
+		{
+			Matrix34 tm(Matrix33::CreateRotationVDir(m_dir[idx]));
+			tm.AddTranslation(m_pos[idx]);
+			pEntity->SetWorldTM(tm);
+
+			//Do not scale effects
+			if (m_useGeometry[idx])
+			{
+				tm.SetIdentity();
+				tm.SetScale(Vec3(1.0f,m_scale[idx],1.0f));
+				pEntity->SetSlotLocalTM(m_geometrySlot[idx],tm);
+			}
+		}
+	}
+
+	for (TTracerIdVector::iterator it = m_finished.begin(); it!=m_finished.end(); ++it)
+		ReleaseTracer(*it);
+
+	m_finished.resize(0);
 }
 
 //------------------------------------------------------------------------
 void CTracerManager::Reset()
 {
-	for (TTracerPool::iterator it = m_pool.begin(); it!=m_pool.end(); ++it)
-		delete *it;
+	for (int i=0; i<m_capacity; ++i)
+	{
+		if (m_entityId[i])
+			gEnv->pEntitySystem->RemoveEntity(m_entityId[i]);
+	}
 
-	m_updating.resize(0);
+	m_pos.clear();
+	m_dest.clear();
+	m_speed.clear();
+	m_age.clear();
+	m_lifeTime.clear();
+	m_entityId.clear();
+	m_geometrySlot.clear();
+	m_useGeometry.clear();
+	m_dir.clear();
+	m_scale.clear();
+
+	m_free.resize(0);
 	m_actives.resize(0);
-	m_pool.resize(0);
+	m_finished.resize(0);
+	m_activeHead=0;
+	m_activeCount=0;
+	m_capacity=0;
 }
 
 void CTracerManager::GetMemoryStatistics(ICrySizer * s)
 {
 	SIZER_SUBCOMPONENT_NAME(s, "TracerManager");
 	s->Add(*this);
-	s->AddContainer(m_updating);
+	s->AddContainer(m_pos);
+	s->AddContainer(m_dest);
+	s->AddContainer(m_speed);
+	s->AddContainer(m_age);
+	s->AddContainer(m_lifeTime);
+	s->AddContainer(m_entityId);
+	s->AddContainer(m_geometrySlot);
+	s->AddContainer(m_dir);
+	s->AddContainer(m_scale);
+	s->AddContainer(m_free);
 	s->AddContainer(m_actives);
-	s->AddContainer(m_pool);
-
-	for (size_t i=0; i<m_pool.size(); i++)
-		m_pool[i]->GetMemoryStatistics(s);
+	s->AddContainer(m_finished);
 }
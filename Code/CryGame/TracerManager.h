@@ -19,40 +19,11 @@ History:
 #endif
 
 
-class CTracer
-{
-	friend class CTracerManager;
-public:
-	CTracer(const Vec3 &pos);
-	virtual ~CTracer();
-
-	void Reset(const Vec3 &pos);
-	void CreateEntity();
-	void SetGeometry(const char *name, float scale);
-	void SetEffect(const char *name, float scale);
-	void SetLifeTime(float lifeTime);
-	bool Update(float frameTime, const Vec3 &campos);
-	void UpdateVisual(const Vec3 &pos, const Vec3 &dir, float scale, float length);
-	float GetAge() const;
-	void GetMemoryStatistics(ICrySizer * s) const;
-
-private:
-	float				m_speed;
-	Vec3				m_pos;
-	Vec3				m_dest;
-	Vec3				m_startingpos;
-	float				m_age;
-	float				m_lifeTime;
-	bool        m_useGeometry;
-	int         m_geometrySlot;
-
-	EntityId		m_entityId;
-};
-
-
+// Fixed-capacity pool of tracer entities.
+// The entities are spawned once when the game starts and then only hidden and shown again.
+// Tracer state is kept in parallel arrays indexed by tracer slot.
 class CTracerManager
 {
-	typedef std::vector<CTracer *>	TTracerPool;
 	typedef std::vector<int>				TTracerIdVector;
 public:
 	CTracerManager();
@@ -71,13 +42,39 @@ public:
 	void EmitTracer(const STracerParams &params);
 	void Update(float frameTime);
 	void Reset();
+	// spawns tracer_max_count tracer entities in advance
+	void Prewarm();
 	void GetMemoryStatistics(ICrySizer *);
 
 private:
-	TTracerPool			m_pool;
-	TTracerIdVector m_updating;
-	TTracerIdVector	m_actives;
-	int							m_lastFree;
+	static EntityId SpawnTracerEntity();
+
+	int AcquireTracer();
+	void ReleaseTracer(int idx);
+	void HideTracer(int idx);
+	void SetGeometry(int idx, const char *name);
+	void SetEffect(int idx, const char *name);
+
+	// tracer slots
+	std::vector<Vec3>			m_pos;
+	std::vector<Vec3>			m_dest;
+	std::vector<float>		m_speed;
+	std::vector<float>		m_age;
+	std::vector<float>		m_lifeTime;
+	std::vector<EntityId>	m_entityId;
+	std::vector<int>			m_geometrySlot;
+	std::vector<bool>			m_useGeometry;
+
+	// results of the update pass
+	std::vector<Vec3>			m_dir;
+	std::vector<float>		m_scale;
+
+	TTracerIdVector	m_free;			// stack of unused slots
+	TTracerIdVector	m_actives;	// ring buffer of active slots, oldest first
+	TTracerIdVector	m_finished;
+	int							m_activeHead;
+	int							m_activeCount;
+	int							m_capacity;
 };
 
 
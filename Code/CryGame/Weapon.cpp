@@ -30,6 +30,7 @@ History:
 #include "HUD/HUDCrosshair.h"
 #include "GameRules.h"
 #include "ItemParamReader.h"
+#include "ItemSharedParams.h"
 #include "Projectile.h"
 #include "OffHand.h"
 #include "Lam.h"
@@ -113,16 +114,21 @@ bool CWeapon::ReadItemParams(const IItemParamsNode* root)
 {
 	FUNCTION_PROFILER(GetISystem(), PROFILE_GAME);
 
+	// shared params become valid in CItem::ReadItemParams
+	const bool compile = !m_sharedparams->Valid();
+
 	if (!CItem::ReadItemParams(root))
 		return false;
 
 	// read params
-	string melee_attack_firemode;
-	const IItemParamsNode* params = root->GetChild("params");
+	if (compile)
 	{
+		const IItemParamsNode* params = root->GetChild("params");
 		CItemParamReader reader(params);
-		reader.Read("melee_attack_firemode", melee_attack_firemode);
+		m_sharedparams->meleeAttackFireMode.clear();
+		reader.Read("melee_attack_firemode", m_sharedparams->meleeAttackFireMode);
 	}
+	const string &melee_attack_firemode = m_sharedparams->meleeAttackFireMode;
 
 	const IItemParamsNode* firemodes = root->GetChild("firemodes");
 	InitFireModes(firemodes);
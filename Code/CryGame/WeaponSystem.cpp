@@ -11,13 +11,18 @@ History:
 
 *************************************************************************/
 #include "StdAfx.h"
+#include <condition_variable>
+#include <mutex>
 #include "Game.h"
+#include "GameCVars.h"
 #include "CryCommon/CryEntitySystem/IEntitySystem.h"
 #include "CryCommon/CrySystem/ICryPak.h"
 #include "CryCommon/CryScriptSystem/IScriptSystem.h"
 #include "CryCommon/CryAction/IGameObject.h"
 #include "Actor.h"
 #include "WeaponSystem.h"
+#include "Client/Client.h"
+#include "Client/Executor.h"
 
 #include "Projectile.h"
 #include "Bullet.h"
@@ -77,7 +82,6 @@ CWeaponSystem::CWeaponSystem(CGame *pGame, ISystem *pSystem)
 	m_pItemSystem(pGame->GetIGameFramework()->GetIItemSystem()),
 	m_pPrecache(0),
 	m_reloading(false),
-	m_recursing(false),
 	m_frozenEnvironment(false),
 	m_wetEnvironment(false),
 	m_tokensUpdated(false)
@@ -127,8 +131,7 @@ CWeaponSystem::CWeaponSystem(CGame *pGame, ISystem *pSystem)
 CWeaponSystem::~CWeaponSystem()
 {
 	// cleanup current projectiles
-	for (TProjectileMap::iterator pit = m_projectiles.begin(); pit != m_projectiles.end(); ++pit)
-		gEnv->pEntitySystem->RemoveEntity(pit->first, true);
+	RemoveAllProjectiles();
 
 	for (TAmmoTypeParams::iterator it = m_ammoparams.begin(); it != m_ammoparams.end(); ++it)
 	{
@@ -149,6 +152,7 @@ CWeaponSystem::~CWeaponSystem()
 void CWeaponSystem::Update(float frameTime)
 {
 	m_tracerManager.Update(frameTime);
+	m_rayBroker.Flush();
 	CheckEnvironmentChanges();
 }
 
@@ -164,15 +168,7 @@ void CWeaponSystem::Reload()
 	m_reloading = true;
 
 	// cleanup current projectiles
-	for (TProjectileMap::iterator pit = m_projectiles.begin(); pit != m_projectiles.end();)
-	{
-		//Bugfix: RemoveEntity removes projectile from map, thus invalidating iterator
-		TProjectileMap::iterator next = pit;        
-		next++;
-		gEnv->pEntitySystem->RemoveEntity(pit->first, true);
-		pit = next;
-	}
-	m_projectiles.clear();
+	RemoveAllProjectiles();
 
 	for (TAmmoTypeParams::iterator it = m_ammoparams.begin(); it != m_ammoparams.end(); ++it)
 	{
@@ -188,6 +184,7 @@ void CWeaponSystem::Reload()
 	m_ammoparams.clear();
 
 	m_tracerManager.Reset();
+	m_rayBroker.Reset();
 
 	for (TFolderList::iterator it=m_folders.begin(); it!=m_folders.end(); ++it)
 		Scan(it->c_str());
@@ -205,6 +202,9 @@ void CWeaponSystem::OnLoadingStart(ILevelInfo *pLevel)
 
 	// force shared item params to be refreshed
 	g_pGame->GetItemSharedParamsList()->Reset();
+
+	// queued rays refer to physical entities of the previous level
+	m_rayBroker.Reset();
 }
 
 //------------------------------------------------------------------------
@@ -364,60 +364,280 @@ const SAmmoParams* CWeaponSystem::GetAmmoParams(IEntityClass* pAmmoType) const
 //------------------------------------------------------------------------
 void CWeaponSystem::AddProjectile(IEntity *pEntity, CProjectile *pProjectile)
 {
-	m_projectiles.insert(TProjectileMap::value_type(pEntity->GetId(), pProjectile));
+	EntityId id=pEntity->GetId();
+	if (m_projectileIndex.find(id)!=m_projectileIndex.end())
+		return;
+
+	const Vec3 pos=pEntity->GetWorldPos();
+	int index=int(m_projectiles.size());
+
+	SProjectileEntry entry;
+	entry.pProjectile=pProjectile;
+	entry.id=id;
+	entry.pClass=pEntity->GetClass();
+	entry.cell=GetProjectileCell(GetProjectileCellCoord(pos.x), GetProjectileCellCoord(pos.y));
+
+	TProjectileSlots &classSlots=m_projectileClasses[entry.pClass];
+	entry.classSlot=int(classSlots.size());
+	classSlots.push_back(index);
+
+	TProjectileSlots &cellSlots=m_projectileCells[entry.cell];
+	entry.cellSlot=int(cellSlots.size());
+	cellSlots.push_back(index);
+
+	m_projectiles.push_back(entry);
+	m_projectileIndex.insert(TProjectileIndex::value_type(id, index));
 }
 
 //------------------------------------------------------------------------
 void CWeaponSystem::RemoveProjectile(CProjectile *pProjectile)
 {
-	m_projectiles.erase(pProjectile->GetEntity()->GetId());
+	TProjectileIndex::iterator it=m_projectileIndex.find(pProjectile->GetEntity()->GetId());
+	if (it==m_projectileIndex.end())
+		return;
+
+	int index=it->second;
+	m_projectileIndex.erase(it);
+
+	SProjectileEntry &entry=m_projectiles[index];
+	RemoveProjectileSlot(m_projectileClasses[entry.pClass], entry.classSlot, &SProjectileEntry::classSlot);
+	RemoveProjectileFromCell(entry);
+
+	// move the last projectile into the hole and fix up everything pointing at it
+	int last=int(m_projectiles.size())-1;
+	if (index!=last)
+	{
+		SProjectileEntry &moved=m_projectiles[last];
+		m_projectileClasses[moved.pClass][moved.classSlot]=index;
+		m_projectileCells[moved.cell][moved.cellSlot]=index;
+		m_projectileIndex[moved.id]=index;
+
+		m_projectiles[index]=moved;
+	}
+
+	m_projectiles.pop_back();
+}
+
+//------------------------------------------------------------------------
+void CWeaponSystem::MoveProjectile(CProjectile *pProjectile)
+{
+	IEntity *pEntity=pProjectile->GetEntity();
+
+	TProjectileIndex::iterator it=m_projectileIndex.find(pEntity->GetId());
+	if (it==m_projectileIndex.end())
+		return;
+
+	const Vec3 pos=pEntity->GetWorldPos();
+	uint32 cell=GetProjectileCell(GetProjectileCellCoord(pos.x), GetProjectileCellCoord(pos.y));
+
+	SProjectileEntry &entry=m_projectiles[it->second];
+	if (entry.cell==cell)
+		return;
+
+	RemoveProjectileFromCell(entry);
+
+	TProjectileSlots &cellSlots=m_projectileCells[cell];
+	entry.cell=cell;
+	entry.cellSlot=int(cellSlots.size());
+	cellSlots.push_back(it->second);
 }
 
 //------------------------------------------------------------------------
 CProjectile *CWeaponSystem::GetProjectile(EntityId entityId)
 {
-	TProjectileMap::iterator it = m_projectiles.find(entityId);
-	if (it != m_projectiles.end())
-		return it->second;
+	TProjectileIndex::iterator it = m_projectileIndex.find(entityId);
+	if (it != m_projectileIndex.end())
+		return m_projectiles[it->second].pProjectile;
 	return 0;
 }
 
 //------------------------------------------------------------------------
 int  CWeaponSystem::QueryProjectiles(SProjectileQuery& q)
 {
-    IEntityClass* pClass = q.ammoName?gEnv->pEntitySystem->GetClassRegistry()->FindClass(q.ammoName):0;
-    m_queryResults.resize(0);
-    if(q.box.IsEmpty())
-    {
-        for(TProjectileMap::iterator it = m_projectiles.begin();it!=m_projectiles.end();++it)
-        {
-            IEntity *pEntity = it->second->GetEntity();
-            if(pClass == 0 || pEntity->GetClass() == pClass)
-            m_queryResults.push_back(pEntity);
-        }
-    }
-    else
-    {
-        for(TProjectileMap::iterator it = m_projectiles.begin();it!=m_projectiles.end();++it)
-        {
-            IEntity *pEntity = it->second->GetEntity();
-            if(q.box.IsContainPoint(pEntity->GetWorldPos()))
-            {
-                m_queryResults.push_back(pEntity);
-            }
-        }
-    }
-    
-    q.nCount = int(m_queryResults.size());
-    if(q.nCount)
-        q.pResults = &m_queryResults[0];
-    return q.nCount;
+	m_queryResults.resize(0);
+	q.nCount = 0;
+
+	IEntityClass* pClass = 0;
+	const TProjectileSlots *pClassSlots = 0;
+	if (q.ammoName)
+	{
+		pClass = gEnv->pEntitySystem->GetClassRegistry()->FindClass(q.ammoName);
+		TProjectileClasses::const_iterator cit = m_projectileClasses.find(pClass);
+		if (!pClass || cit == m_projectileClasses.end())
+			return 0;
+
+		pClassSlots = &cit->second;
+	}
+
+	if(q.box.IsEmpty())
+	{
+		if (pClassSlots)
+		{
+			for (TProjectileSlots::const_iterator it = pClassSlots->begin(); it != pClassSlots->end(); ++it)
+				m_queryResults.push_back(m_projectiles[*it].pProjectile->GetEntity());
+		}
+		else
+		{
+			for (TProjectiles::const_iterator it = m_projectiles.begin(); it != m_projectiles.end(); ++it)
+				m_queryResults.push_back(it->pProjectile->GetEntity());
+		}
+	}
+	else
+	{
+		int x0 = GetProjectileCellCoord(q.box.min.x);
+		int y0 = GetProjectileCellCoord(q.box.min.y);
+		int x1 = GetProjectileCellCoord(q.box.max.x);
+		int y1 = GetProjectileCellCoord(q.box.max.y);
+
+		int64 cellCount = int64(x1 - x0 + 1) * int64(y1 - y0 + 1);
+		size_t candidateCount = pClassSlots ? pClassSlots->size() : m_projectiles.size();
+
+		if (cellCount > int64(candidateCount))
+		{
+			// box covers more cells than there are projectiles to test
+			for (size_t i = 0; i < candidateCount; ++i)
+			{
+				IEntity *pEntity = m_projectiles[pClassSlots ? (*pClassSlots)[i] : int(i)].pProjectile->GetEntity();
+				if (q.box.IsContainPoint(pEntity->GetWorldPos()))
+					m_queryResults.push_back(pEntity);
+			}
+		}
+		else
+		{
+			for (int y = y0; y <= y1; ++y)
+			{
+				for (int x = x0; x <= x1; ++x)
+				{
+					TProjectileCells::const_iterator cit = m_projectileCells.find(GetProjectileCell(x, y));
+					if (cit == m_projectileCells.end())
+						continue;
+
+					for (TProjectileSlots::const_iterator it = cit->second.begin(); it != cit->second.end(); ++it)
+					{
+						const SProjectileEntry &entry = m_projectiles[*it];
+						if (pClass && entry.pClass != pClass)
+							continue;
+
+						IEntity *pEntity = entry.pProjectile->GetEntity();
+						if (q.box.IsContainPoint(pEntity->GetWorldPos()))
+							m_queryResults.push_back(pEntity);
+					}
+				}
+			}
+		}
+	}
+
+	q.nCount = int(m_queryResults.size());
+	if(q.nCount)
+		q.pResults = &m_queryResults[0];
+	return q.nCount;
+}
+
+//------------------------------------------------------------------------
+int CWeaponSystem::GetProjectileCellCoord(float v)
+{
+	// coarse enough that a projectile rarely changes cell within a frame
+	const float cellSize = 32.0f;
+
+	return int(floor_tpl(v * (1.0f / cellSize)));
+}
+
+//------------------------------------------------------------------------
+uint32 CWeaponSystem::GetProjectileCell(int x, int y)
+{
+	return uint32(uint16(x)) | (uint32(uint16(y)) << 16);
+}
+
+//------------------------------------------------------------------------
+void CWeaponSystem::RemoveProjectileSlot(TProjectileSlots &slots, int slot, int SProjectileEntry::*pSlot)
+{
+	int moved = slots.back();
+	slots[slot] = moved;
+	m_projectiles[moved].*pSlot = slot;
+	slots.pop_back();
+}
+
+//------------------------------------------------------------------------
+void CWeaponSystem::RemoveProjectileFromCell(const SProjectileEntry &entry)
+{
+	TProjectileCells::iterator it = m_projectileCells.find(entry.cell);
+	assert(it != m_projectileCells.end());
+
+	RemoveProjectileSlot(it->second, entry.cellSlot, &SProjectileEntry::cellSlot);
+
+	// projectiles cross many cells, so empty ones are not kept around
+	if (it->second.empty())
+		m_projectileCells.erase(it);
+}
+
+//------------------------------------------------------------------------
+void CWeaponSystem::RemoveAllProjectiles()
+{
+	// removing an entity removes its projectile from the containers
+	std::vector<EntityId> ids;
+	ids.reserve(m_projectiles.size());
+	for (TProjectiles::const_iterator it = m_projectiles.begin(); it != m_projectiles.end(); ++it)
+		ids.push_back(it->id);
+
+	for (std::vector<EntityId>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+		gEnv->pEntitySystem->RemoveEntity(*it, true);
+
+	m_projectiles.clear();
+	m_projectileIndex.clear();
+	m_projectileClasses.clear();
+	m_projectileCells.clear();
 }
 
 //------------------------------------------------------------------------
 void CWeaponSystem::Scan(const char *folderName)
 {
-	string folder = folderName;
+	CryLog("Loading ammo XML definitions from '%s'!", folderName);
+
+	ITimer *pTimer = gEnv->pTimer;
+	const CTimeValue startTime = pTimer->GetAsyncTime();
+
+	// find all files first, so they can be read ahead and registered in a stable order
+	TXmlFiles files;
+	FindXmlFiles(folderName, files);
+
+	const CTimeValue findTime = pTimer->GetAsyncTime();
+
+	LoadXmlFiles(files);
+
+	const CTimeValue loadTime = pTimer->GetAsyncTime();
+
+	// registration touches the entity and item systems, so it stays on the main thread
+	int count = 0;
+	for (TXmlFiles::iterator it = files.begin(); it != files.end(); ++it)
+	{
+		if (!it->root)
+		{
+			GameWarning("Invalid XML file '%s'! Skipping...", it->path.c_str());
+			continue;
+		}
+
+		if (ScanXML(it->root, it->path.c_str()))
+			++count;
+
+		it->root = 0;
+	}
+
+	const CTimeValue endTime = pTimer->GetAsyncTime();
+
+	CryLog("Finished loading ammo XML definitions from '%s'!", folderName);
+	CryLog("Registered %d of %d ammo XML files: find %.1f ms, read and parse %.1f ms, register %.1f ms",
+		count, (int)files.size(),
+		(findTime - startTime).GetMilliSeconds(),
+		(loadTime - findTime).GetMilliSeconds(),
+		(endTime - loadTime).GetMilliSeconds());
+
+	if (!m_reloading)
+		m_folders.push_back(folderName);
+}
+
+//------------------------------------------------------------------------
+void CWeaponSystem::FindXmlFiles(const string &folder, TXmlFiles &files)
+{
 	string search = folder;
 	search += "/*.*";
 
@@ -426,9 +646,6 @@ void CWeaponSystem::Scan(const char *folderName)
 	_finddata_t fd;
 	intptr_t handle = pPak->FindFirst(search.c_str(), &fd);
 
-	if (!m_recursing)
-		CryLog("Loading ammo XML definitions from '%s'!", folderName);
-
 	if (handle > -1)
 	{
 		do
@@ -438,41 +655,99 @@ void CWeaponSystem::Scan(const char *folderName)
 
 			if (fd.attrib & _A_SUBDIR)
 			{
-				string subName = folder+"/"+fd.name;
-				if (m_recursing)
-					Scan(subName.c_str());
-				else
-				{
-					m_recursing=true;
-					Scan(subName.c_str());
-					m_recursing=false;
-				}
+				FindXmlFiles(folder+"/"+fd.name, files);
 				continue;
 			}
 
 			if (stricmp(PathUtil::GetExt(fd.name), "xml"))
 				continue;
 
-			string xmlFile = folder + string("/") + string(fd.name);
-			XmlNodeRef rootNode = m_pSystem->LoadXmlFile(xmlFile.c_str());
+			SXmlFile file;
+			file.path = folder + string("/") + string(fd.name);
+			files.push_back(file);
 
-			if (!rootNode)
+		} while (pPak->FindNext(handle, &fd) >= 0);
+
+		pPak->FindClose(handle);
+	}
+}
+
+//------------------------------------------------------------------------
+static void ReadXmlFile(ICryPak *pPak, const string &path, std::string &content)
+{
+	FILE *pFile = pPak->FOpen(path.c_str(), "rb");
+	if (!pFile)
+		return;
+
+	const size_t size = pPak->FGetSize(pFile);
+	content.resize(size);
+	if (size && pPak->FReadRawAll(&content[0], size, pFile) != size)
+		content.clear();
+
+	pPak->FClose(pFile);
+}
+
+//------------------------------------------------------------------------
+void CWeaponSystem::LoadXmlFiles(TXmlFiles &files)
+{
+	struct SReadState
+	{
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::vector<bool> isRead;
+		size_t nextRead = 0;
+	};
+
+	std::shared_ptr<SReadState> pState = std::make_shared<SReadState>();
+	pState->isRead.resize(files.size());
+
+	ICryPak *pPak = m_pSystem->GetIPak();
+
+	// the executor reads ahead while the main thread parses, the XML parser is only used here
+	// the worker may start late or not at all, everything it has not claimed is read below
+	gClient->GetExecutor()->RunAsync([pState, pPak, &files]()
+	{
+		for (;;)
+		{
+			size_t i;
 			{
-				GameWarning("Invalid XML file '%s'! Skipping...", xmlFile.c_str());
-				continue;
+				std::lock_guard<std::mutex> lock(pState->mutex);
+				if (pState->nextRead >= files.size())
+					break;
+
+				i = pState->nextRead++;
 			}
 
-			if (!ScanXML(rootNode, xmlFile.c_str()))
-				continue;
+			ReadXmlFile(pPak, files[i].path, files[i].content);
 
-		} while (pPak->FindNext(handle, &fd) >= 0);
-	}
+			std::lock_guard<std::mutex> lock(pState->mutex);
+			pState->isRead[i] = true;
+			pState->cv.notify_all();
+		}
+	});
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		std::unique_lock<std::mutex> lock(pState->mutex);
 
-	if (!m_recursing)
-		CryLog("Finished loading ammo XML definitions from '%s'!", folderName);
+		if (pState->nextRead == i)
+		{
+			pState->nextRead++;
+			lock.unlock();
 
-	if (!m_reloading && !m_recursing)
-		m_folders.push_back(folderName);
+			ReadXmlFile(pPak, files[i].path, files[i].content);
+		}
+		else
+		{
+			pState->cv.wait(lock, [&pState, i]() { return pState->isRead[i]; });
+			lock.unlock();
+		}
+
+		if (!files[i].content.empty())
+			files[i].root = m_pSystem->LoadXmlFromString(files[i].content.c_str());
+
+		std::string().swap(files[i].content);
+	}
 }
 
 //------------------------------------------------------------------------
@@ -713,6 +988,7 @@ void CWeaponSystem::GetMemoryStatistics(ICrySizer * s)
 	s->AddObject(this,nSize);
 
 	m_tracerManager.GetMemoryStatistics(s);
+	m_rayBroker.GetMemoryStatistics(s);
 	s->AddContainer(m_fmregistry);
 	s->AddContainer(m_zmregistry);
 	s->AddContainer(m_projectileregistry);
@@ -739,10 +1015,19 @@ void CWeaponSystem::GetMemoryStatistics(ICrySizer * s)
 	
 	{
 		SIZER_SUBCOMPONENT_NAME(s, "Projectiles");
-		int nSize = m_projectiles.size() * sizeof(TProjectileMap::value_type);
-		for (TProjectileMap::iterator iter = m_projectiles.begin(); iter != m_projectiles.end(); ++iter)
+		int nSize = m_projectiles.capacity() * sizeof(SProjectileEntry);
+		nSize += m_projectileIndex.size() * sizeof(TProjectileIndex::value_type);
+		for (TProjectiles::iterator iter = m_projectiles.begin(); iter != m_projectiles.end(); ++iter)
+		{
+			nSize += iter->pProjectile->GetMemorySize();
+		}
+		for (TProjectileClasses::iterator iter = m_projectileClasses.begin(); iter != m_projectileClasses.end(); ++iter)
+		{
+			nSize += sizeof(TProjectileClasses::value_type) + iter->second.capacity() * sizeof(int);
+		}
+		for (TProjectileCells::iterator iter = m_projectileCells.begin(); iter != m_projectileCells.end(); ++iter)
 		{
-			nSize += iter->second->GetMemorySize();
+			nSize += sizeof(TProjectileCells::value_type) + iter->second.capacity() * sizeof(int);
 		}
 		s->AddObject(&m_projectiles,nSize);
 	}
@@ -19,12 +19,15 @@ History:
 #endif
 
 
+#include <unordered_map>
+
 #include "CryCommon/CryAction/IItemSystem.h"
 #include "CryCommon/CryAction/ILevelSystem.h"
 #include "CryCommon/CryAction/IWeapon.h"
 #include "CryCommon/CryGame/IGameTokens.h"
 #include "Item.h"
 #include "TracerManager.h"
+#include "RayBroker.h"
 #include "CryCommon/CryCore/VectorMap.h"
 #include "AmmoParams.h"
 
@@ -58,9 +61,30 @@ class CWeaponSystem : public ILevelSystemListener
 	typedef std::map<string, IFireMode		*(*)()>								TFireModeRegistry;
 	typedef std::map<string, IZoomMode		*(*)()>								TZoomModeRegistry;
 	typedef std::map<string, IGameObjectExtensionCreatorBase *>	TProjectileRegistry;
-	typedef std::map<EntityId, CProjectile *>										TProjectileMap;
+	struct SProjectileEntry
+	{
+		CProjectile		*pProjectile;
+		EntityId			id;
+		IEntityClass	*pClass;
+		uint32				cell;				// key of the grid cell
+		int						classSlot;	// position in the class bucket
+		int						cellSlot;		// position in the cell bucket
+	};
+
+	typedef std::vector<SProjectileEntry>												TProjectiles;
+	typedef std::unordered_map<EntityId, int>										TProjectileIndex;
+	typedef std::vector<int>																		TProjectileSlots;
+	typedef std::map<IEntityClass*, TProjectileSlots>						TProjectileClasses;
+	typedef std::unordered_map<uint32, TProjectileSlots>				TProjectileCells;
 	typedef VectorMap<IEntityClass*, SAmmoTypeDesc>							TAmmoTypeParams;
 	typedef std::vector<string>																	TFolderList;
+	struct SXmlFile
+	{
+		string				path;
+		std::string		content;
+		XmlNodeRef		root;
+	};
+	typedef std::vector<SXmlFile>																TXmlFiles;
 	typedef std::vector<IEntity*>																TIEntityVector;
 
 public:
@@ -98,10 +122,12 @@ public:
 
 	void AddProjectile(IEntity *pEntity, CProjectile *pProjectile);
 	void RemoveProjectile(CProjectile *pProjectile);
+	void MoveProjectile(CProjectile *pProjectile);
 	CProjectile *GetProjectile(EntityId entityId);
 	int	QueryProjectiles(SProjectileQuery& q);
 
 	CTracerManager &GetTracerManager() { return m_tracerManager; };
+	CRayBroker &GetRayBroker() { return m_rayBroker; };
 
 	void Scan(const char *folderName);
 	bool ScanXML(XmlNodeRef &root, const char *xmlFile);
@@ -120,22 +146,34 @@ public:
 	void Serialize(TSerialize ser);
 
 private: 
+	static uint32 GetProjectileCell(int x, int y);
+	static int GetProjectileCellCoord(float v);
+	void RemoveProjectileSlot(TProjectileSlots &slots, int slot, int SProjectileEntry::*pSlot);
+	void RemoveProjectileFromCell(const SProjectileEntry &entry);
+	void RemoveAllProjectiles();
+	void FindXmlFiles(const string &folder, TXmlFiles &files);
+	void LoadXmlFiles(TXmlFiles &files);
 
 	CGame								*m_pGame;
 	ISystem							*m_pSystem;
 	IItemSystem					*m_pItemSystem;
 
 	CTracerManager			m_tracerManager;
+	CRayBroker					m_rayBroker;
 
 	TFireModeRegistry		m_fmregistry;
 	TZoomModeRegistry		m_zmregistry;
 	TProjectileRegistry	m_projectileregistry;
 	TAmmoTypeParams			m_ammoparams;
-	TProjectileMap			m_projectiles;
+
+	// dense array of live projectiles, bucketed by ammo class and by a coarse grid for queries
+	TProjectiles				m_projectiles;
+	TProjectileIndex		m_projectileIndex;
+	TProjectileClasses	m_projectileClasses;
+	TProjectileCells		m_projectileCells;
 
 	TFolderList					m_folders;
 	bool								m_reloading;
-	bool								m_recursing;
 
 	string							m_config;
 
@@ -34,7 +34,7 @@ bool FunctionHandler::GetSelfAny(ScriptAnyValue & any)
 {
 	if (m_paramIdOffset > 0)
 	{
-		return m_pSS->ToAny(any, 1);
+		return m_pSS->ToAny(m_L, any, 1);
 	}
 	else
 	{
@@ -64,7 +64,7 @@ bool FunctionHandler::GetParamAny(int index, ScriptAnyValue & any)
 {
 	const int realIndex = index + m_paramIdOffset;
 
-	if (m_pSS->ToAny(any, realIndex))
+	if (m_pSS->ToAny(m_L, any, realIndex))
 	{
 		return true;
 	}
@@ -85,7 +85,7 @@ bool FunctionHandler::GetParamAny(int index, ScriptAnyValue & any)
 
 int FunctionHandler::EndFunctionAny(const ScriptAnyValue & any)
 {
-	m_pSS->PushAny(any);
+	m_pSS->PushAny(m_L, any);
 
 	if (any.type == ANY_TNIL || any.type == ANY_ANY)
 		return 0;
@@ -95,17 +95,17 @@ int FunctionHandler::EndFunctionAny(const ScriptAnyValue & any)
 
 int FunctionHandler::EndFunctionAny(const ScriptAnyValue & any1, const ScriptAnyValue & any2)
 {
-	m_pSS->PushAny(any1);
-	m_pSS->PushAny(any2);
+	m_pSS->PushAny(m_L, any1);
+	m_pSS->PushAny(m_L, any2);
 
 	return 2;
 }
 
 int FunctionHandler::EndFunctionAny(const ScriptAnyValue & any1, const ScriptAnyValue & any2, const ScriptAnyValue & any3)
 {
-	m_pSS->PushAny(any1);
-	m_pSS->PushAny(any2);
-	m_pSS->PushAny(any3);
+	m_pSS->PushAny(m_L, any1);
+	m_pSS->PushAny(m_L, any2);
+	m_pSS->PushAny(m_L, any3);
 
 	return 3;
 }
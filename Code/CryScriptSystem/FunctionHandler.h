@@ -18,6 +18,11 @@ public:
 	{
 	}
 
+	lua_State *GetLuaState()
+	{
+		return m_L;
+	}
+
 	IScriptSystem *GetIScriptSystem() override;
 
 	void *GetThis() override;
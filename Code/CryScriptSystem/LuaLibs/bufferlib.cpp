@@ -0,0 +1,191 @@
+#include <new>
+#include <string_view>
+
+extern "C"
+{
+#include "Library/External/Lua/src/lauxlib.h"
+}
+
+#include "bufferlib.h"
+
+#define BUFFER_METATABLE "ScriptBuffer"
+
+struct Buffer
+{
+	std::shared_ptr<const std::string> data;
+	size_t offset = 0;
+	size_t length = 0;
+
+	std::string_view view() const
+	{
+		return std::string_view(data->data() + offset, length);
+	}
+};
+
+static void push_buffer(lua_State *L, std::shared_ptr<const std::string> data, size_t offset, size_t length)
+{
+	Buffer *buffer = new (lua_newuserdata(L, sizeof (Buffer))) Buffer;
+
+	buffer->data = std::move(data);
+	buffer->offset = offset;
+	buffer->length = length;
+
+	luaL_getmetatable(L, BUFFER_METATABLE);
+	lua_setmetatable(L, -2);
+}
+
+static Buffer *check_buffer(lua_State *L, int index)
+{
+	return static_cast<Buffer*>(luaL_checkudata(L, index, BUFFER_METATABLE));
+}
+
+// same as in the Lua string library
+static ptrdiff_t pos_relative(ptrdiff_t pos, size_t length)
+{
+	if (pos < 0)
+		pos += (ptrdiff_t) length + 1;
+
+	return (pos >= 0) ? pos : 0;
+}
+
+static int buffer_len(lua_State *L)
+{
+	Buffer *buffer = check_buffer(L, 1);
+
+	lua_pushinteger(L, (lua_Integer) buffer->length);
+
+	return 1;
+}
+
+static int buffer_sub(lua_State *L)
+{
+	Buffer *buffer = check_buffer(L, 1);
+
+	ptrdiff_t first = pos_relative(luaL_checkinteger(L, 2), buffer->length);
+	ptrdiff_t last = pos_relative(luaL_optinteger(L, 3, -1), buffer->length);
+
+	if (first < 1)
+		first = 1;
+
+	if (last > (ptrdiff_t) buffer->length)
+		last = (ptrdiff_t) buffer->length;
+
+	if (first <= last)
+		push_buffer(L, buffer->data, buffer->offset + first - 1, last - first + 1);
+	else
+		push_buffer(L, buffer->data, buffer->offset, 0);
+
+	return 1;
+}
+
+static int buffer_find(lua_State *L)
+{
+	Buffer *buffer = check_buffer(L, 1);
+
+	size_t textLength = 0;
+	const char *text = luaL_checklstring(L, 2, &textLength);
+
+	ptrdiff_t init = pos_relative(luaL_optinteger(L, 3, 1), buffer->length);
+
+	if (init < 1)
+		init = 1;
+
+	if (init > (ptrdiff_t) buffer->length + 1)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	const size_t pos = buffer->view().find(std::string_view(text, textLength), init - 1);
+
+	if (pos == std::string_view::npos)
+	{
+		lua_pushnil(L);
+		return 1;
+	}
+
+	lua_pushinteger(L, (lua_Integer) (pos + 1));
+	lua_pushinteger(L, (lua_Integer) (pos + textLength));
+
+	return 2;
+}
+
+static int buffer_byte(lua_State *L)
+{
+	Buffer *buffer = check_buffer(L, 1);
+
+	const ptrdiff_t pos = pos_relative(luaL_optinteger(L, 2, 1), buffer->length);
+
+	if (pos < 1 || pos > (ptrdiff_t) buffer->length)
+		return 0;
+
+	lua_pushinteger(L, (unsigned char) buffer->view()[pos - 1]);
+
+	return 1;
+}
+
+static int buffer_tostring(lua_State *L)
+{
+	Buffer *buffer = check_buffer(L, 1);
+
+	const std::string_view content = buffer->view();
+
+	lua_pushlstring(L, content.data(), content.length());
+
+	return 1;
+}
+
+static int buffer_gc(lua_State *L)
+{
+	Buffer *buffer = check_buffer(L, 1);
+
+	buffer->~Buffer();
+
+	return 0;
+}
+
+static const struct luaL_reg buffer_methods[] = {
+	{ "len",        buffer_len      },
+	{ "sub",        buffer_sub      },
+	{ "find",       buffer_find     },
+	{ "byte",       buffer_byte     },
+	{ "tostring",   buffer_tostring },
+	{ NULL, NULL }
+};
+
+static const struct luaL_reg buffer_metamethods[] = {
+	{ "__len",      buffer_len      },
+	{ "__tostring", buffer_tostring },
+	{ "__gc",       buffer_gc       },
+	{ NULL, NULL }
+};
+
+int lua_bufferlib_init(lua_State *L)
+{
+	luaL_newmetatable(L, BUFFER_METATABLE);
+
+	luaL_openlib(L, NULL, buffer_metamethods, 0);
+
+	// methods are in their own table, so scripts cannot call __gc themselves
+	lua_newtable(L);
+	luaL_openlib(L, NULL, buffer_methods, 0);
+	lua_setfield(L, -2, "__index");
+
+	// getmetatable returns this instead of the metatable and setmetatable fails
+	lua_pushliteral(L, BUFFER_METATABLE);
+	lua_setfield(L, -2, "__metatable");
+
+	lua_pop(L, 1);
+
+	return 0;
+}
+
+void lua_pushbuffer(lua_State *L, std::shared_ptr<const std::string> data)
+{
+	const size_t length = data ? data->length() : 0;
+
+	if (!data)
+		data = std::make_shared<const std::string>();
+
+	push_buffer(L, std::move(data), 0, length);
+}
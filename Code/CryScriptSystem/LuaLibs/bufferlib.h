@@ -0,0 +1,22 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+extern "C"
+{
+#include "Library/External/Lua/src/lua.h"
+}
+
+// Read-only byte buffer shared with native code without copying it into a Lua string.
+//
+// Lua API:
+//   buf:len() or #buf             -- length in bytes
+//   buf:sub(i [, j])              -- slice with string.sub indexing, shares the same memory
+//   buf:find(text [, init])       -- plain search, returns start and end index or nil
+//   buf:byte([i])                 -- byte value at index
+//   buf:tostring() or tostring(buf)  -- copies the content into a Lua string
+
+int lua_bufferlib_init(lua_State *L);
+
+void lua_pushbuffer(lua_State *L, std::shared_ptr<const std::string> data);
@@ -4,12 +4,18 @@
 #include "ScriptBind_Script.h"
 #include "../ScriptSystem.h"
 #include "../ScriptTimerManager.h"
+#include "../ScriptScheduler.h"
 
 ScriptTimerManager *ScriptBind_Script::GetTimerManager()
 {
 	return static_cast<CScriptSystem*>(m_pSS)->GetScriptTimerManager();
 }
 
+ScriptScheduler *ScriptBind_Script::GetScheduler()
+{
+	return static_cast<CScriptSystem*>(m_pSS)->GetScriptScheduler();
+}
+
 ScriptBind_Script::ScriptBind_Script(ISystem *pSystem, IScriptSystem *pSS)
 {
 	CScriptableBase::Init(pSS, pSystem);
@@ -27,6 +33,8 @@ ScriptBind_Script::ScriptBind_Script(ISystem *pSystem, IScriptSystem *pSS)
 	SCRIPT_REG_TEMPLFUNC(SetTimer, "nMilliseconds, Function");
 	SCRIPT_REG_TEMPLFUNC(SetTimerForFunction, "nMilliseconds, Function");
 	SCRIPT_REG_TEMPLFUNC(KillTimer, "nTimerId");
+	SCRIPT_REG_FUNC(Async);
+	SCRIPT_REG_TEMPLFUNC(Sleep, "nMilliseconds");
 }
 
 int ScriptBind_Script::LoadScript(IFunctionHandler *pH)
@@ -144,3 +152,26 @@ int ScriptBind_Script::KillTimer(IFunctionHandler *pH, ScriptHandle nTimerId)
 
 	return pH->EndFunction();
 }
+
+int ScriptBind_Script::Async(IFunctionHandler *pH)
+{
+	return GetScheduler()->Spawn(pH);
+}
+
+int ScriptBind_Script::Sleep(IFunctionHandler *pH, int nMilliseconds)
+{
+	if (nMilliseconds < 0)
+		nMilliseconds = 0;
+
+	const ScriptWaitID waitID = GetScheduler()->Suspend(pH);
+	if (!waitID)
+		return pH->EndFunction(false);
+
+	if (!GetTimerManager()->AddWakeUpTimer(nMilliseconds, waitID))
+	{
+		GetScheduler()->Cancel(waitID);
+		return pH->EndFunction(false);
+	}
+
+	return GetScheduler()->YieldCoroutine(pH);
+}
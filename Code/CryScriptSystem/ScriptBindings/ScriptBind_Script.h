@@ -3,10 +3,12 @@
 #include "CryCommon/CryScriptSystem/IScriptSystem.h"
 
 class ScriptTimerManager;
+class ScriptScheduler;
 
 class ScriptBind_Script : public CScriptableBase
 {
 	ScriptTimerManager *GetTimerManager();
+	ScriptScheduler *GetScheduler();
 
 public:
 	ScriptBind_Script(ISystem *pSystem, IScriptSystem *pSS);
@@ -79,4 +81,18 @@ public:
 	//! <description>Stops a timer set by the Script.SetTimer function.</description>
 	//! <param name="nTimerId">ID of the timer returned by the Script.SetTimer function.</param>
 	int KillTimer(IFunctionHandler *pH, ScriptHandle nTimerId);
+
+	//! <code>Script.Async( luaFunction [, ...] )</code>
+	//! <description>
+	//!    Runs a lua function as a coroutine. The function can wait for native asynchronous calls,
+	//!    such as Script.Sleep or CPPAPI.AwaitRequest, without blocking the caller.
+	//! </description>
+	//! <param name="luaFunction">Function to run, the remaining parameters are passed to it.</param>
+	int Async(IFunctionHandler *pH);
+
+	//! <code>Script.Sleep( nMilliseconds )</code>
+	//! <description>Suspends the calling coroutine started by Script.Async.</description>
+	//! <param name="nMilliseconds">Delay in milliseconds.</param>
+	//! <returns>True once the delay has passed or false if not called from a coroutine.</returns>
+	int Sleep(IFunctionHandler *pH, int nMilliseconds);
 };
@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <algorithm>
+
+#include "CryCommon/CrySystem/ISystem.h"
+#include "CryCommon/CrySystem/ITimer.h"
+#include "CryCommon/CrySystem/ICryPak.h"
+
+#include "ScriptProfiler.h"
+#include "ScriptSystem.h"
+
+namespace
+{
+	uint64_t GetCurrentTime()
+	{
+		return gEnv->pTimer->GetAsyncTime().GetMilliSecondsAsInt64();
+	}
+
+	// flame graph tools split frames by ';' and the count by the last space
+	void AppendFrame(std::string & stack, const std::string & name, const std::string & location)
+	{
+		if (!stack.empty())
+			stack += ';';
+
+		const size_t begin = stack.length();
+
+		stack += name;
+		stack += '@';
+		stack += location;
+
+		std::replace(stack.begin() + begin, stack.end(), ';', ':');
+		std::replace(stack.begin() + begin, stack.end(), ' ', '_');
+	}
+}
+
+void ScriptProfiler::HookWrapper(lua_State *L, lua_Debug *ar)
+{
+	ScriptProfiler *pProfiler = static_cast<CScriptSystem*>(gEnv->pScriptSystem)->GetScriptProfiler();
+
+	// coroutines created while running inherit the hook, Stop only removes it from the main state
+	if (!pProfiler->m_isRunning)
+	{
+		lua_sethook(L, nullptr, 0, 0);
+		return;
+	}
+
+	if (ar->event == LUA_HOOKCOUNT)
+	{
+		pProfiler->OnSample(L);
+	}
+}
+
+ScriptProfiler::FunctionStats & ScriptProfiler::GetFunction(lua_Debug & ar, FunctionKey & key)
+{
+	key.source = ar.source;
+	key.line = ar.linedefined;
+
+	const auto [it, added] = m_functions.try_emplace(key);
+	FunctionStats & stats = it->second;
+
+	if (added)
+	{
+		char location[LUA_IDSIZE + 16];
+		sprintf(location, "%s:%d", ar.short_src, ar.linedefined);
+
+		stats.location = location;
+
+		if (ar.name)
+			stats.name = ar.name;
+		else if (*ar.what == 'm')
+			stats.name = "(main)";
+		else
+			stats.name = "(anonymous)";
+	}
+
+	return stats;
+}
+
+void ScriptProfiler::OnSample(lua_State *L)
+{
+	if (m_isInHook)
+		return;
+
+	m_isInHook = true;
+
+	m_sampleKeys.clear();
+	m_sampleStack.clear();
+
+	// collect the stack from the leaf to the root
+	lua_Debug ar;
+	int level = 0;
+	while (level < MAX_STACK_DEPTH && lua_getstack(L, level, &ar))
+	{
+		lua_getinfo(L, "Sn", &ar);
+
+		FunctionKey key;
+		FunctionStats & stats = GetFunction(ar, key);
+
+		if (level == 0)
+			stats.selfSamples++;
+
+		// recursive functions are counted only once per sample
+		if (std::find(m_sampleKeys.begin(), m_sampleKeys.end(), key) == m_sampleKeys.end())
+			stats.totalSamples++;
+
+		m_sampleKeys.push_back(key);
+
+		level++;
+	}
+
+	// collapsed stacks go from the root to the leaf
+	for (auto it = m_sampleKeys.rbegin(); it != m_sampleKeys.rend(); ++it)
+	{
+		const FunctionStats & stats = m_functions[*it];
+
+		AppendFrame(m_sampleStack, stats.name, stats.location);
+	}
+
+	if (!m_sampleStack.empty())
+		m_stacks[m_sampleStack]++;
+
+	m_sampleCount++;
+
+	m_isInHook = false;
+}
+
+ScriptProfiler::ScriptProfiler()
+{
+}
+
+ScriptProfiler::~ScriptProfiler()
+{
+	Stop();
+}
+
+void ScriptProfiler::Start(lua_State *L, int period)
+{
+	if (m_isRunning)
+		Stop();
+
+	if (period <= 0)
+		period = DEFAULT_PERIOD;
+
+	Clear();
+
+	m_L = L;
+	m_period = period;
+	m_startTime = GetCurrentTime();
+	m_stopTime = 0;
+	m_isRunning = true;
+
+	lua_sethook(m_L, HookWrapper, LUA_MASKCOUNT, m_period);
+
+	CryLogAlways("[ScriptProfiler] Started with period of %d instructions", m_period);
+}
+
+void ScriptProfiler::Stop()
+{
+	if (!m_isRunning)
+		return;
+
+	lua_sethook(m_L, nullptr, 0, 0);
+
+	m_isRunning = false;
+	m_stopTime = GetCurrentTime();
+
+	CryLogAlways("[ScriptProfiler] Stopped after %llu samples", m_sampleCount);
+}
+
+void ScriptProfiler::Clear()
+{
+	m_functions.clear();
+	m_stacks.clear();
+	m_sampleCount = 0;
+}
+
+void ScriptProfiler::OnAllocSlow(lua_State *L, size_t bytes)
+{
+	// the allocator can be called from inside the hook
+	if (m_isInHook)
+		return;
+
+	lua_Debug ar;
+	if (!lua_getstack(L, 0, &ar))
+		return;
+
+	m_isInHook = true;
+
+	lua_getinfo(L, "Sn", &ar);
+
+	FunctionKey key;
+	FunctionStats & stats = GetFunction(ar, key);
+
+	stats.allocBytes += bytes;
+	stats.allocCount++;
+
+	m_isInHook = false;
+}
+
+void ScriptProfiler::LogReport(unsigned int maxCount)
+{
+	std::vector<const FunctionStats*> functions;
+	functions.reserve(m_functions.size());
+
+	for (const auto & [key, stats] : m_functions)
+	{
+		functions.push_back(&stats);
+	}
+
+	std::sort(functions.begin(), functions.end(), [](const FunctionStats *a, const FunctionStats *b)
+	{
+		if (a->selfSamples != b->selfSamples)
+			return a->selfSamples > b->selfSamples;
+		else
+			return a->allocBytes > b->allocBytes;
+	});
+
+	if (functions.size() > maxCount)
+		functions.resize(maxCount);
+
+	const uint64_t duration = (m_isRunning ? GetCurrentTime() : m_stopTime) - m_startTime;
+	const double sampleCount = m_sampleCount ? m_sampleCount : 1;
+
+	CryLogAlways("[ScriptProfiler] %llu samples in %llu ms, period %d instructions%s",
+	             m_sampleCount, duration, m_period, m_isRunning ? " (running)" : "");
+	CryLogAlways("   Self%%  Total%%   Alloc KiB   Allocs  Function");
+
+	for (const FunctionStats *pStats : functions)
+	{
+		CryLogAlways("%7.2f %7.2f %11.1f %8llu  %s (%s)",
+		             pStats->selfSamples * 100.0 / sampleCount,
+		             pStats->totalSamples * 100.0 / sampleCount,
+		             pStats->allocBytes / 1024.0,
+		             pStats->allocCount,
+		             pStats->name.c_str(),
+		             pStats->location.c_str());
+	}
+}
+
+bool ScriptProfiler::ExportCollapsedStacks(const char *fileName)
+{
+	FILE *file = fxopen(fileName, "wt");
+	if (!file)
+	{
+		CryLogWarning("[ScriptProfiler] Failed to open %s", fileName);
+		return false;
+	}
+
+	for (const auto & [stack, samples] : m_stacks)
+	{
+		fprintf(file, "%s %llu\n", stack.c_str(), samples);
+	}
+
+	fclose(file);
+
+	CryLogAlways("[ScriptProfiler] Exported %u stacks to %s", static_cast<unsigned int>(m_stacks.size()), fileName);
+
+	return true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern "C"
+{
+#include "Library/External/Lua/src/lua.h"
+}
+
+class ScriptProfiler
+{
+	// function identity is the chunk name pointer and the line where the function is defined
+	struct FunctionKey
+	{
+		const void *source = nullptr;
+		int line = 0;
+
+		bool operator==(const FunctionKey & other) const
+		{
+			return source == other.source && line == other.line;
+		}
+	};
+
+	struct FunctionKeyHash
+	{
+		size_t operator()(const FunctionKey & key) const
+		{
+			return std::hash<const void*>()(key.source) ^ (static_cast<size_t>(key.line) * 0x9E3779B1);
+		}
+	};
+
+	struct FunctionStats
+	{
+		std::string name;
+		std::string location;  // short_src:line
+		uint64_t selfSamples = 0;
+		uint64_t totalSamples = 0;
+		uint64_t allocBytes = 0;
+		uint64_t allocCount = 0;
+	};
+
+	lua_State *m_L = nullptr;
+	bool m_isRunning = false;
+	bool m_isInHook = false;
+	int m_period = 0;
+	uint64_t m_sampleCount = 0;
+	uint64_t m_startTime = 0;
+	uint64_t m_stopTime = 0;
+	uint64_t m_allocatedBytes = 0;
+
+	std::unordered_map<FunctionKey, FunctionStats, FunctionKeyHash> m_functions;
+	std::unordered_map<std::string, uint64_t> m_stacks;  // collapsed stack -> samples
+
+	// reused by each sample
+	std::vector<FunctionKey> m_sampleKeys;
+	std::string m_sampleStack;
+
+	static void HookWrapper(lua_State *L, lua_Debug *ar);
+
+	void OnSample(lua_State *L);
+	FunctionStats & GetFunction(lua_Debug & ar, FunctionKey & key);
+
+public:
+	static constexpr int DEFAULT_PERIOD = 1000;  // Lua VM instructions between samples
+	static constexpr int MAX_STACK_DEPTH = 64;
+
+	ScriptProfiler();
+	~ScriptProfiler();
+
+	void Start(lua_State *L, int period = DEFAULT_PERIOD);
+	void Stop();
+	void Clear();
+
+	bool IsRunning() const
+	{
+		return m_isRunning;
+	}
+
+	// Lua allocation observer, L is the allocating thread or coroutine
+	// must be cheap when not running
+	static void AllocObserver(void *ud, lua_State *L, size_t oldSize, size_t newSize)
+	{
+		static_cast<ScriptProfiler*>(ud)->OnAlloc(L, oldSize, newSize);
+	}
+
+	void OnAlloc(lua_State *L, size_t oldSize, size_t newSize)
+	{
+		if (newSize > oldSize)
+		{
+			m_allocatedBytes += newSize - oldSize;
+
+			if (m_isRunning)
+			{
+				OnAllocSlow(L, newSize - oldSize);
+			}
+		}
+	}
+
+	// total number of bytes ever allocated by Lua, even when not running
+	uint64_t GetAllocatedBytes() const
+	{
+		return m_allocatedBytes;
+	}
+
+	void OnAllocSlow(lua_State *L, size_t bytes);
+
+	void LogReport(unsigned int maxCount);
+	bool ExportCollapsedStacks(const char *fileName);
+};
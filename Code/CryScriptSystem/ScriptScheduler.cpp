@@ -0,0 +1,326 @@
+#include "CryCommon/CrySystem/ISystem.h"
+
+#include "ScriptScheduler.h"
+#include "ScriptSystem.h"
+#include "FunctionHandler.h"
+
+extern "C"
+{
+#include "Library/External/Lua/src/lstate.h"
+
+	void DumpCallStack(lua_State* L);  // ScriptSystem.cpp
+}
+
+long ScriptScheduler::GetFreeWaitSlot()
+{
+	for (size_t i = 0; i < m_waits.size(); i++)
+	{
+		if (!m_waits[i].exists)
+		{
+			return i;
+		}
+	}
+
+	if (m_waits.size() >= 0xFFFF)  // wait index is uint16_t
+	{
+		// all wait slots are used
+		return -1;
+	}
+
+	m_waits.resize(m_waits.size() + 1);
+
+	return m_waits.size() - 1;
+}
+
+ScriptWaitID ScriptScheduler::CreateWait(IFunctionHandler *pH, int resultCount, bool collectResults)
+{
+	lua_State *L = GetLuaState(pH);
+
+	if (lua_pushthread(L))
+	{
+		lua_pop(L, 1);
+		CryLogWarning("[ScriptScheduler] %s must be called from a coroutine", pH->GetFuncName());
+		return 0;
+	}
+
+	// the same check as in lua_yield, but before any async work is started
+	if (L->nCcalls > L->baseCcalls)
+	{
+		lua_pop(L, 1);
+		CryLogWarning("[ScriptScheduler] %s cannot yield across pcall or metamethod", pH->GetFuncName());
+		return 0;
+	}
+
+	const long index = GetFreeWaitSlot();
+	if (index < 0)
+	{
+		lua_pop(L, 1);
+		CryLogWarning("[ScriptScheduler] Too many waiting coroutines");
+		return 0;
+	}
+
+	Wait & wait = m_waits[index];
+
+	wait.exists = true;
+	wait.serialNumber++;
+
+	// make sure the serial number is never zero
+	if (wait.serialNumber == 0)
+		wait.serialNumber++;
+
+	wait.pending = resultCount;
+	wait.pThread = L;
+	wait.threadRef = lua_ref(L, 1);  // keep the coroutine alive while it waits
+
+	if (collectResults)
+	{
+		lua_createtable(L, resultCount, 0);
+		wait.resultsRef = lua_ref(L, 1);
+	}
+
+	return (index << 16) | wait.serialNumber;
+}
+
+ScriptScheduler::Wait *ScriptScheduler::GetWait(ScriptWaitID waitID)
+{
+	const uint16_t index = waitID >> 16;
+	const uint16_t serialNumber = waitID & 0xFFFF;
+
+	if (index < m_waits.size())
+	{
+		Wait & wait = m_waits[index];
+
+		if (wait.exists && wait.serialNumber == serialNumber)
+		{
+			return &wait;
+		}
+	}
+
+	return nullptr;
+}
+
+void ScriptScheduler::ResetWait(Wait & wait)
+{
+	lua_State *L = m_pSS->GetLuaState();
+
+	wait.exists = false;
+	wait.pending = 0;
+	wait.pThread = nullptr;
+
+	if (wait.threadRef)
+	{
+		lua_unref(L, wait.threadRef);
+		wait.threadRef = 0;
+	}
+
+	if (wait.resultsRef)
+	{
+		lua_unref(L, wait.resultsRef);
+		wait.resultsRef = 0;
+	}
+}
+
+bool ScriptScheduler::IsThreadWaiting(lua_State *pThread)
+{
+	for (const Wait & wait : m_waits)
+	{
+		if (wait.exists && wait.pThread == pThread)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ScriptScheduler::Resume(lua_State *pThread, int argCount)
+{
+	const int status = lua_resume(pThread, argCount);
+
+	if (status == LUA_YIELD)
+	{
+		if (!IsThreadWaiting(pThread))
+		{
+			CryLogWarning("[ScriptScheduler] Coroutine yielded outside of a native wait and will not be resumed");
+		}
+	}
+	else if (status != 0)
+	{
+		const char *error = lua_tostring(pThread, -1);
+
+		CryLogWarning("[Lua Error] %s", error ? error : "(error object is not a string)");
+
+		// the stack of a dead coroutine is kept intact
+		DumpCallStack(pThread);
+	}
+}
+
+lua_State *ScriptScheduler::GetLuaState(IFunctionHandler *pH)
+{
+	// the function handler knows the coroutine the native function is called from
+	return static_cast<FunctionHandler*>(pH)->GetLuaState();
+}
+
+ScriptScheduler::ScriptScheduler(CScriptSystem *pSS)
+{
+	m_pSS = pSS;
+}
+
+ScriptScheduler::~ScriptScheduler()
+{
+	Reset();
+}
+
+int ScriptScheduler::Spawn(IFunctionHandler *pH)
+{
+	lua_State *L = GetLuaState(pH);
+
+	const int paramCount = pH->GetParamCount();
+	const int first = lua_gettop(L) - paramCount + 1;
+
+	if (paramCount < 1 || !lua_isfunction(L, first))
+	{
+		CryLogWarning("[ScriptScheduler] %s expects a function", pH->GetFuncName());
+		return pH->EndFunction(false);
+	}
+
+	lua_State *pThread = lua_newthread(L);
+	const int threadRef = lua_ref(L, 1);
+
+	// function and its parameters
+	for (int i = 0; i < paramCount; i++)
+	{
+		lua_pushvalue(L, first + i);
+	}
+
+	lua_xmove(L, pThread, paramCount);
+
+	Resume(pThread, paramCount - 1);
+
+	// waits keep their own reference to the coroutine
+	lua_unref(L, threadRef);
+
+	return pH->EndFunction(true);
+}
+
+ScriptWaitID ScriptScheduler::Suspend(IFunctionHandler *pH)
+{
+	return CreateWait(pH, 1, false);
+}
+
+ScriptWaitID ScriptScheduler::SuspendAll(IFunctionHandler *pH, int resultCount)
+{
+	return CreateWait(pH, resultCount, true);
+}
+
+int ScriptScheduler::YieldCoroutine(IFunctionHandler *pH)
+{
+	return lua_yield(GetLuaState(pH), 0);
+}
+
+void ScriptScheduler::Complete(ScriptWaitID waitID, int resultIndex, const ValuePusher & pushValues)
+{
+	Wait *pWait = GetWait(waitID);
+	if (!pWait)
+	{
+		// cancelled
+		return;
+	}
+
+	lua_State *L = m_pSS->GetLuaState();
+
+	if (pWait->resultsRef)
+	{
+		const int top = lua_gettop(L);
+		const int valueCount = pushValues(L);
+
+		// move the values into a new table
+		lua_createtable(L, valueCount, 0);
+		lua_insert(L, top + 1);
+
+		for (int i = valueCount; i > 0; i--)
+		{
+			lua_rawseti(L, top + 1, i);
+		}
+
+		lua_getref(L, pWait->resultsRef);
+		lua_insert(L, -2);
+		lua_rawseti(L, -2, resultIndex + 1);
+		lua_pop(L, 1);
+	}
+
+	pWait->pending--;
+
+	if (pWait->pending > 0)
+	{
+		return;
+	}
+
+	lua_State *pThread = pWait->pThread;
+
+	if (lua_status(pThread) != LUA_YIELD)
+	{
+		CryLogWarning("[ScriptScheduler] Cannot resume coroutine 0x%08x that is not suspended", waitID);
+		ResetWait(*pWait);
+		return;
+	}
+
+	int argCount = 0;
+
+	if (pWait->resultsRef)
+	{
+		lua_getref(L, pWait->resultsRef);
+		argCount = 1;
+	}
+	else
+	{
+		argCount = pushValues(L);
+	}
+
+	lua_xmove(L, pThread, argCount);
+
+	// keep the coroutine alive until it yields again or finishes
+	const int threadRef = pWait->threadRef;
+	pWait->threadRef = 0;
+
+	ResetWait(*pWait);
+
+	Resume(pThread, argCount);
+
+	lua_unref(L, threadRef);
+}
+
+void ScriptScheduler::Complete(ScriptWaitID waitID, int resultIndex, const ScriptAnyValue *values, int valueCount)
+{
+	Complete(waitID, resultIndex, [this, values, valueCount](lua_State *L) -> int
+	{
+		for (int i = 0; i < valueCount; i++)
+		{
+			m_pSS->PushAny(values[i]);
+		}
+
+		return valueCount;
+	});
+}
+
+void ScriptScheduler::Cancel(ScriptWaitID waitID)
+{
+	Wait *pWait = GetWait(waitID);
+	if (pWait)
+	{
+		ResetWait(*pWait);
+	}
+}
+
+void ScriptScheduler::Reset()
+{
+	for (Wait & wait : m_waits)
+	{
+		if (wait.exists)
+		{
+			ResetWait(wait);
+		}
+	}
+
+	m_waits.clear();
+}
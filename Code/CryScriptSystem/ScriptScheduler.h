@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+extern "C"
+{
+#include "Library/External/Lua/src/lua.h"
+}
+
+#include "CryCommon/CryScriptSystem/IScriptSystem.h"
+
+class CScriptSystem;
+
+using ScriptWaitID = uint32_t;
+
+// Resumes Lua coroutines suspended inside native functions once their work is done.
+//
+// A native function called from a coroutine does:
+//
+//   ScriptWaitID waitID = pScheduler->Suspend(pH);
+//   if (!waitID)
+//     return pH->EndFunction(...);  // not called from a coroutine
+//   ... start async work that later calls pScheduler->Complete(waitID, ...) on the main thread ...
+//   return pScheduler->YieldCoroutine(pH);
+//
+// The values passed to Complete become the return values of the native function.
+class ScriptScheduler
+{
+	struct Wait
+	{
+		bool exists = false;
+		uint16_t serialNumber = 0;
+		int pending = 0;
+		int threadRef = 0;
+		int resultsRef = 0;  // table of results if waiting for multiple completions
+		lua_State *pThread = nullptr;
+	};
+
+	CScriptSystem *m_pSS = nullptr;
+	std::vector<Wait> m_waits;
+
+	long GetFreeWaitSlot();
+	ScriptWaitID CreateWait(IFunctionHandler *pH, int resultCount, bool collectResults);
+	Wait *GetWait(ScriptWaitID waitID);
+	void ResetWait(Wait & wait);
+	bool IsThreadWaiting(lua_State *pThread);
+	void Resume(lua_State *pThread, int argCount);
+
+	static lua_State *GetLuaState(IFunctionHandler *pH);
+
+public:
+	ScriptScheduler(CScriptSystem *pSS);
+	~ScriptScheduler();
+
+	// Script.Async(function, ...)
+	int Spawn(IFunctionHandler *pH);
+
+	ScriptWaitID Suspend(IFunctionHandler *pH);
+	// The coroutine is resumed with a table of all results once Complete has been called for each result index.
+	ScriptWaitID SuspendAll(IFunctionHandler *pH, int resultCount);
+	int YieldCoroutine(IFunctionHandler *pH);
+
+	// pushes result values to the stack and returns their count
+	using ValuePusher = std::function<int(lua_State*)>;
+
+	// main thread
+	void Complete(ScriptWaitID waitID, int resultIndex, const ValuePusher & pushValues);
+	void Complete(ScriptWaitID waitID, int resultIndex, const ScriptAnyValue *values, int valueCount);
+	void Cancel(ScriptWaitID waitID);
+
+	void Reset();
+};
@@ -21,6 +21,7 @@ extern "C"
 
 #include "ScriptSystem.h"
 #include "ScriptTable.h"
+#include "LuaLibs/bufferlib.h"
 
 // Fine tune this value for optimal performance/memory
 #define PER_FRAME_LUA_GC_STEP        2
@@ -57,6 +58,108 @@ namespace
 	{
 		g_self->ForceGarbageCollection();
 	}
+
+#ifdef _DEBUG
+	// returns all its parameters
+	int LuaTestEcho(IFunctionHandler* pH, void* pBuffer, int nSize)
+	{
+		ScriptAnyValue any1, any2, any3;
+		pH->GetParamAny(1, any1);
+		pH->GetParamAny(2, any2);
+		pH->GetParamAny(3, any3);
+
+		return pH->EndFunctionAny(any1, any2, any3);
+	}
+
+	// Calls a native function returning Any from the main thread and from coroutines.
+	// The native function must read its parameters from and push its results to the stack of the caller.
+	void LuaTestCoroutinesCmd(IConsoleCmdArgs* pArgs)
+	{
+		lua_State* L = g_self->GetLuaState();
+		const int top = lua_gettop(L);
+
+		SmartScriptTable test(g_self);
+
+		IScriptTable::SUserFunctionDesc fd;
+		fd.sGlobalName = "LuaTest";
+		fd.sFunctionName = "Echo";
+		fd.sFunctionParams = "any1, any2, any3";
+		fd.pUserDataFunc = LuaTestEcho;
+		test->AddFunction(fd);
+
+		g_self->SetGlobalValue("LuaTest", test);
+
+		const char* code =
+			"local function Check(a, b, c)\n"
+			"  return a == 1 and b == 'two' and type(c) == 'table' and c.three == 3\n"
+			"end\n"
+			"local args = { 1, 'two', { three = 3 } }\n"
+			"LuaTest.main = Check(LuaTest.Echo(unpack(args)))\n"
+			"local co = coroutine.create(function(...)\n"
+			"  local a, b, c = LuaTest.Echo(...)\n"
+			"  local x, y, z = coroutine.yield(Check(a, b, c))\n"
+			"  return Check(LuaTest.Echo(x, y, z))\n"
+			"end)\n"
+			"local ok1, res1 = coroutine.resume(co, unpack(args))\n"
+			"local ok2, res2 = coroutine.resume(co, unpack(args))\n"
+			"LuaTest.coroutine = ok1 and res1 and ok2 and res2\n"
+			"Script.Async(function(...)\n"
+			"  LuaTest.async = Check(LuaTest.Echo(...))\n"
+			"end, unpack(args))\n";
+
+		g_self->ExecuteBuffer(code, strlen(code), "LuaTestCoroutines");
+
+		bool isMainOk = false;
+		bool isCoroutineOk = false;
+		bool isAsyncOk = false;
+		test->GetValue("main", isMainOk);
+		test->GetValue("coroutine", isCoroutineOk);
+		test->GetValue("async", isAsyncOk);
+
+		g_self->SetGlobalToNull("LuaTest");
+
+		const bool isStackOk = (lua_gettop(L) == top);
+
+		CryLogAlways("[LuaTest] main thread: %s", isMainOk ? "OK" : "FAILED");
+		CryLogAlways("[LuaTest] coroutine: %s", isCoroutineOk ? "OK" : "FAILED");
+		CryLogAlways("[LuaTest] Script.Async: %s", isAsyncOk ? "OK" : "FAILED");
+		CryLogAlways("[LuaTest] main stack: %s", isStackOk ? "OK" : "FAILED");
+	}
+#endif
+
+	void LuaProfilerCmd(IConsoleCmdArgs* pArgs)
+	{
+		ScriptProfiler* pProfiler = g_self->GetScriptProfiler();
+
+		const char* action = (pArgs->GetArgCount() > 1) ? pArgs->GetArg(1) : "";
+
+		if (_stricmp(action, "start") == 0)
+		{
+			const int period = (pArgs->GetArgCount() > 2) ? atoi(pArgs->GetArg(2)) : ScriptProfiler::DEFAULT_PERIOD;
+			pProfiler->Start(g_self->GetLuaState(), period);
+		}
+		else if (_stricmp(action, "stop") == 0)
+		{
+			pProfiler->Stop();
+		}
+		else if (_stricmp(action, "clear") == 0)
+		{
+			pProfiler->Clear();
+		}
+		else if (_stricmp(action, "report") == 0)
+		{
+			const int count = (pArgs->GetArgCount() > 2) ? atoi(pArgs->GetArg(2)) : 30;
+			pProfiler->LogReport((count > 0) ? count : 30);
+		}
+		else if (_stricmp(action, "export") == 0)
+		{
+			pProfiler->ExportCollapsedStacks((pArgs->GetArgCount() > 2) ? pArgs->GetArg(2) : "%USER%/LuaProfile.txt");
+		}
+		else
+		{
+			CryLogAlways("Usage: lua_profiler start [PERIOD] | stop | clear | report [COUNT] | export [FILE]");
+		}
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -526,6 +629,7 @@ CScriptSystem::CScriptSystem()
 	, m_lastGCTime(0.0f)
 	, m_nLastGCCount(0)
 	, m_pScriptTimerMgr(nullptr)
+	, m_pScriptScheduler(nullptr)
 {
 	g_self = this;
 }
@@ -536,10 +640,14 @@ CScriptSystem::~CScriptSystem()
 {
 	m_pSystem->GetISystemEventDispatcher()->RemoveListener(this);
 
+	// timers can hold waiting coroutines
 	delete m_pScriptTimerMgr;
+	delete m_pScriptScheduler;
 
 	if (L)
 	{
+		m_scriptProfiler.Stop();
+
 		lua_close(L);
 
 		L = NULL;
@@ -553,12 +661,14 @@ bool CScriptSystem::Init(ISystem* pSystem, bool bStdLibs, int nStackSize)
 
 	m_pSystem = pSystem;
 	m_pScriptTimerMgr = new ScriptTimerManager(this);
+	m_pScriptScheduler = new ScriptScheduler(this);
 
 	m_pSystem->GetISystemEventDispatcher()->RegisterListener(this);
 
 	//L = lua_open();
 	L = lua_newstate(custom_lua_alloc, NULL);
 	lua_atpanic(L, &cutsom_lua_panic);
+	lua_setallocobserver(L, &ScriptProfiler::AllocObserver, &m_scriptProfiler);
 
 	//lua_storedebuginfo(L, 0);
 
@@ -568,6 +678,7 @@ bool CScriptSystem::Init(ISystem* pSystem, bool bStdLibs, int nStackSize)
 	}
 
 	lua_bitlib_init(L);
+	lua_bufferlib_init(L);
 	//lua_vectorlib_init(L);
 
 	// For LuaJIT
@@ -593,6 +704,15 @@ bool CScriptSystem::Init(ISystem* pSystem, bool bStdLibs, int nStackSize)
 
 	pConsole->AddCommand("lua_dump_state", LuaDumpState, 0, "Dumps the current state of the lua memory (defined symbols and values) into the file LuaState.txt");
 	pConsole->AddCommand("lua_garbagecollect", LuaGarbargeCollect, 0, "Forces a garbage collection of the lua state");
+	pConsole->AddCommand("lua_profiler", LuaProfilerCmd, 0,
+		"Sampling profiler of Lua functions with per-function allocation tracking\n"
+		"Usage: lua_profiler start [PERIOD] | stop | clear | report [COUNT] | export [FILE]\n"
+		"PERIOD is the number of Lua instructions between samples\n"
+		"export writes collapsed stacks for flame graph tools");
+#ifdef _DEBUG
+	pConsole->AddCommand("lua_test_coroutines", LuaTestCoroutinesCmd, 0,
+		"Checks that native functions called from coroutines use the stack of the coroutine");
+#endif
 
 	pConsole->RegisterInt("lua_debugger", 0, VF_CHEAT, "Enables the script debugger.\n1 to trigger on breakpoints and errors\n2 to only trigger on errors\nUsage: lua_debugger [0/1/2]\n");
 	pConsole->RegisterInt("lua_StopOnError", 0, VF_CHEAT, "Stops on error");
@@ -1327,6 +1447,41 @@ bool CScriptSystem::ToAny(ScriptAnyValue& var, int index)
 	return false;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void CScriptSystem::PushAny(lua_State* pState, const ScriptAnyValue& var)
+{
+	// table references belong to the main thread, so the value is pushed there and moved
+	PushAny(var);
+
+	if (pState != L)
+	{
+		lua_xmove(L, pState, 1);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool CScriptSystem::ToAny(lua_State* pState, ScriptAnyValue& var, int index)
+{
+	if (pState == L)
+	{
+		return ToAny(var, index);
+	}
+
+	if (lua_type(pState, index) == LUA_TNONE)
+	{
+		return false;
+	}
+
+	// table references are attached in the main thread, so a copy of the value is converted there
+	// strings stay valid because the original value stays on the stack of the coroutine
+	lua_pushvalue(pState, index);
+	lua_xmove(pState, L, 1);
+	const bool res = ToAny(var, -1);
+	lua_pop(L, 1);
+
+	return res;
+}
+
 //////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////
 bool CScriptSystem::PopAny(ScriptAnyValue& var)
@@ -1407,6 +1562,15 @@ void CScriptSystem::PushFuncParamAny(const ScriptAnyValue& any)
 	m_nTempArg++;
 }
 
+//////////////////////////////////////////////////////////////////////
+void CScriptSystem::PushFuncParamBuffer(std::shared_ptr<const std::string> data)
+{
+	if (m_nTempArg == -1)
+		return;
+	lua_pushbuffer(L, std::move(data));
+	m_nTempArg++;
+}
+
 //////////////////////////////////////////////////////////////////////////
 void CScriptSystem::SetGlobalAny(const char* sKey, const ScriptAnyValue& any)
 {
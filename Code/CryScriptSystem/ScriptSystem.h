@@ -3,6 +3,7 @@
 #pragma once
 
 #include <string.h>
+#include <memory>
 #include <string>
 #include <set>
 
@@ -18,6 +19,8 @@ extern "C"
 
 #include "ScriptBindings/ScriptBindings.h"
 #include "ScriptTimerManager.h"
+#include "ScriptProfiler.h"
+#include "ScriptScheduler.h"
 
 struct SLuaStackEntry
 {
@@ -130,10 +133,16 @@ public:
 	virtual void*         Allocate(size_t sz);
 	virtual size_t        Deallocate(void* ptr);
 
+	// Push function param as a buffer sharing the string instead of copying it into a Lua string.
+	void                  PushFuncParamBuffer(std::shared_ptr<const std::string> data);
+
 	void                  PushAny(const ScriptAnyValue& var);
 	bool                  PopAny(ScriptAnyValue& var);
 	// Convert top stack item to Any.
 	bool                  ToAny(ScriptAnyValue& var, int index);
+	// Same as above on the stack of the given thread, which can be a coroutine.
+	void                  PushAny(lua_State* pState, const ScriptAnyValue& var);
+	bool                  ToAny(lua_State* pState, ScriptAnyValue& var, int index);
 	void                  PushVec3(const Vec3& vec);
 	bool                  ToVec3(Vec3& vec, int index);
 	// Push table reference
@@ -147,6 +156,8 @@ public:
 	void                  LogStackTrace();
 
 	ScriptTimerManager *GetScriptTimerManager() { return m_pScriptTimerMgr; };
+	ScriptProfiler *GetScriptProfiler() { return &m_scriptProfiler; };
+	ScriptScheduler *GetScriptScheduler() { return m_pScriptScheduler; };
 
 	void                  GetCallStack(std::vector<SLuaStackEntry>& callstack);
 	bool                  IsCallStackEmpty(void);
@@ -217,4 +228,6 @@ private: // --------------------------------------------------------------------
 	int                   m_nLastGCCount; //!<
 
 	ScriptTimerManager*      m_pScriptTimerMgr;
+	ScriptScheduler*         m_pScriptScheduler;
+	ScriptProfiler           m_scriptProfiler;
 };
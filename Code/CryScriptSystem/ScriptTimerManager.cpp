@@ -3,6 +3,7 @@
 #include "CryCommon/CryEntitySystem/IEntitySystem.h"
 
 #include "ScriptTimerManager.h"
+#include "ScriptSystem.h"
 
 long ScriptTimerManager::GetFreeTimerSlot()
 {
@@ -31,7 +32,7 @@ uint64_t ScriptTimerManager::GetCurrentTime()
 }
 
 ScriptTimerID ScriptTimerManager::CreateTimer(uint64_t milliseconds, HSCRIPTFUNCTION pFunction,
-                                              const char *functionName, IScriptTable *pData)
+                                              const char *functionName, IScriptTable *pData, ScriptWaitID waitID)
 {
 	const long index = GetFreeTimerSlot();
 	if (index < 0)
@@ -59,6 +60,7 @@ ScriptTimerID ScriptTimerManager::CreateTimer(uint64_t milliseconds, HSCRIPTFUNC
 		timer.functionName.clear();
 
 	timer.pData = pData;
+	timer.waitID = waitID;
 
 	if (pData)
 		pData->AddRef();
@@ -76,6 +78,19 @@ void ScriptTimerManager::TriggerTimer(ScriptTimerID timerID)
 
 	HSCRIPTFUNCTION pFunction = m_timers[index].pFunction;
 	IScriptTable *pData = m_timers[index].pData;
+	const ScriptWaitID waitID = m_timers[index].waitID;
+
+	if (waitID)
+	{
+		m_timers[index].exists = false;
+		m_timers[index].waitID = 0;
+
+		// Script.Sleep returns true
+		const ScriptAnyValue result = true;
+		static_cast<CScriptSystem*>(m_pScriptSystem)->GetScriptScheduler()->Complete(waitID, 0, &result, 1);
+
+		return;
+	}
 
 	if (!pFunction)
 	{
@@ -107,6 +122,12 @@ void ScriptTimerManager::ResetTimer(Timer & timer)
 {
 	timer.exists = false;
 
+	if (timer.waitID)
+	{
+		static_cast<CScriptSystem*>(m_pScriptSystem)->GetScriptScheduler()->Cancel(timer.waitID);
+		timer.waitID = 0;
+	}
+
 	if (timer.pFunction)
 	{
 		m_pScriptSystem->ReleaseFunc(timer.pFunction);
@@ -251,7 +272,7 @@ void ScriptTimerManager::Serialize(TSerialize & ser)
 		{
 			const Timer & timer = m_timers[index];
 
-			if (!timer.exists || timer.pFunction)  // do not save timers that have script handle callback
+			if (!timer.exists || timer.pFunction || timer.waitID)  // do not save timers that have script handle callback or coroutine
 				continue;
 
 			uint32 dataEntityID = 0;
@@ -7,6 +7,8 @@
 #include "CryCommon/CryScriptSystem/IScriptSystem.h"
 #include "CryCommon/CryNetwork/ISerialize.h"
 
+#include "ScriptScheduler.h"
+
 using ScriptTimerID = uint32_t;
 
 class ScriptTimerManager
@@ -20,6 +22,7 @@ class ScriptTimerManager
 		HSCRIPTFUNCTION pFunction = nullptr;
 		IScriptTable *pData = nullptr;
 		std::string functionName;  // alternative to pFunction
+		ScriptWaitID waitID = 0;   // alternative to pFunction, resumes a coroutine in Script.Sleep
 	};
 
 	IScriptSystem *m_pScriptSystem = nullptr;
@@ -28,7 +31,7 @@ class ScriptTimerManager
 	long GetFreeTimerSlot();
 	uint64_t GetCurrentTime();
 	ScriptTimerID CreateTimer(uint64_t milliseconds, HSCRIPTFUNCTION pFunction,
-	                          const char *functionName, IScriptTable *pData);
+	                          const char *functionName, IScriptTable *pData, ScriptWaitID waitID = 0);
 	void TriggerTimer(ScriptTimerID timerID);
 	void ResetTimer(Timer & timer);
 
@@ -46,6 +49,11 @@ public:
 		return CreateTimer(milliseconds, nullptr, functionName, pData);
 	}
 
+	ScriptTimerID AddWakeUpTimer(uint64_t milliseconds, ScriptWaitID waitID)
+	{
+		return CreateTimer(milliseconds, nullptr, nullptr, nullptr, waitID);
+	}
+
 	void RemoveTimer(ScriptTimerID timerID);
 
 	void Update();
@@ -1022,6 +1022,14 @@ LUA_API void lua_setallocf (lua_State *L, lua_Alloc f, void *ud) {
 }
 
 
+LUA_API void lua_setallocobserver (lua_State *L, lua_AllocObserver f, void *ud) {
+  lua_lock(L);
+  G(L)->allocobserverud = ud;
+  G(L)->fallocobserver = f;
+  lua_unlock(L);
+}
+
+
 LUA_API void *lua_newuserdata (lua_State *L, size_t size) {
   Udata *u;
   lua_lock(L);
@@ -69,6 +69,8 @@ typedef struct global_State {
   stringtable strt;  /* hash table for strings */
   lua_Alloc frealloc;  /* function to reallocate memory */
   void *ud;         /* auxiliary data to `frealloc' */
+  lua_AllocObserver fallocobserver;  /* function to observe allocations */
+  void *allocobserverud;  /* auxiliary data to `fallocobserver' */
   lu_byte currentwhite;
   lu_byte gcstate;  /* state of garbage collector */
   int sweepstrgc;  /* position of sweep in `strt' */
@@ -243,6 +243,14 @@ LUA_API void  (lua_concat) (lua_State *L, int n);
 LUA_API lua_Alloc (lua_getallocf) (lua_State *L, void **ud);
 LUA_API void lua_setallocf (lua_State *L, lua_Alloc f, void *ud);
 
+/*
+** allocation observer, called with the state that allocates
+** (the main thread or a coroutine) before each allocation
+*/
+typedef void (*lua_AllocObserver) (void *ud, lua_State *L, size_t osize, size_t nsize);
+
+LUA_API void lua_setallocobserver (lua_State *L, lua_AllocObserver f, void *ud);
+
 
 
 /* 
@@ -167,7 +167,8 @@ function InitializeClient()
 				Counter = 0,
 				OnUpdate = {},
 				OnSpawn = {}
-			}
+			},
+			SPAWN_FILTERS = {}
 		}
 	end
 
@@ -176,7 +177,9 @@ function InitializeClient()
 	local function CallHooks(name, ...)
 		for i, v in pairs(localState.HOOKS[name]) do
 			if type(v) == "function" then
-				local ok, err = pcall(v, dt)
+				_L.CPPAPI.BeginHook(name, i)
+				local ok, err = pcall(v, ...)
+				_L.CPPAPI.EndHook()
 				if not ok then
 					_L.System.LogAlways("$4 [hook] Error during "..name.." hook (id=" .. tostring(i) .. "): " .. tostring(err))
 				end
@@ -232,20 +235,55 @@ function InitializeClient()
 		localState.KEY_BINDINGS[key] = action
 	end
 
-	local function AddHook(hookType, name, fn)
+	-- only classes some OnSpawn hook asks for are passed to Lua, none without hooks
+	local function UpdateSpawnFilter()
+		local classes = {}
+		for name, filter in pairs(localState.SPAWN_FILTERS) do
+			if filter["*"] then
+				classes = { "*" }
+				break
+			end
+			for class in pairs(filter) do
+				classes[#classes + 1] = class
+			end
+		end
+		_L.CPPAPI.SetSpawnFilter(classes)
+	end
+
+	-- classes is an optional class name or list of class names for OnSpawn hooks, all classes by default
+	local function AddHook(hookType, name, fn, classes)
 		localState.HOOKS.Counter = localState.HOOKS.Counter + 1
 		if type(name) == "function" then
+			classes = fn
 			fn = name
 			name = tostring(localState.HOOKS.Counter)
 		end
 		localState.HOOKS[hookType] = localState.HOOKS[hookType] or {}
 		localState.HOOKS[hookType][name] = fn
+		if hookType == "OnSpawn" then
+			local filter = {}
+			if type(classes) == "string" then
+				filter[classes] = true
+			elseif type(classes) == "table" then
+				for _, class in ipairs(classes) do
+					filter[class] = true
+				end
+			else
+				filter["*"] = true
+			end
+			localState.SPAWN_FILTERS[name] = filter
+			UpdateSpawnFilter()
+		end
 		return name
 	end
 
 	local function RemoveHook(hookType, name)
 		localState.HOOKS[hookType] = localState.HOOKS[hookType] or {}
 		localState.HOOKS[hookType][name] = nil
+		if hookType == "OnSpawn" then
+			localState.SPAWN_FILTERS[name] = nil
+			UpdateSpawnFilter()
+		end
 	end
 
 	local function SetHTTPEndpoint(baseUri)
@@ -462,10 +500,14 @@ function InitializeClient()
 					if what.class then
 						method = ACTIVE_RPC[what.class].method
 						if method then
+							_L.CPPAPI.BeginHook("RPC", what.class, what.method)
 							_pcall(method, ACTIVE_RPC[what.class], what.params, what.id)
+							_L.CPPAPI.EndHook()
 						end
 					elseif method then
+						_L.CPPAPI.BeginHook("RPC", what.method)
 						_pcall(method, what.params, what.id)
+						_L.CPPAPI.EndHook()
 					end
 				end
 			end
@@ -499,18 +541,32 @@ function InitializeClient()
 	local function OnDisconnect(reason, message)
 		printf("Disconnect: %d %s", reason, message)
 		ResetState()
-	end
-
-	local function OnSpawn(entityId)
-		local entity = _L.System.GetEntity(entityId)
-		if entity then
-			--printf("Spawned entity %s of class %s", entity:GetName(), entity.class)
+		UpdateSpawnFilter()
+	end
+
+	-- called once per frame with all entities spawned since the last frame that passed the spawn filter
+	local function OnSpawnBatch(entityIds)
+		for _, entityId in ipairs(entityIds) do
+			local entity = _L.System.GetEntity(entityId)
+			if entity then
+				for name, fn in pairs(localState.HOOKS.OnSpawn) do
+					local filter = localState.SPAWN_FILTERS[name]
+					if type(fn) == "function" and filter and (filter["*"] or filter[entity.class]) then
+						_L.CPPAPI.BeginHook("OnSpawn", name)
+						local ok, err = pcall(fn, entity)
+						_L.CPPAPI.EndHook()
+						if not ok then
+							_L.System.LogAlways("$4 [hook] Error during OnSpawn hook (id=" .. tostring(name) .. "): " .. tostring(err))
+						end
+					end
+				end
+			end
 		end
 	end
 
 	CPPAPI.SetCallback(SCRIPT_CALLBACK_ON_UPDATE, OnUpdate)
 	CPPAPI.SetCallback(SCRIPT_CALLBACK_ON_DISCONNECT, OnDisconnect)
-	CPPAPI.SetCallback(SCRIPT_CALLBACK_ON_SPAWN, OnSpawn)
+	CPPAPI.SetCallback(SCRIPT_CALLBACK_ON_SPAWN_BATCH, OnSpawnBatch)
 
 	CPPAPI.AddCCommand("secu_login", LoginCCommandHandler)
 	CPPAPI.AddCCommand("simple_login", LoginCCommandHandler)